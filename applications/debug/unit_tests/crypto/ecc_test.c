@@ -0,0 +1,87 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <uECC.h>
+#include "../minunit.h"
+
+#define TAG "EccTest"
+
+#define ECC_TEST_ROUNDS 8
+
+// RFC 6979, A.2.5: P-256 key pair
+static const uint8_t ecc_test_private[32] = {
+    0xC9, 0xAF, 0xA9, 0xD8, 0x45, 0xBA, 0x75, 0x16, 0x6B, 0x5C, 0x21, 0x57, 0x67, 0xB1, 0xD6, 0x93,
+    0x4E, 0x50, 0xC3, 0xDB, 0x36, 0xE8, 0x9B, 0x12, 0x7B, 0x8A, 0x62, 0x2B, 0x12, 0x0F, 0x67, 0x21,
+};
+
+static const uint8_t ecc_test_public[64] = {
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C, 0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99, 0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51, 0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99,
+};
+
+static int ecc_test_random(uint8_t* dest, unsigned size) {
+    furi_hal_random_fill_buf(dest, size);
+    return 1;
+}
+
+static uint32_t ecc_test_cycles_to_us(uint32_t cycles) {
+    return cycles / ECC_TEST_ROUNDS / furi_hal_cortex_instructions_per_microsecond();
+}
+
+MU_TEST(ecc_test_public_key) {
+    uint8_t public[64];
+    mu_assert(
+        uECC_compute_public_key(ecc_test_private, public, uECC_secp256r1()),
+        "public key compute failed");
+    mu_assert_mem_eq(ecc_test_public, public, sizeof(public));
+}
+
+MU_TEST(ecc_test_sign_verify) {
+    uECC_Curve curve = uECC_secp256r1();
+    uint8_t private[32];
+    uint8_t public[64];
+    uint8_t hash[32];
+    uint8_t signature[64];
+    uint32_t cycles_public = 0;
+    uint32_t cycles_sign = 0;
+
+    for(size_t i = 0; i < ECC_TEST_ROUNDS; i++) {
+        mu_assert(uECC_make_key(public, private, curve), "key generation failed");
+        furi_hal_random_fill_buf(hash, sizeof(hash));
+
+        uint32_t start = DWT->CYCCNT;
+        mu_assert(uECC_compute_public_key(private, public, curve), "public key compute failed");
+        cycles_public += DWT->CYCCNT - start;
+
+        start = DWT->CYCCNT;
+        mu_assert(uECC_sign(private, hash, sizeof(hash), signature, curve), "sign failed");
+        cycles_sign += DWT->CYCCNT - start;
+
+        mu_assert(uECC_verify(public, hash, sizeof(hash), signature, curve), "verify failed");
+        hash[0] ^= 0x01;
+        mu_assert(
+            !uECC_verify(public, hash, sizeof(hash), signature, curve), "verify false positive");
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "public key %lu us, sign %lu us",
+        ecc_test_cycles_to_us(cycles_public),
+        ecc_test_cycles_to_us(cycles_sign));
+}
+
+MU_TEST_SUITE(ecc_test_suite) {
+    uECC_RNG_Function rng = uECC_get_rng();
+    uECC_set_rng(ecc_test_random);
+
+    MU_RUN_TEST(ecc_test_public_key);
+    MU_RUN_TEST(ecc_test_sign_verify);
+
+    uECC_set_rng(rng);
+}
+
+int run_minunit_test_ecc() {
+    MU_RUN_SUITE(ecc_test_suite);
+    return MU_EXIT_CODE;
+}
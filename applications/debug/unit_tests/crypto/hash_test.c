@@ -0,0 +1,143 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <toolbox/hash.h>
+#include <toolbox/crc32_calc.h>
+#include "../minunit.h"
+
+#define TAG "HashTest"
+
+#define HASH_TEST_DATA_SIZE 4096
+#define HASH_TEST_CHUNK_MAX 97
+
+typedef struct {
+    HashType type;
+    const char* abc;
+} HashTestVector;
+
+static const HashTestVector hash_test_vectors[] = {
+    {HashTypeMd5, "900150983cd24fb0d6963f7d28e17f72"},
+    {HashTypeSha1, "a9993e364706816aba3e25717850c26c9cd0d89d"},
+    {HashTypeSha256, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+    {HashTypeCrc32, "352441c2"},
+};
+
+MU_TEST(hash_test_vector) {
+    FuriString* digest = furi_string_alloc();
+
+    for(size_t i = 0; i < COUNT_OF(hash_test_vectors); i++) {
+        Hash* hash = hash_alloc(hash_test_vectors[i].type);
+        hash_update(hash, "abc", 3);
+        hash_finish_hex(hash, digest);
+        mu_assert_string_eq(hash_test_vectors[i].abc, furi_string_get_cstr(digest));
+
+        // Context is ready for the next digest
+        hash_update(hash, "a", 1);
+        hash_update(hash, "bc", 2);
+        hash_finish_hex(hash, digest);
+        mu_assert_string_eq(hash_test_vectors[i].abc, furi_string_get_cstr(digest));
+        hash_free(hash);
+
+        HashType type;
+        mu_assert(
+            hash_type_from_name(hash_type_get_name(hash_test_vectors[i].type), &type),
+            "hash name not found");
+        mu_assert_int_eq(hash_test_vectors[i].type, type);
+    }
+
+    furi_string_free(digest);
+}
+
+MU_TEST(hash_test_chunks) {
+    uint8_t* data = malloc(HASH_TEST_DATA_SIZE + 3);
+    furi_hal_random_fill_buf(data, HASH_TEST_DATA_SIZE + 3);
+    uint8_t expected[HASH_DIGEST_SIZE_MAX];
+    uint8_t digest[HASH_DIGEST_SIZE_MAX];
+
+    for(HashType type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        hash_update(hash, data, HASH_TEST_DATA_SIZE);
+        size_t digest_size = hash_finish(hash, expected);
+        mu_assert_int_eq(hash_type_get_digest_size(type), digest_size);
+
+        // Unaligned data in uneven chunks must give the same digest
+        for(size_t offset = 1; offset < 4; offset++) {
+            memmove(data + offset, data + offset - 1, HASH_TEST_DATA_SIZE);
+            size_t position = 0;
+            while(position < HASH_TEST_DATA_SIZE) {
+                size_t chunk = MIN(
+                    furi_hal_random_get() % HASH_TEST_CHUNK_MAX, HASH_TEST_DATA_SIZE - position);
+                hash_update(hash, data + offset + position, chunk);
+                position += chunk;
+            }
+            hash_finish(hash, digest);
+            mu_assert_mem_eq(expected, digest, digest_size);
+        }
+        memmove(data, data + 3, HASH_TEST_DATA_SIZE);
+
+        hash_free(hash);
+    }
+
+    free(data);
+}
+
+MU_TEST(hash_test_crc32_hw) {
+    uint8_t* data = malloc(HASH_TEST_DATA_SIZE);
+    furi_hal_random_fill_buf(data, HASH_TEST_DATA_SIZE);
+
+    for(size_t offset = 0; offset < 4; offset++) {
+        for(size_t size = 0; size < 16; size++) {
+            uint32_t crc = crc32_calc_buffer(0, data, offset + size);
+            mu_assert_int_eq(crc, furi_hal_crc32(0, data, offset + size));
+            mu_assert_int_eq(
+                crc, furi_hal_crc32(crc32_calc_buffer(0, data, offset), data + offset, size));
+        }
+    }
+
+    uint32_t start = DWT->CYCCNT;
+    uint32_t crc_sw = crc32_calc_buffer(0, data, HASH_TEST_DATA_SIZE);
+    uint32_t cycles_sw = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    uint32_t crc_hw = furi_hal_crc32(0, data, HASH_TEST_DATA_SIZE);
+    uint32_t cycles_hw = DWT->CYCCNT - start;
+
+    mu_assert_int_eq(crc_sw, crc_hw);
+    FURI_LOG_I(TAG, "crc32 4KiB: software %lu, hardware %lu cycles", cycles_sw, cycles_hw);
+
+    free(data);
+}
+
+MU_TEST(hash_test_speed) {
+    uint8_t* data = malloc(HASH_TEST_DATA_SIZE);
+    furi_hal_random_fill_buf(data, HASH_TEST_DATA_SIZE);
+    uint8_t digest[HASH_DIGEST_SIZE_MAX];
+
+    for(HashType type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        uint32_t start = DWT->CYCCNT;
+        hash_update(hash, data, HASH_TEST_DATA_SIZE);
+        hash_finish(hash, digest);
+        uint32_t us = (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+        hash_free(hash);
+
+        FURI_LOG_I(
+            TAG,
+            "%s: %lu KiB/s",
+            hash_type_get_name(type),
+            us ? HASH_TEST_DATA_SIZE * 1000000UL / 1024 / us : 0);
+    }
+
+    free(data);
+}
+
+MU_TEST_SUITE(hash_test_suite) {
+    MU_RUN_TEST(hash_test_vector);
+    MU_RUN_TEST(hash_test_chunks);
+    MU_RUN_TEST(hash_test_crc32_hw);
+    MU_RUN_TEST(hash_test_speed);
+}
+
+int run_minunit_test_hash() {
+    MU_RUN_SUITE(hash_test_suite);
+    return MU_EXIT_CODE;
+}
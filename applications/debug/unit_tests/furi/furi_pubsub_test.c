@@ -40,6 +40,29 @@ void test_furi_pubsub() {
     furi_pubsub_publish(test_pubsub, (void*)&notify_value_1);
     mu_assert_int_not_eq(pubsub_value, notify_value_1);
 
+    // deferred subscription case
+    FuriMessageQueue* test_queue = furi_message_queue_alloc(1, sizeof(uint32_t));
+    test_pubsub_subscription = furi_pubsub_subscribe_queue(test_pubsub, test_queue);
+    mu_assert_pointers_not_eq(test_pubsub_subscription, NULL);
+
+    /// notify deferred pubsub case, second message is dropped by full queue
+    furi_pubsub_publish(test_pubsub, (void*)&notify_value_0);
+    furi_pubsub_publish(test_pubsub, (void*)&notify_value_1);
+    uint32_t queue_value = 0;
+    mu_assert_int_eq(furi_message_queue_get(test_queue, &queue_value, 0), FuriStatusOk);
+    mu_assert_int_eq(queue_value, notify_value_0);
+    mu_assert_int_eq(furi_message_queue_get_count(test_queue), 0);
+
+    // statistics case
+    FuriPubSubStats stats;
+    furi_pubsub_get_stats(test_pubsub, &stats);
+    mu_assert_int_eq(stats.subscribers, 1);
+    mu_assert_int_eq(stats.published, 4);
+    mu_assert_int_eq(stats.dropped, 1);
+
+    furi_pubsub_unsubscribe(test_pubsub, test_pubsub_subscription);
+    furi_message_queue_free(test_queue);
+
     // delete pubsub case
     furi_pubsub_free(test_pubsub);
 }
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+
+#define TAG "FuriStdoutTest"
+
+#define STDOUT_TEST_LINES 256
+#define STDOUT_TEST_BIG_SIZE 300
+
+typedef struct {
+    FuriString* output;
+    size_t writes;
+    size_t bytes;
+} StdoutTestCapture;
+
+// Stdout callback has no context
+static StdoutTestCapture stdout_test_capture;
+
+static void stdout_test_capture_callback(const char* data, size_t size) {
+    stdout_test_capture.writes++;
+    stdout_test_capture.bytes += size;
+    if(stdout_test_capture.output) {
+        for(size_t i = 0; i < size; i++) {
+            furi_string_push_back(stdout_test_capture.output, data[i]);
+        }
+    }
+}
+
+static int32_t stdout_test_output_thread(void* context) {
+    FuriString* expected = context;
+    furi_thread_set_stdout_callback(stdout_test_capture_callback);
+
+    // Incomplete line stays in buffer until flush
+    printf("prompt> ");
+    furi_string_cat_str(expected, "prompt> ");
+    if(stdout_test_capture.writes != 0) return -1;
+    fflush(stdout);
+    if(stdout_test_capture.writes != 1) return -1;
+
+    for(size_t i = 0; i < STDOUT_TEST_LINES; i++) {
+        printf("%4u %-16s %08lX\r\n", i, "storage", (uint32_t)i * 0x1234567UL);
+        furi_string_cat_printf(expected, "%4u %-16s %08lX\r\n", i, "storage", i * 0x1234567UL);
+    }
+    if(stdout_test_capture.writes != 1 + STDOUT_TEST_LINES) return -1;
+
+    // Long output goes around buffer
+    char big[STDOUT_TEST_BIG_SIZE + 1];
+    memset(big, 'x', STDOUT_TEST_BIG_SIZE);
+    big[STDOUT_TEST_BIG_SIZE] = '\0';
+    puts(big);
+    furi_string_cat_printf(expected, "%s\n", big);
+
+    putchar('!');
+    furi_string_push_back(expected, '!');
+    // Exiting thread flushes stdout
+    return 0;
+}
+
+static int32_t stdout_test_benchmark_thread(void* context) {
+    uint32_t* cycles = context;
+    furi_thread_set_stdout_callback(stdout_test_capture_callback);
+
+    uint32_t start = DWT->CYCCNT;
+    for(size_t i = 0; i < STDOUT_TEST_LINES; i++) {
+        printf("%4u %-16s %08lX %s\r\n", i, "storage", (uint32_t)i, "benchmark line");
+    }
+    *cycles = DWT->CYCCNT - start;
+
+    return 0;
+}
+
+static FuriThread* stdout_test_thread_alloc(FuriThreadCallback callback, void* context) {
+    return furi_thread_alloc_ex("StdoutTest", 2048, callback, context);
+}
+
+static void test_furi_stdout_output() {
+    FuriString* expected = furi_string_alloc();
+    memset(&stdout_test_capture, 0, sizeof(stdout_test_capture));
+    stdout_test_capture.output = furi_string_alloc();
+
+    FuriThread* thread = stdout_test_thread_alloc(stdout_test_output_thread, expected);
+    furi_thread_start(thread);
+    furi_thread_join(thread);
+    mu_assert_int_eq(0, furi_thread_get_return_code(thread));
+    furi_thread_free(thread);
+
+    mu_assert_string_eq(
+        furi_string_get_cstr(expected), furi_string_get_cstr(stdout_test_capture.output));
+
+    furi_string_free(stdout_test_capture.output);
+    furi_string_free(expected);
+}
+
+static void test_furi_stdout_benchmark() {
+    uint32_t cycles = 0;
+    memset(&stdout_test_capture, 0, sizeof(stdout_test_capture));
+
+    FuriThread* thread = stdout_test_thread_alloc(stdout_test_benchmark_thread, &cycles);
+    furi_thread_start(thread);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+
+    // One console write per line
+    mu_assert_int_eq(STDOUT_TEST_LINES, stdout_test_capture.writes);
+
+    uint32_t us = cycles / furi_hal_cortex_instructions_per_microsecond();
+    FURI_LOG_I(
+        TAG,
+        "printf: %u bytes in %lu us, %lu KiB/s",
+        stdout_test_capture.bytes,
+        us,
+        us ? (uint32_t)((uint64_t)stdout_test_capture.bytes * 1000000 / 1024 / us) : 0);
+}
+
+void test_furi_stdout() {
+    test_furi_stdout_output();
+    test_furi_stdout_benchmark();
+}
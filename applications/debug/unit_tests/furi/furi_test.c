@@ -8,6 +8,7 @@ void test_furi_create_open();
 void test_furi_valuemutex();
 void test_furi_concurrent_access();
 void test_furi_pubsub();
+void test_furi_stdout();
 
 void test_furi_memmgr();
 
@@ -38,12 +39,32 @@ MU_TEST(mu_test_furi_pubsub) {
     test_furi_pubsub();
 }
 
+MU_TEST(mu_test_furi_stdout) {
+    test_furi_stdout();
+}
+
 MU_TEST(mu_test_furi_memmgr) {
     // this test is not accurate, but gives a basic understanding
     // that memory management is working fine
     test_furi_memmgr();
 }
 
+MU_TEST(mu_test_furi_run_time) {
+    FuriThreadId idle_id = furi_thread_get_idle_id();
+    mu_check(idle_id != NULL);
+
+    uint64_t start = furi_kernel_get_run_time();
+    uint64_t idle_start = furi_thread_get_run_time(idle_id);
+    furi_delay_ms(100);
+    uint64_t elapsed = furi_kernel_get_run_time() - start;
+    uint64_t idle_elapsed = furi_thread_get_run_time(idle_id) - idle_start;
+
+    // Delay is aliased to ticks and includes sleep
+    mu_assert(elapsed >= 99000 && elapsed <= 102000, "run time doesn't match delay");
+    mu_assert(idle_elapsed > 0, "idle thread wasn't accounted");
+    mu_assert(idle_elapsed <= elapsed, "idle thread time exceeds elapsed");
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -53,7 +74,9 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_create_open);
     MU_RUN_TEST(mu_test_furi_valuemutex);
     MU_RUN_TEST(mu_test_furi_pubsub);
+    MU_RUN_TEST(mu_test_furi_stdout);
     MU_RUN_TEST(mu_test_furi_memmgr);
+    MU_RUN_TEST(mu_test_furi_run_time);
 }
 
 int run_minunit_test_furi() {
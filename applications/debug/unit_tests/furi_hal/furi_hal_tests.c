@@ -6,6 +6,15 @@
 
 #define DATA_SIZE 4
 
+#define SAMPLER_TEST_FREQUENCY 1000
+#define SAMPLER_TEST_DURATION_MS 100
+
+typedef struct {
+    FuriThreadId thread;
+    uint32_t total;
+    uint32_t own;
+} SamplerTestContext;
+
 static void furi_hal_i2c_int_setup() {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_power);
 }
@@ -110,7 +119,35 @@ MU_TEST_SUITE(furi_hal_i2c_int_suite) {
     MU_RUN_TEST(furi_hal_i2c_int_1b_fail);
 }
 
+static void furi_hal_sampler_test_callback(uint32_t pc, void* context) {
+    SamplerTestContext* test = context;
+    test->total++;
+    if(pc && furi_thread_get_current_id() == test->thread) {
+        test->own++;
+    }
+}
+
+MU_TEST(furi_hal_sampler_busy_thread) {
+    SamplerTestContext test = {.thread = furi_thread_get_current_id()};
+
+    furi_hal_sampler_start(SAMPLER_TEST_FREQUENCY, furi_hal_sampler_test_callback, &test);
+    mu_assert(furi_hal_sampler_is_running(), "sampler is not running");
+    // Busy loop, so almost every sample hits this thread
+    furi_hal_cortex_delay_us(SAMPLER_TEST_DURATION_MS * 1000);
+    furi_hal_sampler_stop();
+    mu_assert(!furi_hal_sampler_is_running(), "sampler is running");
+
+    uint32_t expected = SAMPLER_TEST_FREQUENCY * SAMPLER_TEST_DURATION_MS / 1000;
+    mu_assert(test.total >= expected - 2 && test.total <= expected + 2, "wrong sample count");
+    mu_assert(test.own >= test.total * 9 / 10, "samples are not attributed to busy thread");
+}
+
+MU_TEST_SUITE(furi_hal_sampler_suite) {
+    MU_RUN_TEST(furi_hal_sampler_busy_thread);
+}
+
 int run_minunit_test_furi_hal() {
     MU_RUN_SUITE(furi_hal_i2c_int_suite);
+    MU_RUN_SUITE(furi_hal_sampler_suite);
     return MU_EXIT_CODE;
 }
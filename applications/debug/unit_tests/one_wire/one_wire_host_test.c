@@ -0,0 +1,281 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <one_wire/one_wire_host.h>
+#include <one_wire/one_wire_host_timing.h>
+#include <one_wire/maxim_crc.h>
+#include "../minunit.h"
+
+#define TAG "OneWireHostTest"
+
+#define ONE_WIRE_SIM_DEVICES_MAX 32
+#define ONE_WIRE_SIM_ROM_SIZE 8
+
+// Device side timing, middle of the ranges from the 1-Wire spec
+#define ONE_WIRE_SIM_DEVICE_SAMPLE 30
+#define ONE_WIRE_SIM_DEVICE_HOLD 30
+#define ONE_WIRE_SIM_PRESENCE_WAIT 30
+#define ONE_WIRE_SIM_PRESENCE_LENGTH 120
+
+// Host side limits from the 1-Wire spec, standard speed, us
+#define ONE_WIRE_SIM_SLOT_MIN 60
+#define ONE_WIRE_SIM_SLOT_MAX 120
+#define ONE_WIRE_SIM_RECOVERY_MIN 1
+#define ONE_WIRE_SIM_WRITE_1_MAX 15
+#define ONE_WIRE_SIM_WRITE_0_MIN 60
+#define ONE_WIRE_SIM_READ_SAMPLE_MAX 15
+#define ONE_WIRE_SIM_RESET_MIN 480
+#define ONE_WIRE_SIM_RESET_HIGH_MIN 480
+#define ONE_WIRE_SIM_PRESENCE_SAMPLE_MIN 60
+#define ONE_WIRE_SIM_PRESENCE_SAMPLE_MAX 75
+
+typedef enum {
+    OneWireSimStateIdle,
+    OneWireSimStateCommand,
+    OneWireSimStateSearch,
+    OneWireSimStateReadRom,
+} OneWireSimState;
+
+typedef struct {
+    uint8_t rom[ONE_WIRE_SIM_DEVICES_MAX][ONE_WIRE_SIM_ROM_SIZE];
+    size_t device_count;
+    bool active[ONE_WIRE_SIM_DEVICES_MAX];
+
+    OneWireSimState state;
+    uint8_t command;
+    size_t bit_index;
+    uint8_t search_phase;
+
+    // Statistics
+    size_t transfers;
+    size_t slots;
+    size_t violations;
+    // Smallest distance to a spec limit over all slots, us
+    int32_t margin_min;
+} OneWireSim;
+
+static bool one_wire_sim_rom_bit(const uint8_t* rom, size_t index) {
+    return rom[index / 8] & (1 << (index % 8));
+}
+
+static void one_wire_sim_check(OneWireSim* sim, int32_t value, int32_t min, int32_t max) {
+    int32_t margin = MIN(value - min, max - value);
+    if(margin < 0) {
+        sim->violations++;
+    }
+    sim->margin_min = MIN(sim->margin_min, margin);
+}
+
+static void one_wire_sim_check_timing(OneWireSim* sim, uint16_t pulse, uint16_t period) {
+    one_wire_sim_check(sim, period, ONE_WIRE_SIM_SLOT_MIN, ONE_WIRE_SIM_SLOT_MAX);
+    one_wire_sim_check(sim, period - pulse, ONE_WIRE_SIM_RECOVERY_MIN, INT16_MAX);
+    if(pulse < ONE_WIRE_SIM_DEVICE_SAMPLE) {
+        one_wire_sim_check(sim, pulse, 1, ONE_WIRE_SIM_WRITE_1_MAX);
+    } else {
+        one_wire_sim_check(sim, pulse, ONE_WIRE_SIM_WRITE_0_MIN, ONE_WIRE_SIM_SLOT_MAX);
+    }
+}
+
+/* Wired AND of all devices that pull the line low in this slot */
+static bool one_wire_sim_device_slot(OneWireSim* sim, bool host_bit, bool* device_bit) {
+    bool driving = false;
+    *device_bit = true;
+
+    switch(sim->state) {
+    case OneWireSimStateCommand:
+        sim->command |= host_bit << sim->bit_index;
+        if(++sim->bit_index == 8) {
+            sim->bit_index = 0;
+            if(sim->command == 0xF0) {
+                sim->state = OneWireSimStateSearch;
+                sim->search_phase = 0;
+            } else if(sim->command == 0x33) {
+                sim->state = OneWireSimStateReadRom;
+            } else {
+                sim->state = OneWireSimStateIdle;
+            }
+        }
+        break;
+    case OneWireSimStateSearch:
+        if(sim->search_phase < 2) {
+            driving = true;
+            for(size_t i = 0; i < sim->device_count; i++) {
+                if(!sim->active[i]) continue;
+                bool bit = one_wire_sim_rom_bit(sim->rom[i], sim->bit_index);
+                *device_bit &= sim->search_phase ? !bit : bit;
+            }
+            sim->search_phase++;
+        } else {
+            for(size_t i = 0; i < sim->device_count; i++) {
+                if(one_wire_sim_rom_bit(sim->rom[i], sim->bit_index) != host_bit) {
+                    sim->active[i] = false;
+                }
+            }
+            sim->search_phase = 0;
+            if(++sim->bit_index == ONE_WIRE_SIM_ROM_SIZE * 8) {
+                sim->state = OneWireSimStateIdle;
+            }
+        }
+        break;
+    case OneWireSimStateReadRom:
+        driving = true;
+        *device_bit = one_wire_sim_rom_bit(sim->rom[0], sim->bit_index);
+        if(++sim->bit_index == ONE_WIRE_SIM_ROM_SIZE * 8) {
+            sim->state = OneWireSimStateIdle;
+        }
+        break;
+    case OneWireSimStateIdle:
+        break;
+    }
+
+    return driving;
+}
+
+static bool one_wire_sim_reset(OneWireSim* sim, uint16_t pulse, uint16_t period, uint16_t sample) {
+    one_wire_sim_check(sim, pulse, ONE_WIRE_SIM_RESET_MIN, INT16_MAX);
+    one_wire_sim_check(sim, period - pulse, ONE_WIRE_SIM_RESET_HIGH_MIN, INT16_MAX);
+    one_wire_sim_check(
+        sim,
+        sample - pulse,
+        ONE_WIRE_SIM_PRESENCE_SAMPLE_MIN,
+        ONE_WIRE_SIM_PRESENCE_SAMPLE_MAX);
+
+    sim->state = OneWireSimStateCommand;
+    sim->command = 0;
+    sim->bit_index = 0;
+    for(size_t i = 0; i < sim->device_count; i++) {
+        sim->active[i] = true;
+    }
+
+    int32_t presence = sample - pulse - ONE_WIRE_SIM_PRESENCE_WAIT;
+    bool presence_low = presence >= 0 && presence < ONE_WIRE_SIM_PRESENCE_LENGTH;
+    return !(sim->device_count && presence_low);
+}
+
+static void one_wire_sim_transfer(
+    const uint16_t* pulse,
+    bool* level,
+    size_t count,
+    uint16_t period,
+    uint16_t sample,
+    void* context) {
+    OneWireSim* sim = context;
+    furi_check(count > 0 && count <= FURI_HAL_IBUTTON_SLOTS_MAX);
+    furi_check(sample < period);
+
+    sim->transfers++;
+    for(size_t i = 0; i < count; i++) {
+        sim->slots++;
+        if(pulse[i] >= ONE_WIRE_SIM_RESET_MIN / 2) {
+            level[i] = one_wire_sim_reset(sim, pulse[i], period, sample);
+            continue;
+        }
+
+        one_wire_sim_check_timing(sim, pulse[i], period);
+
+        bool device_bit;
+        bool host_bit = pulse[i] < ONE_WIRE_SIM_DEVICE_SAMPLE;
+        bool driving = one_wire_sim_device_slot(sim, host_bit, &device_bit);
+        if(driving) {
+            one_wire_sim_check(sim, sample, pulse[i] + 1, ONE_WIRE_SIM_READ_SAMPLE_MAX);
+        }
+
+        bool host_low = pulse[i] > sample;
+        bool device_low = driving && !device_bit && sample < ONE_WIRE_SIM_DEVICE_HOLD;
+        level[i] = !(host_low || device_low);
+    }
+}
+
+static OneWireSim* one_wire_sim_alloc(size_t device_count) {
+    OneWireSim* sim = malloc(sizeof(OneWireSim));
+    sim->device_count = device_count;
+    sim->margin_min = INT32_MAX;
+
+    for(size_t i = 0; i < device_count; i++) {
+        // Few families and shared prefixes to get deep discrepancies
+        sim->rom[i][0] = (i % 3) ? 0x01 : 0x28;
+        for(size_t j = 1; j < ONE_WIRE_SIM_ROM_SIZE - 1; j++) {
+            sim->rom[i][j] = (j < 4) ? (i & 0x3) : (uint8_t)rand();
+        }
+        sim->rom[i][ONE_WIRE_SIM_ROM_SIZE - 1] =
+            maxim_crc8(sim->rom[i], ONE_WIRE_SIM_ROM_SIZE - 1, MAXIM_CRC8_INIT);
+    }
+
+    return sim;
+}
+
+static void one_wire_sim_report(OneWireSim* sim) {
+    FURI_LOG_I(
+        TAG,
+        "%zu transfers, %zu slots, %zu timing violations, min margin %ld us",
+        sim->transfers,
+        sim->slots,
+        sim->violations,
+        sim->margin_min);
+}
+
+MU_TEST(one_wire_host_search_test) {
+    OneWireSim* sim = one_wire_sim_alloc(ONE_WIRE_SIM_DEVICES_MAX);
+    OneWireHost* host = onewire_host_alloc();
+    onewire_host_set_transfer_callback(host, one_wire_sim_transfer, sim);
+
+    bool found[ONE_WIRE_SIM_DEVICES_MAX] = {0};
+    size_t found_count = 0;
+    uint8_t rom[ONE_WIRE_SIM_ROM_SIZE];
+
+    onewire_host_reset_search(host);
+    while(onewire_host_search(host, rom, NORMAL_SEARCH)) {
+        mu_assert(found_count < ONE_WIRE_SIM_DEVICES_MAX, "search doesn't stop");
+        mu_assert_int_eq(0, maxim_crc8(rom, ONE_WIRE_SIM_ROM_SIZE, MAXIM_CRC8_INIT));
+
+        size_t index = 0;
+        while(index < sim->device_count && memcmp(sim->rom[index], rom, sizeof(rom))) {
+            index++;
+        }
+        mu_assert(index < sim->device_count, "unknown rom found");
+        mu_assert(!found[index], "rom found twice");
+        found[index] = true;
+        found_count++;
+    }
+    mu_assert_int_eq(ONE_WIRE_SIM_DEVICES_MAX, found_count);
+
+    // Reset, command and 64 batched triplets with the trailing direction bit
+    mu_assert_int_eq(found_count * (1 + 1 + 64 + 1), sim->transfers);
+
+    one_wire_sim_report(sim);
+    mu_assert_int_eq(0, sim->violations);
+
+    onewire_host_free(host);
+    free(sim);
+}
+
+MU_TEST(one_wire_host_read_rom_test) {
+    OneWireSim* sim = one_wire_sim_alloc(1);
+    OneWireHost* host = onewire_host_alloc();
+    onewire_host_set_transfer_callback(host, one_wire_sim_transfer, sim);
+
+    uint8_t rom[ONE_WIRE_SIM_ROM_SIZE];
+    mu_assert(onewire_host_reset(host), "no presence");
+    onewire_host_write(host, 0x33);
+    onewire_host_read_bytes(host, rom, sizeof(rom));
+    mu_assert_mem_eq(sim->rom[0], rom, sizeof(rom));
+
+    one_wire_sim_report(sim);
+    mu_assert_int_eq(0, sim->violations);
+
+    // Empty bus
+    sim->device_count = 0;
+    mu_assert(!onewire_host_reset(host), "presence on empty bus");
+
+    onewire_host_free(host);
+    free(sim);
+}
+
+MU_TEST_SUITE(one_wire_host_suite) {
+    MU_RUN_TEST(one_wire_host_search_test);
+    MU_RUN_TEST(one_wire_host_read_rom_test);
+}
+
+int run_minunit_test_one_wire() {
+    MU_RUN_SUITE(one_wire_host_suite);
+    return MU_EXIT_CODE;
+}
@@ -3,6 +3,13 @@
 #include <m-dict.h>
 #include <toolbox/dir_walk.h>
 
+#define TAG "DirWalkTest"
+
+// Wide flat tree, where rewind by rescan on step out is quadratic.
+// Timings are only logged, tree is kept small to not slow down the suite.
+#define DIRWALK_BENCH_DIRS 64
+#define DIRWALK_BENCH_FILES 2
+
 static const char* const storage_test_dirwalk_paths[] = {
     "1",
     "11",
@@ -14,6 +21,9 @@ static const char* const storage_test_dirwalk_paths[] = {
     "111/2",
     "111/22",
     "111/22/33",
+    "111/22/33/44",
+    "111/22/33/44/55",
+    "111/22/33/44/55/66",
 };
 
 static const char* const storage_test_dirwalk_files[] = {
@@ -25,6 +35,8 @@ static const char* const storage_test_dirwalk_files[] = {
     "111/22/33/file2.test",
     "111/22/33/file3.ext_test",
     "111/22/33/file4.ext_test",
+    "111/22/33/44/55/file1.test",
+    "111/22/33/44/55/66/file1.test",
 };
 
 typedef struct {
@@ -43,6 +55,9 @@ const StorageTestPathDesc storage_test_dirwalk_full[] = {
     {.path = "111/2", .is_dir = true},
     {.path = "111/22", .is_dir = true},
     {.path = "111/22/33", .is_dir = true},
+    {.path = "111/22/33/44", .is_dir = true},
+    {.path = "111/22/33/44/55", .is_dir = true},
+    {.path = "111/22/33/44/55/66", .is_dir = true},
     {.path = "file1.test", .is_dir = false},
     {.path = "file2.test", .is_dir = false},
     {.path = "file3.ext_test", .is_dir = false},
@@ -51,6 +66,8 @@ const StorageTestPathDesc storage_test_dirwalk_full[] = {
     {.path = "111/22/33/file2.test", .is_dir = false},
     {.path = "111/22/33/file3.ext_test", .is_dir = false},
     {.path = "111/22/33/file4.ext_test", .is_dir = false},
+    {.path = "111/22/33/44/55/file1.test", .is_dir = false},
+    {.path = "111/22/33/44/55/66/file1.test", .is_dir = false},
 };
 
 const StorageTestPathDesc storage_test_dirwalk_no_recursive[] = {
@@ -68,6 +85,8 @@ const StorageTestPathDesc storage_test_dirwalk_filter[] = {
     {.path = "1/file1.test", .is_dir = false},
     {.path = "111/22/33/file1.test", .is_dir = false},
     {.path = "111/22/33/file2.test", .is_dir = false},
+    {.path = "111/22/33/44/55/file1.test", .is_dir = false},
+    {.path = "111/22/33/44/55/66/file1.test", .is_dir = false},
 };
 
 typedef struct {
@@ -254,6 +273,104 @@ MU_TEST_1(test_dirwalk_filter, Storage* storage) {
     storage_test_paths_free(paths);
 }
 
+static void dirwalk_bench_create(Storage* storage, const char* base) {
+    FuriString* path = furi_string_alloc();
+
+    storage_common_mkdir(storage, base);
+    for(size_t i = 0; i < DIRWALK_BENCH_DIRS; i++) {
+        furi_string_printf(path, "%s/d%02u", base, i);
+        storage_common_mkdir(storage, furi_string_get_cstr(path));
+        for(size_t j = 0; j < DIRWALK_BENCH_FILES; j++) {
+            furi_string_printf(path, "%s/d%02u/f%u", base, i, j);
+            write_file_13DA(storage, furi_string_get_cstr(path));
+        }
+    }
+
+    furi_string_free(path);
+}
+
+/* Reference walker with previous behavior: parent is closed on step in,
+ * then reopened and rescanned up to saved position on step out */
+static size_t dirwalk_bench_rescan(Storage* storage, const char* base, size_t* reads) {
+    File* file = storage_file_alloc(storage);
+    FuriString* path = furi_string_alloc_set(base);
+    char* name = malloc(256);
+    FileInfo info;
+    uint32_t index_stack[4];
+    size_t depth = 0;
+    uint32_t index = 0;
+    size_t entries = 0;
+
+    storage_dir_open(file, base);
+    while(true) {
+        (*reads)++;
+        if(storage_dir_read(file, &info, name, 255)) {
+            index++;
+            entries++;
+            if(info.flags & FSF_DIRECTORY) {
+                furi_check(depth < COUNT_OF(index_stack));
+                index_stack[depth++] = index;
+                index = 0;
+                storage_dir_close(file);
+                furi_string_cat_printf(path, "/%s", name);
+                storage_dir_open(file, furi_string_get_cstr(path));
+            }
+        } else if(depth > 0) {
+            uint32_t saved_index = index_stack[--depth];
+            storage_dir_close(file);
+            furi_string_left(path, furi_string_search_rchar(path, '/'));
+            storage_dir_open(file, furi_string_get_cstr(path));
+            for(index = 0; index < saved_index; index++) {
+                (*reads)++;
+                if(!storage_dir_read(file, &info, name, 255)) break;
+            }
+        } else {
+            break;
+        }
+    }
+
+    storage_dir_close(file);
+    storage_file_free(file);
+    furi_string_free(path);
+    free(name);
+
+    return entries;
+}
+
+MU_TEST_1(test_dirwalk_benchmark, Storage* storage) {
+    const char* base = EXT_PATH("dirwalk_bench");
+    dirwalk_bench_create(storage, base);
+
+    size_t rescan_reads = 0;
+    uint32_t start = furi_get_tick();
+    size_t rescan_entries = dirwalk_bench_rescan(storage, base, &rescan_reads);
+    uint32_t rescan_ticks = furi_get_tick() - start;
+
+    size_t entries = 0;
+    DirWalk* dir_walk = dir_walk_alloc(storage);
+    start = furi_get_tick();
+    mu_check(dir_walk_open(dir_walk, base));
+    while(dir_walk_read(dir_walk, NULL, NULL) == DirWalkOK) {
+        entries++;
+    }
+    uint32_t ticks = furi_get_tick() - start;
+    dir_walk_free(dir_walk);
+
+    storage_simply_remove_recursive(storage, base);
+
+    uint32_t tick_freq = furi_kernel_get_tick_frequency();
+    FURI_LOG_I(
+        TAG,
+        "%u entries: rescan %u reads %lu ms, dir_walk %lu ms",
+        entries,
+        rescan_reads,
+        rescan_ticks * 1000 / tick_freq,
+        ticks * 1000 / tick_freq);
+
+    mu_assert_int_eq(DIRWALK_BENCH_DIRS * (1 + DIRWALK_BENCH_FILES), entries);
+    mu_assert_int_eq(rescan_entries, entries);
+}
+
 MU_TEST_SUITE(test_dirwalk_suite) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_dirs_create(storage, EXT_PATH("dirwalk"));
@@ -261,6 +378,7 @@ MU_TEST_SUITE(test_dirwalk_suite) {
     MU_RUN_TEST_1(test_dirwalk_full, storage);
     MU_RUN_TEST_1(test_dirwalk_no_recursive, storage);
     MU_RUN_TEST_1(test_dirwalk_filter, storage);
+    MU_RUN_TEST_1(test_dirwalk_benchmark, storage);
 
     storage_simply_remove_recursive(storage, EXT_PATH("dirwalk"));
     furi_record_close(RECORD_STORAGE);
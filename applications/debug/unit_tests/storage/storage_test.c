@@ -1,6 +1,8 @@
 #include "../minunit.h"
 #include <furi.h>
 #include <storage/storage.h>
+#include <toolbox/tar/tar_archive.h>
+#include <lib/heatshrink/heatshrink_encoder.h>
 
 #define STORAGE_LOCKED_FILE EXT_PATH("locked_file.test")
 #define STORAGE_LOCKED_DIR STORAGE_INT_PATH_PREFIX
@@ -303,9 +305,106 @@ MU_TEST_SUITE(storage_rename) {
     furi_record_close(RECORD_STORAGE);
 }
 
+#define STORAGE_TAR_WINDOW_SZ2 8
+#define STORAGE_TAR_LOOKAHEAD_SZ2 4
+
+static bool storage_tar_pack(Storage* storage, const char* src, const char* archive_path) {
+    TarArchive* archive = tar_archive_alloc(storage);
+    bool result = tar_archive_open(archive, archive_path, TAR_OPEN_MODE_WRITE) &&
+                  tar_archive_add_dir(archive, src, "") && tar_archive_finalize(archive);
+    tar_archive_free(archive);
+    return result;
+}
+
+static bool storage_tar_unpack(Storage* storage, const char* archive_path, const char* dst) {
+    TarArchive* archive = tar_archive_alloc(storage);
+    storage_common_mkdir(storage, dst);
+    bool result = tar_archive_open(archive, archive_path, TAR_OPEN_MODE_READ) &&
+                  tar_archive_unpack_to(archive, dst, NULL);
+    tar_archive_free(archive);
+    return result;
+}
+
+static void storage_tar_compress_poll(heatshrink_encoder* encoder, File* file) {
+    uint8_t out[64];
+    size_t polled;
+    HSE_poll_res res;
+    do {
+        res = heatshrink_encoder_poll(encoder, out, sizeof(out), &polled);
+        storage_file_write(file, out, polled);
+    } while(res == HSER_POLL_MORE);
+}
+
+static bool storage_tar_compress(Storage* storage, const char* src_path, const char* dst_path) {
+    File* src = storage_file_alloc(storage);
+    File* dst = storage_file_alloc(storage);
+    uint8_t* window = malloc(2 << STORAGE_TAR_WINDOW_SZ2);
+    heatshrink_encoder* encoder =
+        heatshrink_encoder_alloc(window, STORAGE_TAR_WINDOW_SZ2, STORAGE_TAR_LOOKAHEAD_SZ2);
+    uint8_t in[128];
+    bool result = false;
+
+    if(storage_file_open(src, src_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_open(dst, dst_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        const uint8_t header[] = {
+            'H', 'S', 'D', 'S', 1, STORAGE_TAR_WINDOW_SZ2, STORAGE_TAR_LOOKAHEAD_SZ2, 0};
+        storage_file_write(dst, header, sizeof(header));
+
+        uint16_t read;
+        while((read = storage_file_read(src, in, sizeof(in)))) {
+            size_t offset = 0;
+            while(offset < read) {
+                size_t sunk;
+                heatshrink_encoder_sink(encoder, in + offset, read - offset, &sunk);
+                offset += sunk;
+                storage_tar_compress_poll(encoder, dst);
+            }
+        }
+        while(heatshrink_encoder_finish(encoder) == HSER_FINISH_MORE) {
+            storage_tar_compress_poll(encoder, dst);
+        }
+        result = true;
+    }
+
+    heatshrink_encoder_free(encoder);
+    free(window);
+    storage_file_free(dst);
+    storage_file_free(src);
+    return result;
+}
+
+MU_TEST(storage_tar_roundtrip) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    storage_dir_create(storage, EXT_PATH("tar.src"));
+    mu_check(storage_tar_pack(storage, EXT_PATH("tar.src"), EXT_PATH("test.tar")));
+
+    mu_check(storage_tar_unpack(storage, EXT_PATH("test.tar"), EXT_PATH("tar.dst")));
+    mu_check(storage_dir_rename_check(storage, EXT_PATH("tar.dst")));
+    storage_dir_remove(storage, EXT_PATH("tar.dst"));
+
+    mu_check(storage_tar_compress(storage, EXT_PATH("test.tar"), EXT_PATH("test.ths")));
+    mu_check(storage_tar_unpack(storage, EXT_PATH("test.ths"), EXT_PATH("tar.dst")));
+    mu_check(storage_dir_rename_check(storage, EXT_PATH("tar.dst")));
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST_SUITE(storage_tar) {
+    MU_RUN_TEST(storage_tar_roundtrip);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_dir_remove(storage, EXT_PATH("tar.src"));
+    storage_dir_remove(storage, EXT_PATH("tar.dst"));
+    storage_simply_remove(storage, EXT_PATH("test.tar"));
+    storage_simply_remove(storage, EXT_PATH("test.ths"));
+    furi_record_close(RECORD_STORAGE);
+}
+
 int run_minunit_test_storage() {
     MU_RUN_SUITE(storage_file);
     MU_RUN_SUITE(storage_dir);
     MU_RUN_SUITE(storage_rename);
+    MU_RUN_SUITE(storage_tar);
     return MU_EXIT_CODE;
 }
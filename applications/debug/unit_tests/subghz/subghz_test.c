@@ -5,6 +5,7 @@
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_keystore.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_hopper.h>
 #include <lib/subghz/protocols/protocol_items.h>
 #include <flipper_format/flipper_format_i.h>
 
@@ -14,6 +15,7 @@
 #define NICE_FLOR_S_DIR_NAME EXT_PATH("subghz/assets/nice_flor_s")
 #define TEST_RANDOM_DIR_NAME EXT_PATH("unit_tests/subghz/test_random_raw.sub")
 #define TEST_RANDOM_COUNT_PARSE 273
+#define TEST_HOPPER_SETTING_NAME EXT_PATH("unit_tests/subghz/hopper_setting.txt")
 #define TEST_TIMEOUT 10000
 
 static SubGhzEnvironment* environment_handler;
@@ -743,6 +745,133 @@ MU_TEST(subghz_encoder_holtek_ht12x_test) {
         "Test encoder " SUBGHZ_PROTOCOL_HOLTEK_HT12X_NAME " error\r\n");
 }
 
+// 315 and 433.92 MHz have weight 4, priority 868.35 MHz has weight 12
+#define TEST_HOPPER_CHANNELS 3
+#define TEST_HOPPER_PERIOD 20
+#define TEST_HOPPER_RSSI_HIT (-50.0f)
+#define TEST_HOPPER_RSSI_QUIET (-120.0f)
+
+static SubGhzSetting* subghz_hopper_test_setting;
+static SubGhzHopper* subghz_hopper_test_instance;
+
+static void subghz_hopper_test_setup(void) {
+    subghz_hopper_test_setting = subghz_setting_alloc();
+    subghz_setting_load(subghz_hopper_test_setting, TEST_HOPPER_SETTING_NAME);
+    subghz_hopper_test_instance = subghz_hopper_alloc(subghz_hopper_test_setting);
+}
+
+static void subghz_hopper_test_teardown(void) {
+    subghz_hopper_free(subghz_hopper_test_instance);
+    subghz_setting_free(subghz_hopper_test_setting);
+}
+
+static SubGhzHopperChannelStats subghz_hopper_test_channel(size_t idx) {
+    SubGhzHopperChannelStats stats;
+    furi_check(subghz_hopper_get_channel_stats(subghz_hopper_test_instance, idx, &stats));
+    return stats;
+}
+
+static void subghz_hopper_test_hop(size_t count, uint32_t visits[TEST_HOPPER_CHANNELS]) {
+    for(size_t i = 0; i < TEST_HOPPER_CHANNELS; i++) {
+        visits[i] = subghz_hopper_test_channel(i).stats.hops;
+    }
+    while(count--) {
+        subghz_hopper_next(subghz_hopper_test_instance);
+    }
+    for(size_t i = 0; i < TEST_HOPPER_CHANNELS; i++) {
+        visits[i] = subghz_hopper_test_channel(i).stats.hops - visits[i];
+    }
+}
+
+// Hop until hopper is on given channel, so RSSI is reported for it
+static bool subghz_hopper_test_goto(size_t idx) {
+    uint32_t frequency = subghz_hopper_test_channel(idx).frequency;
+    for(size_t i = 0; i < TEST_HOPPER_PERIOD * 2; i++) {
+        if(subghz_hopper_next(subghz_hopper_test_instance) == frequency) return true;
+    }
+    return false;
+}
+
+MU_TEST(subghz_hopper_weighted_round_robin_test) {
+    mu_assert_int_eq(
+        TEST_HOPPER_CHANNELS, subghz_hopper_get_channel_count(subghz_hopper_test_instance));
+    mu_assert(subghz_hopper_test_channel(2).priority, "868.35 MHz must be priority");
+
+    // Smooth weighted round robin is exact over every period of total weight
+    uint32_t visits[TEST_HOPPER_CHANNELS];
+    for(size_t period = 0; period < 5; period++) {
+        subghz_hopper_test_hop(TEST_HOPPER_PERIOD, visits);
+        mu_assert_int_eq(4, visits[0]);
+        mu_assert_int_eq(4, visits[1]);
+        mu_assert_int_eq(12, visits[2]);
+    }
+
+    // and interleaved: priority channel never takes more than 3 hops in a row
+    size_t run = 0;
+    uint32_t priority = subghz_hopper_test_channel(2).frequency;
+    for(size_t i = 0; i < TEST_HOPPER_PERIOD * 5; i++) {
+        run = (subghz_hopper_next(subghz_hopper_test_instance) == priority) ? run + 1 : 0;
+        mu_assert(run <= 3, "priority channel starves others");
+    }
+}
+
+MU_TEST(subghz_hopper_activity_test) {
+    // RSSI hits raise activity and dwell time
+    uint8_t dwell_last = 0;
+    uint8_t activity_last = 0;
+    for(size_t i = 0; i < 4; i++) {
+        mu_assert(subghz_hopper_test_goto(0), "channel 0 is not visited");
+        uint8_t dwell = subghz_hopper_rssi(subghz_hopper_test_instance, TEST_HOPPER_RSSI_HIT);
+        uint8_t activity = subghz_hopper_test_channel(0).activity;
+        mu_assert(dwell > dwell_last, "dwell must grow with activity");
+        mu_assert(activity > activity_last, "activity must grow on RSSI hit");
+        dwell_last = dwell;
+        activity_last = activity;
+    }
+    mu_assert_int_eq(0, subghz_hopper_test_channel(1).activity);
+
+    // Active channel is visited more often than silent one of same base weight,
+    // silent channels are still visited
+    uint32_t visits[TEST_HOPPER_CHANNELS];
+    subghz_hopper_test_hop(TEST_HOPPER_PERIOD * 10, visits);
+    mu_assert(visits[0] > visits[1], "active channel is not preferred");
+    mu_assert(visits[1] > 0, "silent channel starves");
+
+    // Decoded key counts more than RSSI hit
+    mu_assert(subghz_hopper_test_goto(1), "channel 1 is not visited");
+    subghz_hopper_key_received(subghz_hopper_test_instance);
+    mu_assert(
+        subghz_hopper_test_channel(1).activity > 63, "key must raise activity more than RSSI");
+
+    // Quiet visits decay activity back to base weight
+    for(size_t i = 0; i < 30; i++) {
+        mu_assert(subghz_hopper_test_goto(0), "channel 0 is not visited");
+        mu_assert_int_eq(
+            0, subghz_hopper_rssi(subghz_hopper_test_instance, TEST_HOPPER_RSSI_QUIET));
+        uint8_t activity = subghz_hopper_test_channel(0).activity;
+        mu_assert(activity <= activity_last, "activity must not grow on quiet visit");
+        activity_last = activity;
+    }
+    mu_assert(activity_last < 16, "activity must decay");
+
+    SubGhzHopperStats stats;
+    subghz_hopper_get_stats(subghz_hopper_test_instance, &stats);
+    mu_assert_int_eq(4, stats.detections);
+    mu_assert_int_eq(1, stats.keys);
+
+    // Reset clears activity and counters
+    subghz_hopper_reset(subghz_hopper_test_instance);
+    subghz_hopper_get_stats(subghz_hopper_test_instance, &stats);
+    mu_assert_int_eq(0, stats.hops);
+    mu_assert_int_eq(0, subghz_hopper_test_channel(1).activity);
+}
+
+MU_TEST_SUITE(subghz_hopper) {
+    MU_SUITE_CONFIGURE(&subghz_hopper_test_setup, &subghz_hopper_test_teardown);
+    MU_RUN_TEST(subghz_hopper_weighted_round_robin_test);
+    MU_RUN_TEST(subghz_hopper_activity_test);
+}
+
 MU_TEST(subghz_random_test) {
     mu_assert(subghz_decode_random_test(TEST_RANDOM_DIR_NAME), "Random test error\r\n");
 }
@@ -819,5 +948,6 @@ MU_TEST_SUITE(subghz) {
 
 int run_minunit_test_subghz() {
     MU_RUN_SUITE(subghz);
+    MU_RUN_SUITE(subghz_hopper);
     return MU_EXIT_CODE;
 }
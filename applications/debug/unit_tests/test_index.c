@@ -27,6 +27,9 @@ int run_minunit_test_nfc();
 int run_minunit_test_bit_lib();
 int run_minunit_test_float_tools();
 int run_minunit_test_bt();
+int run_minunit_test_ecc();
+int run_minunit_test_hash();
+int run_minunit_test_one_wire();
 
 typedef int (*UnitTestEntry)();
 
@@ -55,6 +58,9 @@ const UnitTest unit_tests[] = {
     {.name = "bit_lib", .entry = run_minunit_test_bit_lib},
     {.name = "float_tools", .entry = run_minunit_test_float_tools},
     {.name = "bt", .entry = run_minunit_test_bt},
+    {.name = "ecc", .entry = run_minunit_test_ecc},
+    {.name = "hash", .entry = run_minunit_test_hash},
+    {.name = "one_wire", .entry = run_minunit_test_one_wire},
 };
 
 void minunit_print_progress() {
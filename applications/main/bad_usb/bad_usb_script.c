@@ -10,11 +10,16 @@
 
 #define TAG "BadUSB"
 #define WORKER_TAG TAG "Worker"
-#define FILE_BUFFER_LEN 16
+#define FILE_BUFFER_LEN 128
 
 #define SCRIPT_STATE_ERROR (-1)
 #define SCRIPT_STATE_END (-2)
-#define SCRIPT_STATE_NEXT_LINE (-3)
+
+#define SCRIPT_CODE_CHUNK 2048
+#define SCRIPT_CODE_NONE SIZE_MAX
+#define SCRIPT_KEY_SHIFT 0x80
+#define SCRIPT_STRING_BATCH_MAX 6
+#define SCRIPT_LINE_INDEX_MAX 512
 
 typedef enum {
     WorkerEvtToggle = (1 << 0),
@@ -23,20 +28,70 @@ typedef enum {
     WorkerEvtDisconnect = (1 << 3),
 } WorkerEvtFlags;
 
+typedef enum {
+    DuckyOpDelay,
+    DuckyOpKey, /**< uint16_t key code with modifiers */
+    DuckyOpString, /**< key codes, bit 7 is shift modifier */
+    DuckyOpStringDelay, /**< uint32_t delay between string chars */
+    DuckyOpStringBatch, /**< uint32_t max keys per report in string */
+    DuckyOpAltChar, /**< decimal char code */
+    DuckyOpAltString, /**< printable chars */
+    DuckyOpSysrq, /**< uint16_t key code */
+    DuckyOpRepeat, /**< uint32_t repeat count of previous instruction */
+    DuckyOpError,
+} DuckyOp;
+
+typedef struct {
+    uint8_t op;
+    uint32_t line;
+    uint16_t len; /**< payload length */
+    uint32_t delay; /**< delay after instruction, DEFAULT_DELAY included */
+    uint8_t payload[];
+} __attribute__((packed)) DuckyInsn;
+
 struct BadUsbScript {
     FuriHalUsbHidConfig hid_cfg;
     BadUsbState st;
     FuriString* file_path;
-    uint32_t defdelay;
     FuriThread* thread;
     uint8_t file_buf[FILE_BUFFER_LEN + 1];
     uint8_t buf_start;
     uint8_t buf_len;
     bool file_end;
+    uint32_t file_pos;
+    uint32_t file_size;
+    uint32_t buf_offset;
+    uint32_t line_offset;
     FuriString* line;
 
-    FuriString* line_prev;
+    // Sparse line offset index, filled while script is compiled
+    uint32_t* line_index;
+    size_t index_count;
+    uint32_t index_stride;
+    bool line_nb_exact;
+
+    // Compiler state
+    uint32_t compile_line;
+    uint32_t defdelay;
+    bool prev_delay_only;
+    uint32_t prev_delay;
+
+    // Compiled instructions, refilled from file by chunks
+    uint8_t* code;
+    size_t code_size;
+    size_t code_capacity;
+    size_t code_delay;
+    bool code_done;
+    bool code_whole;
+
+    // Executor state
+    size_t code_pc;
+    size_t code_last;
     uint32_t repeat_cnt;
+    uint32_t string_delay;
+    uint32_t string_batch;
+    uint32_t chars_typed;
+    uint32_t typing_ticks;
 };
 
 typedef struct {
@@ -108,6 +163,10 @@ static const char ducky_cmd_delay[] = {"DELAY "};
 static const char ducky_cmd_string[] = {"STRING "};
 static const char ducky_cmd_defdelay_1[] = {"DEFAULT_DELAY "};
 static const char ducky_cmd_defdelay_2[] = {"DEFAULTDELAY "};
+static const char ducky_cmd_stringdelay_1[] = {"STRING_DELAY "};
+static const char ducky_cmd_stringdelay_2[] = {"STRINGDELAY "};
+static const char ducky_cmd_stringbatch_1[] = {"STRING_BATCH "};
+static const char ducky_cmd_stringbatch_2[] = {"STRINGBATCH "};
 static const char ducky_cmd_repeat[] = {"REPEAT "};
 static const char ducky_cmd_sysrq[] = {"SYSRQ "};
 
@@ -149,191 +208,361 @@ static bool ducky_is_line_end(const char chr) {
     return ((chr == ' ') || (chr == '\0') || (chr == '\r') || (chr == '\n'));
 }
 
-static void ducky_numlock_on() {
-    if((furi_hal_hid_get_led_state() & HID_KB_LED_NUM) == 0) {
-        furi_hal_hid_kb_press(HID_KEYBOARD_LOCK_NUM_LOCK);
-        furi_hal_hid_kb_release(HID_KEYBOARD_LOCK_NUM_LOCK);
+static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
+    for(size_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
+        size_t key_cmd_len = strlen(ducky_keys[i].name);
+        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
+           (ducky_is_line_end(param[key_cmd_len]))) {
+            return ducky_keys[i].keycode;
+        }
+    }
+    if((accept_chars) && (strlen(param) > 0)) {
+        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
     }
+    return 0;
 }
 
-static bool ducky_numpad_press(const char num) {
-    if((num < '0') || (num > '9')) return false;
+/***************************** Script compiler *******************************/
 
-    uint16_t key = numpad_keys[num - '0'];
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
+static DuckyInsn* ducky_code_add(BadUsbScript* bad_usb, DuckyOp op, size_t len) {
+    size_t size = sizeof(DuckyInsn) + len;
+    if(bad_usb->code_size + size > bad_usb->code_capacity) {
+        bad_usb->code_capacity = MAX(bad_usb->code_capacity * 2, bad_usb->code_size + size);
+        bad_usb->code = realloc(bad_usb->code, bad_usb->code_capacity); //-V701
+    }
 
-    return true;
+    DuckyInsn* insn = (DuckyInsn*)&bad_usb->code[bad_usb->code_size];
+    insn->op = op;
+    insn->line = bad_usb->compile_line;
+    insn->len = len;
+    insn->delay = bad_usb->defdelay;
+
+    bad_usb->code_delay = (op == DuckyOpDelay) ? bad_usb->code_size : SCRIPT_CODE_NONE;
+    bad_usb->code_size += size;
+    bad_usb->prev_delay_only = false;
+    return insn;
+}
+
+static void ducky_code_trim(BadUsbScript* bad_usb, DuckyInsn* insn, size_t len) {
+    furi_assert(len <= insn->len);
+    bad_usb->code_size -= insn->len - len;
+    insn->len = len;
 }
 
-static bool ducky_altchar(const char* charcode) {
-    uint8_t i = 0;
-    bool state = false;
+static void ducky_code_add_delay(BadUsbScript* bad_usb, uint32_t delay) {
+    // Consecutive delay-only lines are folded into single instruction
+    delay = MIN(delay, (uint32_t)INT32_MAX);
+    if(bad_usb->code_delay != SCRIPT_CODE_NONE) {
+        DuckyInsn* insn = (DuckyInsn*)&bad_usb->code[bad_usb->code_delay];
+        insn->delay = MIN((uint64_t)insn->delay + delay, (uint64_t)INT32_MAX);
+        insn->line = bad_usb->compile_line;
+    } else if(delay > 0) {
+        DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpDelay, 0);
+        insn->delay = delay;
+    }
+    bad_usb->prev_delay_only = true;
+    bad_usb->prev_delay = delay;
+}
 
-    FURI_LOG_I(WORKER_TAG, "char %s", charcode);
+static bool ducky_compile_delay(BadUsbScript* bad_usb, const char* param) {
+    uint32_t delay_val = 0;
+    if(ducky_get_number(param, &delay_val) && (delay_val > 0)) {
+        ducky_code_add_delay(bad_usb, MIN(delay_val, (uint32_t)INT32_MAX) + bad_usb->defdelay);
+        return true;
+    }
+    snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid number %s", param);
+    return false;
+}
 
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
+static bool ducky_compile_defdelay(BadUsbScript* bad_usb, const char* param) {
+    if(ducky_get_number(param, &bad_usb->defdelay)) {
+        bad_usb->defdelay = MIN(bad_usb->defdelay, (uint32_t)INT32_MAX);
+        ducky_code_add_delay(bad_usb, bad_usb->defdelay);
+        return true;
+    }
+    snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid number %s", param);
+    return false;
+}
 
-    while(!ducky_is_line_end(charcode[i])) {
-        state = ducky_numpad_press(charcode[i]);
-        if(state == false) break;
-        i++;
+static bool ducky_compile_stringdelay(BadUsbScript* bad_usb, const char* param) {
+    uint32_t string_delay = 0;
+    if(ducky_get_number(param, &string_delay)) {
+        DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpStringDelay, sizeof(uint32_t));
+        memcpy(insn->payload, &string_delay, sizeof(uint32_t));
+        return true;
     }
+    snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid number %s", param);
+    return false;
+}
 
-    furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
-    return state;
+static bool ducky_compile_stringbatch(BadUsbScript* bad_usb, const char* param) {
+    uint32_t string_batch = 0;
+    if(ducky_get_number(param, &string_batch)) {
+        string_batch = CLAMP(string_batch, (uint32_t)SCRIPT_STRING_BATCH_MAX, 1UL);
+        DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpStringBatch, sizeof(uint32_t));
+        memcpy(insn->payload, &string_batch, sizeof(uint32_t));
+        return true;
+    }
+    snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid number %s", param);
+    return false;
 }
 
-static bool ducky_altstring(const char* param) {
-    uint32_t i = 0;
-    bool state = false;
+static bool ducky_compile_string(BadUsbScript* bad_usb, const char* param) {
+    size_t len = strlen(param);
+    if(len > UINT16_MAX) {
+        snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "String is too long");
+        return false;
+    }
 
-    while(param[i] != '\0') {
-        if((param[i] < ' ') || (param[i] > '~')) {
-            i++;
-            continue; // Skip non-printable chars
+    // One byte per char: HID key code and shift flag
+    DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpString, len);
+    size_t keys = 0;
+    for(size_t i = 0; i < len; i++) {
+        uint16_t keycode = HID_ASCII_TO_KEY(param[i]);
+        if(keycode == HID_KEYBOARD_NONE) continue;
+        furi_assert((keycode & 0xFF) < SCRIPT_KEY_SHIFT);
+        insn->payload[keys++] = (keycode & 0xFF) |
+                                ((keycode & KEY_MOD_LEFT_SHIFT) ? SCRIPT_KEY_SHIFT : 0);
+    }
+    ducky_code_trim(bad_usb, insn, keys);
+    return true;
+}
+
+static bool ducky_compile_altchar(BadUsbScript* bad_usb, const char* param) {
+    size_t len = 0;
+    while(!ducky_is_line_end(param[len])) {
+        if((param[len] < '0') || (param[len] > '9') || (len >= 3)) {
+            snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid altchar %s", param);
+            return false;
         }
+        len++;
+    }
+    if(len == 0) {
+        snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid altchar %s", param);
+        return false;
+    }
 
-        char temp_str[4];
-        snprintf(temp_str, 4, "%u", param[i]);
+    DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpAltChar, len);
+    memcpy(insn->payload, param, len);
+    return true;
+}
+
+static bool ducky_compile_altstring(BadUsbScript* bad_usb, const char* param) {
+    size_t len = strlen(param);
+    if(len > UINT16_MAX) {
+        snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "String is too long");
+        return false;
+    }
 
-        state = ducky_altchar(temp_str);
-        if(state == false) break;
-        i++;
+    DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpAltString, len);
+    size_t chars = 0;
+    for(size_t i = 0; i < len; i++) {
+        if((param[i] < ' ') || (param[i] > '~')) continue; // Skip non-printable chars
+        insn->payload[chars++] = param[i];
     }
-    return state;
+    ducky_code_trim(bad_usb, insn, chars);
+    return true;
 }
 
-static bool ducky_string(const char* param) {
-    uint32_t i = 0;
-    while(param[i] != '\0') {
-        uint16_t keycode = HID_ASCII_TO_KEY(param[i]);
-        if(keycode != HID_KEYBOARD_NONE) {
-            furi_hal_hid_kb_press(keycode);
-            furi_hal_hid_kb_release(keycode);
-        }
-        i++;
+static bool ducky_compile_repeat(BadUsbScript* bad_usb, const char* param) {
+    uint32_t repeat_cnt = 0;
+    if(!ducky_get_number(param, &repeat_cnt)) {
+        snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "Invalid number %s", param);
+        return false;
+    }
+
+    if(bad_usb->prev_delay_only) {
+        // Repeated delay is just longer delay
+        uint32_t prev_delay = bad_usb->prev_delay;
+        ducky_code_add_delay(
+            bad_usb,
+            MIN((uint64_t)prev_delay * repeat_cnt + bad_usb->defdelay, (uint64_t)INT32_MAX));
+        bad_usb->prev_delay = prev_delay;
+    } else {
+        // Previous instruction is executed again at run time, no expansion here
+        DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpRepeat, sizeof(uint32_t));
+        memcpy(insn->payload, &repeat_cnt, sizeof(uint32_t));
     }
     return true;
 }
 
-static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
-    for(size_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
-        size_t key_cmd_len = strlen(ducky_keys[i].name);
-        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
-           (ducky_is_line_end(param[key_cmd_len]))) {
-            return ducky_keys[i].keycode;
-        }
+static bool ducky_compile_sysrq(BadUsbScript* bad_usb, const char* param) {
+    uint16_t key = ducky_get_keycode(param, true);
+    DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpSysrq, sizeof(uint16_t));
+    memcpy(insn->payload, &key, sizeof(uint16_t));
+    return true;
+}
+
+static bool ducky_compile_key(BadUsbScript* bad_usb, const char* line) {
+    // Special keys + modifiers
+    uint16_t key = ducky_get_keycode(line, false);
+    if(key == HID_KEYBOARD_NONE) {
+        snprintf(bad_usb->st.error, sizeof(bad_usb->st.error), "No keycode defined for %s", line);
+        return false;
     }
-    if((accept_chars) && (strlen(param) > 0)) {
-        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
+    if((key & 0xFF00) != 0) {
+        // It's a modifier key
+        line = &line[ducky_get_command_len(line) + 1];
+        key |= ducky_get_keycode(line, true);
     }
-    return 0;
+    DuckyInsn* insn = ducky_code_add(bad_usb, DuckyOpKey, sizeof(uint16_t));
+    memcpy(insn->payload, &key, sizeof(uint16_t));
+    return true;
 }
 
-static int32_t
-    ducky_parse_line(BadUsbScript* bad_usb, FuriString* line, char* error, size_t error_len) {
-    uint32_t line_len = furi_string_size(line);
+static bool ducky_compile_line(BadUsbScript* bad_usb, FuriString* line) {
     const char* line_tmp = furi_string_get_cstr(line);
-    bool state = false;
 
-    if(line_len == 0) {
-        return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
+    if(furi_string_size(line) == 0) {
+        return true; // Skip empty lines
     }
 
     FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
+    const char* param = &line_tmp[ducky_get_command_len(line_tmp) + 1];
 
-    // General commands
     if(strncmp(line_tmp, ducky_cmd_comment, strlen(ducky_cmd_comment)) == 0) {
         // REM - comment line
-        return (0);
+        ducky_code_add_delay(bad_usb, bad_usb->defdelay);
+        return true;
     } else if(strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
         // ID - executed in ducky_script_preload
-        return (0);
+        ducky_code_add_delay(bad_usb, bad_usb->defdelay);
+        return true;
     } else if(strncmp(line_tmp, ducky_cmd_delay, strlen(ducky_cmd_delay)) == 0) {
-        // DELAY
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        uint32_t delay_val = 0;
-        state = ducky_get_number(line_tmp, &delay_val);
-        if((state) && (delay_val > 0)) {
-            return (int32_t)delay_val;
-        }
-        if(error != NULL) {
-            snprintf(error, error_len, "Invalid number %s", line_tmp);
-        }
-        return SCRIPT_STATE_ERROR;
+        return ducky_compile_delay(bad_usb, param);
     } else if(
         (strncmp(line_tmp, ducky_cmd_defdelay_1, strlen(ducky_cmd_defdelay_1)) == 0) ||
         (strncmp(line_tmp, ducky_cmd_defdelay_2, strlen(ducky_cmd_defdelay_2)) == 0)) {
-        // DEFAULT_DELAY
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->defdelay);
-        if(!state && error != NULL) {
-            snprintf(error, error_len, "Invalid number %s", line_tmp);
-        }
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_defdelay(bad_usb, param);
+    } else if(
+        (strncmp(line_tmp, ducky_cmd_stringdelay_1, strlen(ducky_cmd_stringdelay_1)) == 0) ||
+        (strncmp(line_tmp, ducky_cmd_stringdelay_2, strlen(ducky_cmd_stringdelay_2)) == 0)) {
+        return ducky_compile_stringdelay(bad_usb, param);
+    } else if(
+        (strncmp(line_tmp, ducky_cmd_stringbatch_1, strlen(ducky_cmd_stringbatch_1)) == 0) ||
+        (strncmp(line_tmp, ducky_cmd_stringbatch_2, strlen(ducky_cmd_stringbatch_2)) == 0)) {
+        return ducky_compile_stringbatch(bad_usb, param);
     } else if(strncmp(line_tmp, ducky_cmd_string, strlen(ducky_cmd_string)) == 0) {
-        // STRING
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_string(line_tmp);
-        if(!state && error != NULL) {
-            snprintf(error, error_len, "Invalid string %s", line_tmp);
-        }
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_string(bad_usb, param);
     } else if(strncmp(line_tmp, ducky_cmd_altchar, strlen(ducky_cmd_altchar)) == 0) {
-        // ALTCHAR
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        ducky_numlock_on();
-        state = ducky_altchar(line_tmp);
-        if(!state && error != NULL) {
-            snprintf(error, error_len, "Invalid altchar %s", line_tmp);
-        }
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_altchar(bad_usb, param);
     } else if(
         (strncmp(line_tmp, ducky_cmd_altstr_1, strlen(ducky_cmd_altstr_1)) == 0) ||
         (strncmp(line_tmp, ducky_cmd_altstr_2, strlen(ducky_cmd_altstr_2)) == 0)) {
-        // ALTSTRING
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        ducky_numlock_on();
-        state = ducky_altstring(line_tmp);
-        if(!state && error != NULL) {
-            snprintf(error, error_len, "Invalid altstring %s", line_tmp);
-        }
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_altstring(bad_usb, param);
     } else if(strncmp(line_tmp, ducky_cmd_repeat, strlen(ducky_cmd_repeat)) == 0) {
-        // REPEAT
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->repeat_cnt);
-        if(!state && error != NULL) {
-            snprintf(error, error_len, "Invalid number %s", line_tmp);
-        }
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_repeat(bad_usb, param);
     } else if(strncmp(line_tmp, ducky_cmd_sysrq, strlen(ducky_cmd_sysrq)) == 0) {
-        // SYSRQ
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        uint16_t key = ducky_get_keycode(line_tmp, true);
-        furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release_all();
-        return (0);
+        return ducky_compile_sysrq(bad_usb, param);
     } else {
-        // Special keys + modifiers
-        uint16_t key = ducky_get_keycode(line_tmp, false);
-        if(key == HID_KEYBOARD_NONE) {
-            if(error != NULL) {
-                snprintf(error, error_len, "No keycode defined for %s", line_tmp);
-            }
-            return SCRIPT_STATE_ERROR;
+        return ducky_compile_key(bad_usb, line_tmp);
+    }
+}
+
+/***************************** Script executor *******************************/
+
+static void ducky_numlock_on() {
+    if((furi_hal_hid_get_led_state() & HID_KB_LED_NUM) == 0) {
+        furi_hal_hid_kb_press(HID_KEYBOARD_LOCK_NUM_LOCK);
+        furi_hal_hid_kb_release(HID_KEYBOARD_LOCK_NUM_LOCK);
+    }
+}
+
+static void ducky_altchar(const uint8_t* charcode, size_t len) {
+    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
+    for(size_t i = 0; i < len; i++) {
+        uint16_t key = numpad_keys[charcode[i] - '0'];
+        furi_hal_hid_kb_press(key);
+        furi_hal_hid_kb_release(key);
+    }
+    furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
+}
+
+static void ducky_altstring(const uint8_t* param, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        char temp_str[4];
+        int code_len = snprintf(temp_str, sizeof(temp_str), "%u", param[i]);
+        ducky_altchar((const uint8_t*)temp_str, code_len);
+    }
+}
+
+static void ducky_string(BadUsbScript* bad_usb, const uint8_t* keys, size_t len) {
+    // With STRING_BATCH, distinct keys with same modifiers go in single report,
+    // unless typing is slowed down. Host may reorder keys pressed in one report.
+    uint8_t batch_max = (bad_usb->string_delay > 0) ? 1 : bad_usb->string_batch;
+    uint16_t batch[SCRIPT_STRING_BATCH_MAX];
+    uint8_t batch_keys[SCRIPT_STRING_BATCH_MAX];
+
+    size_t i = 0;
+    while(i < len) {
+        uint8_t count = 0;
+        uint8_t shift = keys[i] & SCRIPT_KEY_SHIFT;
+        while((i < len) && (count < batch_max) && ((keys[i] & SCRIPT_KEY_SHIFT) == shift) &&
+              (memchr(batch_keys, keys[i], count) == NULL)) {
+            batch_keys[count] = keys[i];
+            batch[count] = (keys[i] & ~SCRIPT_KEY_SHIFT) | (shift ? KEY_MOD_LEFT_SHIFT : 0);
+            count++;
+            i++;
         }
-        if((key & 0xFF00) != 0) {
-            // It's a modifier key
-            line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-            key |= ducky_get_keycode(line_tmp, true);
+        furi_hal_hid_kb_press_multi(batch, count);
+        furi_hal_hid_kb_release_all();
+        if(bad_usb->string_delay > 0) {
+            furi_delay_ms(bad_usb->string_delay);
         }
+    }
+}
+
+static void ducky_update_typing_rate(BadUsbScript* bad_usb, size_t chars, uint32_t start) {
+    bad_usb->chars_typed += chars;
+    bad_usb->typing_ticks += furi_get_tick() - start;
+    if(bad_usb->typing_ticks > 0) {
+        bad_usb->st.chars_per_sec = (uint64_t)bad_usb->chars_typed *
+                                    furi_kernel_get_tick_frequency() / bad_usb->typing_ticks;
+    }
+}
+
+static int32_t ducky_execute_insn(BadUsbScript* bad_usb, DuckyInsn* insn) {
+    uint16_t key = 0;
+    uint32_t start = furi_get_tick();
+
+    switch(insn->op) {
+    case DuckyOpDelay:
+        break;
+    case DuckyOpKey:
+        memcpy(&key, insn->payload, sizeof(uint16_t));
         furi_hal_hid_kb_press(key);
         furi_hal_hid_kb_release(key);
-        return (0);
+        break;
+    case DuckyOpString:
+        ducky_string(bad_usb, insn->payload, insn->len);
+        ducky_update_typing_rate(bad_usb, insn->len, start);
+        break;
+    case DuckyOpStringDelay:
+        memcpy(&bad_usb->string_delay, insn->payload, sizeof(uint32_t));
+        break;
+    case DuckyOpStringBatch:
+        memcpy(&bad_usb->string_batch, insn->payload, sizeof(uint32_t));
+        break;
+    case DuckyOpAltChar:
+        ducky_numlock_on();
+        ducky_altchar(insn->payload, insn->len);
+        break;
+    case DuckyOpAltString:
+        ducky_numlock_on();
+        ducky_altstring(insn->payload, insn->len);
+        ducky_update_typing_rate(bad_usb, insn->len, start);
+        break;
+    case DuckyOpSysrq:
+        memcpy(&key, insn->payload, sizeof(uint16_t));
+        furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
+        furi_hal_hid_kb_press(key);
+        furi_hal_hid_kb_release_all();
+        break;
+    default:
+        furi_crash("Invalid BadUSB op");
     }
+
+    return insn->delay;
 }
 
 static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
@@ -361,32 +590,117 @@ static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
     return false;
 }
 
-static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
-    uint8_t ret = 0;
-    uint32_t line_len = 0;
+static void ducky_script_index_line(BadUsbScript* bad_usb, uint32_t line, uint32_t offset) {
+    // Offset of every index_stride'th line is kept, stride doubles when index is full
+    if((line - 1) % bad_usb->index_stride) return;
+    size_t idx = (line - 1) / bad_usb->index_stride;
+    if(idx < bad_usb->index_count) return; // Already indexed on previous run
+
+    if(idx >= SCRIPT_LINE_INDEX_MAX) {
+        for(size_t i = 0; i < SCRIPT_LINE_INDEX_MAX / 2; i++) {
+            bad_usb->line_index[i] = bad_usb->line_index[i * 2];
+        }
+        bad_usb->index_count = SCRIPT_LINE_INDEX_MAX / 2;
+        bad_usb->index_stride *= 2;
+        if((line - 1) % bad_usb->index_stride) return;
+        idx = (line - 1) / bad_usb->index_stride;
+    }
 
+    if(idx == bad_usb->index_count) {
+        bad_usb->line_index[bad_usb->index_count++] = offset;
+    }
+}
+
+static bool ducky_script_read_line(BadUsbScript* bad_usb, File* script_file) {
     furi_string_reset(bad_usb->line);
 
-    do {
-        ret = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-        for(uint16_t i = 0; i < ret; i++) {
-            if(bad_usb->file_buf[i] == '\n' && line_len > 0) {
-                bad_usb->st.line_nb++;
-                line_len = 0;
-            } else {
-                if(bad_usb->st.line_nb == 0) { // Save first line
-                    furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
+    while(1) {
+        if(bad_usb->buf_len == 0) {
+            bad_usb->buf_offset = bad_usb->file_pos;
+            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
+            bad_usb->file_pos += bad_usb->buf_len;
+            if(storage_file_eof(script_file)) {
+                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
+                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
+                    bad_usb->buf_len++;
+                    bad_usb->file_end = true;
                 }
-                line_len++;
             }
+
+            bad_usb->buf_start = 0;
+            if(bad_usb->buf_len == 0) return false;
         }
-        if(storage_file_eof(script_file)) {
-            if(line_len > 0) {
-                bad_usb->st.line_nb++;
-                break;
+        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
+            if(bad_usb->file_buf[i] == '\n' && furi_string_size(bad_usb->line) > 0) {
+                bad_usb->compile_line++;
+                ducky_script_index_line(bad_usb, bad_usb->compile_line, bad_usb->line_offset);
+                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
+                bad_usb->buf_start = i + 1;
+                furi_string_trim(bad_usb->line);
+                return true;
+            } else {
+                if(furi_string_size(bad_usb->line) == 0) {
+                    bad_usb->line_offset = bad_usb->buf_offset + i;
+                }
+                furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
             }
         }
-    } while(ret > 0);
+        bad_usb->buf_len = 0;
+        if(bad_usb->file_end) return false;
+    }
+}
+
+static bool ducky_script_seek_line(BadUsbScript* bad_usb, File* script_file, uint32_t line) {
+    furi_assert(line > 0);
+    if(bad_usb->index_count == 0) return false;
+
+    // Jump to nearest indexed line, then skip less than index_stride lines
+    size_t idx = MIN((line - 1) / bad_usb->index_stride, bad_usb->index_count - 1);
+    if(!storage_file_seek(script_file, bad_usb->line_index[idx], true)) return false;
+    bad_usb->file_pos = bad_usb->line_index[idx];
+    bad_usb->buf_len = 0;
+    bad_usb->file_end = false;
+    bad_usb->compile_line = idx * bad_usb->index_stride;
+
+    while(bad_usb->compile_line + 1 < line) {
+        if(!ducky_script_read_line(bad_usb, script_file)) return false;
+    }
+    return true;
+}
+
+static void ducky_script_update_line_nb(BadUsbScript* bad_usb) {
+    if(bad_usb->line_nb_exact) return;
+
+    if(bad_usb->file_end && (bad_usb->buf_len == 0)) {
+        bad_usb->st.line_nb = bad_usb->compile_line;
+        bad_usb->line_nb_exact = true;
+        return;
+    }
+
+    // Script is not indexed till the end yet, extrapolate from bytes read
+    uint32_t bytes_done = bad_usb->buf_offset + bad_usb->buf_start;
+    uint32_t line_nb = bad_usb->compile_line;
+    if(bytes_done > 0) {
+        line_nb = MAX(line_nb, (uint64_t)line_nb * bad_usb->file_size / bytes_done);
+    }
+    bad_usb->st.line_nb = MAX(line_nb, bad_usb->st.line_nb);
+}
+
+static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
+    // Only first line is read here for ID, rest is indexed while script is running
+    bad_usb->file_size = storage_file_size(script_file);
+    bad_usb->file_pos = 0;
+    bad_usb->buf_len = 0;
+    bad_usb->file_end = false;
+    bad_usb->compile_line = 0;
+    bad_usb->index_count = 0;
+    bad_usb->index_stride = 1;
+    bad_usb->line_nb_exact = false;
+
+    if(!ducky_script_read_line(bad_usb, script_file)) {
+        return false;
+    }
+    bad_usb->st.line_nb = bad_usb->compile_line;
 
     const char* line_tmp = furi_string_get_cstr(bad_usb->line);
     bool id_set = false; // Looking for ID command at first line
@@ -400,73 +714,98 @@ static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
         furi_check(furi_hal_usb_set_config(&usb_hid, NULL));
     }
 
-    storage_file_seek(script_file, 0, true);
     furi_string_reset(bad_usb->line);
 
     return true;
 }
 
-static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
-    int32_t delay_val = 0;
+static bool ducky_script_compile(BadUsbScript* bad_usb, File* script_file) {
+    // Keep last executed instruction for REPEAT, drop the rest
+    if(bad_usb->code_last != SCRIPT_CODE_NONE) {
+        DuckyInsn* last = (DuckyInsn*)&bad_usb->code[bad_usb->code_last];
+        size_t last_size = sizeof(DuckyInsn) + last->len;
+        memmove(bad_usb->code, last, last_size);
+        bad_usb->code_size = last_size;
+        bad_usb->code_last = 0;
+    } else {
+        bad_usb->code_size = 0;
+    }
+    bad_usb->code_pc = bad_usb->code_size;
+    bad_usb->code_delay = SCRIPT_CODE_NONE;
+
+    bool from_start = (bad_usb->compile_line == 0);
+    while(!bad_usb->code_done && (bad_usb->code_size < SCRIPT_CODE_CHUNK)) {
+        if(!ducky_script_read_line(bad_usb, script_file)) {
+            bad_usb->code_done = true;
+        } else if(!ducky_compile_line(bad_usb, bad_usb->line)) {
+            FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->compile_line);
+            ducky_code_add(bad_usb, DuckyOpError, 0);
+            bad_usb->code_done = true;
+        }
+    }
+    // Small scripts are compiled once and then executed from RAM on every run
+    bad_usb->code_whole = from_start && bad_usb->code_done;
+    ducky_script_update_line_nb(bad_usb);
+
+    return bad_usb->code_pc < bad_usb->code_size;
+}
 
+static void ducky_script_rewind(BadUsbScript* bad_usb, File* script_file) {
+    bad_usb->code_pc = 0;
+    bad_usb->code_last = SCRIPT_CODE_NONE;
+    bad_usb->repeat_cnt = 0;
+    bad_usb->string_delay = 0;
+    bad_usb->string_batch = 1;
+    bad_usb->chars_typed = 0;
+    bad_usb->typing_ticks = 0;
+    bad_usb->st.line_cur = 0;
+    bad_usb->st.chars_per_sec = 0;
+
+    if(!bad_usb->code_whole) {
+        if(!ducky_script_seek_line(bad_usb, script_file, 1)) {
+            storage_file_seek(script_file, 0, true);
+            bad_usb->file_pos = 0;
+            bad_usb->buf_len = 0;
+            bad_usb->file_end = false;
+            bad_usb->compile_line = 0;
+        }
+        bad_usb->defdelay = 0;
+        bad_usb->prev_delay_only = true;
+        bad_usb->prev_delay = 0;
+        bad_usb->code_done = false;
+        ducky_script_compile(bad_usb, script_file);
+    }
+}
+
+static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
     if(bad_usb->repeat_cnt > 0) {
         bad_usb->repeat_cnt--;
-        delay_val = ducky_parse_line(
-            bad_usb, bad_usb->line_prev, bad_usb->st.error, sizeof(bad_usb->st.error));
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val < 0) { // Script error
-            bad_usb->st.error_line = bad_usb->st.line_cur - 1;
-            FURI_LOG_E(WORKER_TAG, "Unknown command at line %u", bad_usb->st.line_cur - 1U);
-            return SCRIPT_STATE_ERROR;
-        } else {
-            return (delay_val + bad_usb->defdelay);
-        }
+        return ducky_execute_insn(bad_usb, (DuckyInsn*)&bad_usb->code[bad_usb->code_last]);
     }
 
-    furi_string_set(bad_usb->line_prev, bad_usb->line);
-    furi_string_reset(bad_usb->line);
+    if(bad_usb->code_pc >= bad_usb->code_size) {
+        if(!ducky_script_compile(bad_usb, script_file)) return SCRIPT_STATE_END;
+    }
 
-    while(1) {
-        if(bad_usb->buf_len == 0) {
-            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-            if(storage_file_eof(script_file)) {
-                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
-                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
-                    bad_usb->buf_len++;
-                    bad_usb->file_end = true;
-                }
-            }
+    size_t insn_pc = bad_usb->code_pc;
+    DuckyInsn* insn = (DuckyInsn*)&bad_usb->code[insn_pc];
+    bad_usb->code_pc += sizeof(DuckyInsn) + insn->len;
+    bad_usb->st.line_cur = insn->line;
 
-            bad_usb->buf_start = 0;
-            if(bad_usb->buf_len == 0) return SCRIPT_STATE_END;
-        }
-        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
-            if(bad_usb->file_buf[i] == '\n' && furi_string_size(bad_usb->line) > 0) {
-                bad_usb->st.line_cur++;
-                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
-                bad_usb->buf_start = i + 1;
-                furi_string_trim(bad_usb->line);
-                delay_val = ducky_parse_line(
-                    bad_usb, bad_usb->line, bad_usb->st.error, sizeof(bad_usb->st.error));
-                if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-                    return 0;
-                } else if(delay_val < 0) {
-                    bad_usb->st.error_line = bad_usb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %u", bad_usb->st.line_cur);
-                    return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_usb->defdelay);
-                }
-            } else {
-                furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
-            }
+    if(insn->op == DuckyOpError) {
+        bad_usb->st.error_line = insn->line;
+        return SCRIPT_STATE_ERROR;
+    } else if(insn->op == DuckyOpRepeat) {
+        if(bad_usb->code_last != SCRIPT_CODE_NONE) {
+            memcpy(&bad_usb->repeat_cnt, insn->payload, sizeof(uint32_t));
         }
-        bad_usb->buf_len = 0;
-        if(bad_usb->file_end) return SCRIPT_STATE_END;
+        return insn->delay;
     }
 
-    return 0;
+    if(insn->op != DuckyOpDelay) {
+        bad_usb->code_last = insn_pc;
+    }
+    return ducky_execute_insn(bad_usb, insn);
 }
 
 static void bad_usb_hid_state_callback(bool state, void* context) {
@@ -490,7 +829,9 @@ static int32_t bad_usb_worker(void* context) {
     FURI_LOG_I(WORKER_TAG, "Init");
     File* script_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
     bad_usb->line = furi_string_alloc();
-    bad_usb->line_prev = furi_string_alloc();
+    bad_usb->code_capacity = SCRIPT_CODE_CHUNK;
+    bad_usb->code = malloc(bad_usb->code_capacity);
+    bad_usb->line_index = malloc(sizeof(uint32_t) * SCRIPT_LINE_INDEX_MAX);
 
     furi_hal_hid_set_state_callback(bad_usb_hid_state_callback, bad_usb);
 
@@ -502,6 +843,7 @@ static int32_t bad_usb_worker(void* context) {
                    FSAM_READ,
                    FSOM_OPEN_EXISTING)) {
                 if((ducky_script_preload(bad_usb, script_file)) && (bad_usb->st.line_nb > 0)) {
+                    ducky_script_rewind(bad_usb, script_file);
                     if(furi_hal_hid_is_connected()) {
                         worker_state = BadUsbStateIdle; // Ready to run
                     } else {
@@ -542,12 +884,7 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtToggle) { // Start executing script
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                ducky_script_rewind(bad_usb, script_file);
                 worker_state = BadUsbStateRunning;
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadUsbStateNotConnected; // USB disconnected
@@ -565,12 +902,7 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtConnect) { // Start executing script
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                ducky_script_rewind(bad_usb, script_file);
                 // extra time for PC to recognize Flipper as keyboard
                 furi_thread_flags_wait(0, FuriFlagWaitAny, 1500);
                 worker_state = BadUsbStateRunning;
@@ -642,7 +974,8 @@ static int32_t bad_usb_worker(void* context) {
     storage_file_close(script_file);
     storage_file_free(script_file);
     furi_string_free(bad_usb->line);
-    furi_string_free(bad_usb->line_prev);
+    free(bad_usb->code);
+    free(bad_usb->line_index);
 
     FURI_LOG_I(WORKER_TAG, "End");
 
@@ -22,11 +22,12 @@ typedef enum {
 
 typedef struct {
     BadUsbWorkerState state;
-    uint16_t line_cur;
-    uint16_t line_nb;
+    uint32_t line_cur;
+    uint32_t line_nb;
     uint32_t delay_remain;
-    uint16_t error_line;
+    uint32_t error_line;
     char error[64];
+    uint32_t chars_per_sec;
 } BadUsbState;
 
 BadUsbScript* bad_usb_script_open(FuriString* file_path);
@@ -17,6 +17,11 @@ typedef struct {
     uint8_t anim_frame;
 } BadUsbModel;
 
+static uint32_t bad_usb_get_progress(BadUsbState* state) {
+    if((state->line_cur == 0) || (state->line_nb == 0)) return 0;
+    return MIN(((uint64_t)(state->line_cur - 1) * 100) / state->line_nb, 99ULL);
+}
+
 static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
     BadUsbModel* model = _model;
 
@@ -58,7 +63,7 @@ static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str_aligned(canvas, 127, 33, AlignRight, AlignBottom, "ERROR:");
         canvas_set_font(canvas, FontSecondary);
-        furi_string_printf(disp_str, "line %u", model->state.error_line);
+        furi_string_printf(disp_str, "line %lu", model->state.error_line);
         canvas_draw_str_aligned(
             canvas, 127, 46, AlignRight, AlignBottom, furi_string_get_cstr(disp_str));
         furi_string_reset(disp_str);
@@ -75,18 +80,31 @@ static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
             canvas_draw_icon(canvas, 4, 19, &I_EviSmile2_18x21);
         }
         canvas_set_font(canvas, FontBigNumbers);
-        furi_string_printf(
-            disp_str, "%u", ((model->state.line_cur - 1) * 100) / model->state.line_nb);
+        furi_string_printf(disp_str, "%lu", bad_usb_get_progress(&model->state));
         canvas_draw_str_aligned(
             canvas, 114, 36, AlignRight, AlignBottom, furi_string_get_cstr(disp_str));
         furi_string_reset(disp_str);
         canvas_draw_icon(canvas, 117, 22, &I_Percent_10x14);
+        if(model->state.chars_per_sec > 0) {
+            canvas_set_font(canvas, FontSecondary);
+            furi_string_printf(disp_str, "%lu char/s", model->state.chars_per_sec);
+            canvas_draw_str_aligned(
+                canvas, 127, 46, AlignRight, AlignBottom, furi_string_get_cstr(disp_str));
+            furi_string_reset(disp_str);
+        }
     } else if(model->state.state == BadUsbStateDone) {
         canvas_draw_icon(canvas, 4, 19, &I_EviSmile1_18x21);
         canvas_set_font(canvas, FontBigNumbers);
         canvas_draw_str_aligned(canvas, 114, 36, AlignRight, AlignBottom, "100");
         furi_string_reset(disp_str);
         canvas_draw_icon(canvas, 117, 22, &I_Percent_10x14);
+        if(model->state.chars_per_sec > 0) {
+            canvas_set_font(canvas, FontSecondary);
+            furi_string_printf(disp_str, "%lu char/s", model->state.chars_per_sec);
+            canvas_draw_str_aligned(
+                canvas, 127, 46, AlignRight, AlignBottom, furi_string_get_cstr(disp_str));
+            furi_string_reset(disp_str);
+        }
     } else if(model->state.state == BadUsbStateDelay) {
         if(model->anim_frame == 0) {
             canvas_draw_icon(canvas, 4, 19, &I_EviWaiting1_18x21);
@@ -94,8 +112,7 @@ static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
             canvas_draw_icon(canvas, 4, 19, &I_EviWaiting2_18x21);
         }
         canvas_set_font(canvas, FontBigNumbers);
-        furi_string_printf(
-            disp_str, "%u", ((model->state.line_cur - 1) * 100) / model->state.line_nb);
+        furi_string_printf(disp_str, "%lu", bad_usb_get_progress(&model->state));
         canvas_draw_str_aligned(
             canvas, 114, 36, AlignRight, AlignBottom, furi_string_get_cstr(disp_str));
         furi_string_reset(disp_str);
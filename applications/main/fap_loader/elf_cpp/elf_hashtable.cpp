@@ -1,10 +1,16 @@
+// #define ELF_HASHTABLE_VERIFY_NAMES 1
+
 #include "compilesort.hpp"
 #include "elf_hashtable.h"
 #include "elf_hashtable_entry.h"
 #include "elf_hashtable_checks.hpp"
+#include "elf_perfect_hash.hpp"
 
 #include <array>
 #include <algorithm>
+#include <cstring>
+
+#include <toolbox/crc32_calc.h>
 
 /* Generated table */
 #include <symbols.h>
@@ -13,6 +19,25 @@
 
 static_assert(!has_hash_collisions(elf_api_table), "Detected API method hash collision!");
 
+static constexpr auto elf_api_hashtable = make_perfect_hash_table(elf_api_table);
+
+static_assert(elf_api_hashtable.valid, "Failed to build API perfect hash table!");
+
+static const sym_entry* elf_hashtable_find(const char* name) {
+    const sym_entry* entry = elf_api_hashtable.find(elf_gnu_hash(name));
+
+#ifdef ELF_HASHTABLE_VERIFY_NAMES
+    if(entry && strcmp(entry->name, name) != 0) {
+        FURI_LOG_W(TAG, "Symbol '%s' hash matches '%s'!", name, entry->name);
+        entry = nullptr;
+    }
+#endif
+
+    return entry;
+}
+
+/* Missing functions are not logged here, ELF loader reports each of them once */
+
 /**
  * Get function address by function name
  * @param name function name
@@ -21,28 +46,62 @@ static_assert(!has_hash_collisions(elf_api_table), "Detected API method hash col
  */
 
 bool elf_resolve_from_hashtable(const char* name, Elf32_Addr* address) {
-    bool result = false;
-    uint32_t gnu_sym_hash = elf_gnu_hash(name);
-
-    sym_entry key = {
-        .hash = gnu_sym_hash,
-        .address = 0,
-    };
-
-    auto find_res = std::lower_bound(elf_api_table.cbegin(), elf_api_table.cend(), key);
-    if((find_res == elf_api_table.cend() || (find_res->hash != gnu_sym_hash))) {
-        FURI_LOG_W(TAG, "Can't find symbol '%s' (hash %lx)!", name, gnu_sym_hash);
-        result = false;
-    } else {
-        result = true;
-        *address = find_res->address;
+    const sym_entry* entry = elf_hashtable_find(name);
+    if(entry) {
+        *address = entry->address;
     }
+    return entry != nullptr;
+}
 
-    return result;
+/**
+ * Get addresses for multiple functions
+ * @param names function names
+ * @param addresses output for addresses, ELF_INVALID_ADDRESS for missing functions
+ * @param count number of names
+ * @return number of resolved functions
+ */
+
+size_t elf_resolve_batch_from_hashtable(
+    const char* const* names,
+    Elf32_Addr* addresses,
+    size_t count) {
+    size_t resolved = 0;
+
+    for(size_t i = 0; i < count; i++) {
+        const sym_entry* entry = elf_hashtable_find(names[i]);
+        if(entry) {
+            addresses[i] = entry->address;
+            resolved++;
+        } else {
+            addresses[i] = ELF_INVALID_ADDRESS;
+        }
+    }
+
+    return resolved;
+}
+
+/**
+ * Get hash of the API table
+ * Covers name hashes and addresses, so it changes with any rebuild that moves a symbol
+ * @return table hash
+ */
+
+uint32_t elf_hashtable_table_hash() {
+    static uint32_t table_hash = 0;
+    if(!table_hash) {
+        table_hash = crc32_calc_buffer(0, &elf_api_version, sizeof(elf_api_version));
+        for(const sym_entry& entry : elf_api_table) {
+            table_hash = crc32_calc_buffer(table_hash, &entry.hash, sizeof(entry.hash));
+            table_hash = crc32_calc_buffer(table_hash, &entry.address, sizeof(entry.address));
+        }
+    }
+    return table_hash;
 }
 
 const ElfApiInterface hashtable_api_interface = {
     .api_version_major = (elf_api_version >> 16),
     .api_version_minor = (elf_api_version & 0xFFFF),
     .resolver_callback = &elf_resolve_from_hashtable,
+    .resolver_batch_callback = &elf_resolve_batch_from_hashtable,
+    .table_hash_callback = &elf_hashtable_table_hash,
 };
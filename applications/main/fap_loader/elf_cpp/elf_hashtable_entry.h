@@ -8,6 +8,9 @@ extern "C" {
 struct sym_entry {
     uint32_t hash;
     uint32_t address;
+#ifdef ELF_HASHTABLE_VERIFY_NAMES
+    const char* name;
+#endif
 };
 
 #ifdef __cplusplus
@@ -16,6 +19,18 @@ struct sym_entry {
 #include <array>
 #include <algorithm>
 
+#ifdef ELF_HASHTABLE_VERIFY_NAMES
+#define API_METHOD(x, ret_type, args_type)                                       \
+    sym_entry {                                                                  \
+        .hash = elf_gnu_hash(#x),                                                \
+        .address = (uint32_t)(static_cast<ret_type(*) args_type>(x)), .name = #x \
+    }
+
+#define API_VARIABLE(x, var_type)                                           \
+    sym_entry {                                                             \
+        .hash = elf_gnu_hash(#x), .address = (uint32_t)(&(x)), .name = #x, \
+    }
+#else
 #define API_METHOD(x, ret_type, args_type)                                                     \
     sym_entry {                                                                                \
         .hash = elf_gnu_hash(#x), .address = (uint32_t)(static_cast<ret_type(*) args_type>(x)) \
@@ -25,6 +40,7 @@ struct sym_entry {
     sym_entry {                                                \
         .hash = elf_gnu_hash(#x), .address = (uint32_t)(&(x)), \
     }
+#endif
 
 constexpr bool operator<(const sym_entry& k1, const sym_entry& k2) {
     return k1.hash < k2.hash;
@@ -0,0 +1,147 @@
+/**
+ * Compile-time minimal perfect hash over API symbol table.
+ *
+ * Hash-and-displace scheme: symbols are split into buckets by their hash,
+ * each bucket gets a displacement value that maps all its members into
+ * free slots of a table with exactly one slot per symbol. Buckets with a
+ * single symbol are placed last and store slot index directly, which keeps
+ * compile-time construction cheap when the table is almost full.
+ * Lookup is one bucket read, one slot read and a hash comparison.
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "elf_hashtable_entry.h"
+
+/* Average number of symbols per bucket */
+#define ELF_PERFECT_HASH_BUCKET_LOAD 2
+/* Largest bucket that can be placed */
+#define ELF_PERFECT_HASH_MAX_BUCKET_SIZE 24
+/* Displacement value with this bit set is a direct slot index */
+#define ELF_PERFECT_HASH_DIRECT_SLOT 0x8000U
+/* Displacement search limit */
+#define ELF_PERFECT_HASH_MAX_DISPLACEMENT (ELF_PERFECT_HASH_DIRECT_SLOT - 1)
+
+constexpr uint32_t elf_perfect_hash_mix(uint32_t hash, uint32_t seed) {
+    uint32_t h = hash ^ (seed * 0x9E3779B9UL);
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+
+constexpr std::size_t elf_perfect_hash_bucket_count(std::size_t symbol_count) {
+    return symbol_count / ELF_PERFECT_HASH_BUCKET_LOAD + 1;
+}
+
+template <std::size_t N, std::size_t B = elf_perfect_hash_bucket_count(N)>
+struct ElfPerfectHashTable {
+    static_assert(N < ELF_PERFECT_HASH_DIRECT_SLOT, "Too many symbols for perfect hash table");
+
+    bool valid;
+    std::array<uint16_t, B> displacement;
+    std::array<sym_entry, N> entries;
+
+    constexpr std::size_t bucket_of(uint32_t hash) const {
+        return elf_perfect_hash_mix(hash, 0) % B;
+    }
+
+    static constexpr std::size_t slot_of(uint32_t hash, uint16_t displacement) {
+        if(displacement & ELF_PERFECT_HASH_DIRECT_SLOT) {
+            return displacement & ~ELF_PERFECT_HASH_DIRECT_SLOT;
+        }
+        return elf_perfect_hash_mix(hash, displacement + 1UL) % N;
+    }
+
+    /* Returns entry with matching hash or nullptr */
+    const sym_entry* find(uint32_t hash) const {
+        const sym_entry* entry = &entries[slot_of(hash, displacement[bucket_of(hash)])];
+        return (entry->hash == hash) ? entry : nullptr;
+    }
+};
+
+template <std::size_t N, std::size_t B = elf_perfect_hash_bucket_count(N)>
+constexpr ElfPerfectHashTable<N, B>
+    make_perfect_hash_table(const std::array<sym_entry, N> symbols) {
+    ElfPerfectHashTable<N, B> table{};
+    table.valid = false;
+
+    /* Group symbols by bucket: bucket_start[b]..bucket_start[b + 1] in bucket_members */
+    std::array<uint16_t, B + 1> bucket_start{};
+    std::array<uint16_t, N> bucket_members{};
+    std::array<bool, N> slot_used{};
+    std::size_t max_bucket_size = 0;
+
+    for(std::size_t i = 0; i < N; i++) {
+        bucket_start[table.bucket_of(symbols[i].hash) + 1]++;
+    }
+    for(std::size_t bucket = 0; bucket < B; bucket++) {
+        std::size_t bucket_size = bucket_start[bucket + 1];
+        if(bucket_size > max_bucket_size) max_bucket_size = bucket_size;
+        bucket_start[bucket + 1] += bucket_start[bucket];
+    }
+    {
+        std::array<uint16_t, B> bucket_fill{};
+        for(std::size_t i = 0; i < N; i++) {
+            std::size_t bucket = table.bucket_of(symbols[i].hash);
+            bucket_members[bucket_start[bucket] + bucket_fill[bucket]++] = i;
+        }
+    }
+
+    if(max_bucket_size > ELF_PERFECT_HASH_MAX_BUCKET_SIZE) {
+        return table;
+    }
+
+    /* Place largest buckets first while table is still empty */
+    for(std::size_t size = max_bucket_size; size > 1; size--) {
+        for(std::size_t bucket = 0; bucket < B; bucket++) {
+            if((std::size_t)(bucket_start[bucket + 1] - bucket_start[bucket]) != size) continue;
+            const uint16_t* members = &bucket_members[bucket_start[bucket]];
+
+            bool placed = false;
+            std::array<std::size_t, ELF_PERFECT_HASH_MAX_BUCKET_SIZE> slots{};
+            for(uint32_t displacement = 0;
+                !placed && displacement <= ELF_PERFECT_HASH_MAX_DISPLACEMENT;
+                displacement++) {
+                placed = true;
+                for(std::size_t m = 0; placed && m < size; m++) {
+                    slots[m] = table.slot_of(symbols[members[m]].hash, displacement);
+                    if(slot_used[slots[m]]) placed = false;
+                    for(std::size_t k = 0; placed && k < m; k++) {
+                        if(slots[k] == slots[m]) placed = false;
+                    }
+                }
+
+                if(placed) {
+                    table.displacement[bucket] = displacement;
+                }
+            }
+
+            if(!placed) {
+                return table;
+            }
+
+            for(std::size_t m = 0; m < size; m++) {
+                slot_used[slots[m]] = true;
+                table.entries[slots[m]] = symbols[members[m]];
+            }
+        }
+    }
+
+    /* Single symbol buckets go to remaining free slots */
+    std::size_t free_slot = 0;
+    for(std::size_t bucket = 0; bucket < B; bucket++) {
+        if(bucket_start[bucket + 1] - bucket_start[bucket] != 1) continue;
+        while(slot_used[free_slot]) free_slot++;
+        slot_used[free_slot] = true;
+        table.displacement[bucket] = ELF_PERFECT_HASH_DIRECT_SLOT | free_slot;
+        table.entries[free_slot] = symbols[bucket_members[bucket_start[bucket]]];
+    }
+
+    table.valid = true;
+    return table;
+}
@@ -5,20 +5,32 @@
 #include <storage/storage.h>
 #include <gui/modules/loading.h>
 #include <dialogs/dialogs.h>
+#include <loader/loader.h>
+#include <toolbox/path.h>
 #include <flipper_application/flipper_application.h>
 #include "elf_cpp/elf_hashtable.h"
 #include "fap_loader_app.h"
 
 #define TAG "fap_loader_app"
 
+#define FAP_LOADER_IMPORT_CACHE_DIR EXT_PATH("apps/.cache")
+#define FAP_LOADER_PRELOAD_STACK_SIZE 2048
+
 struct FapLoader {
     FlipperApplication* app;
     Storage* storage;
     DialogsApp* dialogs;
     Gui* gui;
+    Loader* loader;
     FuriString* fap_path;
     ViewDispatcher* view_dispatcher;
     Loading* loading;
+
+    // Headers and manifest of the last launched app, loaded while browser is shown
+    FuriThread* preload_thread;
+    FlipperApplication* preload_app;
+    FuriString* preload_path;
+    FlipperApplicationPreloadStatus preload_status;
 };
 
 bool fap_loader_load_name_and_icon(
@@ -59,6 +71,74 @@ static bool fap_loader_item_callback(
     return fap_loader_load_name_and_icon(path, fap_loader->storage, icon_ptr, item_name);
 }
 
+static FlipperApplication* fap_loader_app_alloc(FapLoader* loader) {
+    FlipperApplication* app = flipper_application_alloc(loader->storage, &hashtable_api_interface);
+    flipper_application_enable_import_cache(app, FAP_LOADER_IMPORT_CACHE_DIR);
+    return app;
+}
+
+static int32_t fap_loader_preload_worker(void* context) {
+    FapLoader* loader = context;
+    loader->preload_status = flipper_application_preload_manifest(
+        loader->preload_app, furi_string_get_cstr(loader->preload_path));
+    return 0;
+}
+
+/* Browser opens at the last launched app, so it is the most likely next one */
+static void fap_loader_preload_start(FapLoader* loader) {
+    furi_assert(!loader->preload_thread);
+
+    if(!furi_string_end_with_str(loader->fap_path, ".fap")) return;
+
+    furi_string_set(loader->preload_path, loader->fap_path);
+    loader->preload_app = fap_loader_app_alloc(loader);
+    loader->preload_thread = furi_thread_alloc_ex(
+        "FapPreload", FAP_LOADER_PRELOAD_STACK_SIZE, fap_loader_preload_worker, loader);
+    furi_thread_start(loader->preload_thread);
+}
+
+/* Get preloaded app if it is the selected one */
+static FlipperApplication* fap_loader_preload_take(FapLoader* loader) {
+    if(!loader->preload_thread) return NULL;
+
+    furi_thread_join(loader->preload_thread);
+    furi_thread_free(loader->preload_thread);
+    loader->preload_thread = NULL;
+
+    FlipperApplication* app = loader->preload_app;
+    loader->preload_app = NULL;
+
+    if(loader->preload_status != FlipperApplicationPreloadStatusSuccess ||
+       !furi_string_equal(loader->preload_path, loader->fap_path)) {
+        flipper_application_free(app);
+        app = NULL;
+    }
+
+    return app;
+}
+
+/* Open stage of preloaded app was done on preload thread, not on launch path */
+static void fap_loader_report_timing(FapLoader* loader, bool preloaded) {
+    FlipperApplicationLoadStats stats;
+    flipper_application_get_load_stats(loader->app, &stats);
+
+    loader_timing_set_stage(
+        loader->loader, LoaderTimingStageOpen, preloaded ? 0 : stats.open_time);
+    loader_timing_set_stage(loader->loader, LoaderTimingStageSections, stats.section_time);
+    loader_timing_set_stage(loader->loader, LoaderTimingStageSymbols, stats.symbol_time);
+    loader_timing_set_stage(loader->loader, LoaderTimingStageRelocation, stats.relocation_time);
+    loader_timing_set_stage(
+        loader->loader, LoaderTimingStageConstructors, stats.constructor_time);
+}
+
+// Called from application thread before its entry, so its first frame can't be missed
+static void fap_loader_thread_state_callback(FuriThreadState thread_state, void* context) {
+    FapLoader* loader = context;
+    if(thread_state == FuriThreadStateRunning) {
+        loader_timing_set_frame_owner(loader->loader, furi_thread_get_current_id());
+    }
+}
+
 static bool fap_loader_run_selected_app(FapLoader* loader) {
     furi_assert(loader);
 
@@ -68,15 +148,29 @@ static bool fap_loader_run_selected_app(FapLoader* loader) {
 
     bool file_selected = false;
     bool show_error = true;
+    bool preloaded = false;
     do {
         file_selected = true;
-        loader->app = flipper_application_alloc(loader->storage, &hashtable_api_interface);
         size_t start = furi_get_tick();
+        FlipperApplicationPreloadStatus preload_res;
 
         FURI_LOG_I(TAG, "FAP Loader is loading %s", furi_string_get_cstr(loader->fap_path));
 
-        FlipperApplicationPreloadStatus preload_res =
-            flipper_application_preload(loader->app, furi_string_get_cstr(loader->fap_path));
+        FuriString* timing_name = furi_string_alloc();
+        path_extract_filename_no_ext(furi_string_get_cstr(loader->fap_path), timing_name);
+        loader_timing_begin(loader->loader, furi_string_get_cstr(timing_name));
+        furi_string_free(timing_name);
+
+        loader->app = fap_loader_preload_take(loader);
+        preloaded = (loader->app != NULL);
+        if(preloaded) {
+            FURI_LOG_I(TAG, "Using preloaded headers");
+            preload_res = flipper_application_preload_sections(loader->app);
+        } else {
+            loader->app = fap_loader_app_alloc(loader);
+            preload_res =
+                flipper_application_preload(loader->app, furi_string_get_cstr(loader->fap_path));
+        }
         if(preload_res != FlipperApplicationPreloadStatusSuccess) {
             const char* err_msg = flipper_application_preload_status_to_string(preload_res);
             furi_string_printf(error_message, "Preload failed: %s", err_msg);
@@ -105,8 +199,13 @@ static bool fap_loader_run_selected_app(FapLoader* loader) {
         FURI_LOG_I(TAG, "FAP Loader is starting app");
 
         FuriThread* thread = flipper_application_spawn(loader->app, NULL);
+        furi_thread_set_state_callback(thread, fap_loader_thread_state_callback);
+        furi_thread_set_state_context(thread, loader);
         furi_thread_start(thread);
+        fap_loader_report_timing(loader, preloaded);
         furi_thread_join(thread);
+        // Constructors ran in application thread
+        fap_loader_report_timing(loader, preloaded);
 
         show_error = false;
         int ret = furi_thread_get_return_code(thread);
@@ -151,8 +250,15 @@ static bool fap_loader_select_app(FapLoader* loader) {
         .base_path = EXT_PATH("apps"),
     };
 
-    return dialog_file_browser_show(
+    fap_loader_preload_start(loader);
+    bool selected = dialog_file_browser_show(
         loader->dialogs, loader->fap_path, loader->fap_path, &browser_options);
+    if(!selected) {
+        FlipperApplication* app = fap_loader_preload_take(loader);
+        if(app) flipper_application_free(app);
+    }
+
+    return selected;
 }
 
 static FapLoader* fap_loader_alloc(const char* path) {
@@ -161,6 +267,8 @@ static FapLoader* fap_loader_alloc(const char* path) {
     loader->storage = furi_record_open(RECORD_STORAGE);
     loader->dialogs = furi_record_open(RECORD_DIALOGS);
     loader->gui = furi_record_open(RECORD_GUI);
+    loader->loader = furi_record_open(RECORD_LOADER);
+    loader->preload_path = furi_string_alloc();
     loader->view_dispatcher = view_dispatcher_alloc();
     loader->loading = loading_alloc();
     view_dispatcher_attach_to_gui(
@@ -174,6 +282,8 @@ static void fap_loader_free(FapLoader* loader) {
     loading_free(loader->loading);
     view_dispatcher_free(loader->view_dispatcher);
     furi_string_free(loader->fap_path);
+    furi_string_free(loader->preload_path);
+    furi_record_close(RECORD_LOADER);
     furi_record_close(RECORD_GUI);
     furi_record_close(RECORD_DIALOGS);
     furi_record_close(RECORD_STORAGE);
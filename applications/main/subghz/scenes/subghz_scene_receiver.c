@@ -67,41 +67,39 @@ void subghz_scene_receiver_callback(SubGhzCustomEvent event, void* context) {
     view_dispatcher_send_custom_event(subghz->view_dispatcher, event);
 }
 
+static void subghz_scene_receiver_item_callback(
+    uint16_t idx,
+    FuriString* text,
+    uint8_t* type,
+    void* context) {
+    furi_assert(context);
+    SubGhz* subghz = context;
+    subghz_history_get_text_item_menu(subghz->txrx->history, text, idx);
+    *type = subghz_history_get_type_protocol(subghz->txrx->history, idx);
+}
+
 static void subghz_scene_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
     void* context) {
     furi_assert(context);
     SubGhz* subghz = context;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
 
     if(subghz_history_add_to_history(subghz->txrx->history, decoder_base, subghz->txrx->preset)) {
-        furi_string_reset(str_buff);
-
         subghz->state_notifications = SubGhzNotificationStateRxDone;
 
-        subghz_history_get_text_item_menu(
-            subghz->txrx->history, str_buff, subghz_history_get_item(subghz->txrx->history) - 1);
-        subghz_view_receiver_add_item_to_menu(
-            subghz->subghz_receiver,
-            furi_string_get_cstr(str_buff),
-            subghz_history_get_type_protocol(
-                subghz->txrx->history, subghz_history_get_item(subghz->txrx->history) - 1));
+        subghz_view_receiver_set_item_count(
+            subghz->subghz_receiver, subghz_history_get_item(subghz->txrx->history));
 
         subghz_scene_receiver_update_statusbar(subghz);
     }
     subghz_receiver_reset(receiver);
-    furi_string_free(str_buff);
     subghz->txrx->rx_key_state = SubGhzRxKeyStateAddKey;
 }
 
 void subghz_scene_receiver_on_enter(void* context) {
     SubGhz* subghz = context;
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(subghz->txrx->rx_key_state == SubGhzRxKeyStateIDLE) {
         subghz_preset_init(
             subghz, "AM650", subghz_setting_get_default_frequency(subghz->setting), NULL, 0);
@@ -111,18 +109,15 @@ void subghz_scene_receiver_on_enter(void* context) {
 
     subghz_view_receiver_set_lock(subghz->subghz_receiver, subghz->lock);
 
-    //Load history to receiver
+    //Load history to receiver, items are read by view on demand
     subghz_view_receiver_exit(subghz->subghz_receiver);
-    for(uint8_t i = 0; i < subghz_history_get_item(subghz->txrx->history); i++) {
-        furi_string_reset(str_buff);
-        subghz_history_get_text_item_menu(subghz->txrx->history, str_buff, i);
-        subghz_view_receiver_add_item_to_menu(
-            subghz->subghz_receiver,
-            furi_string_get_cstr(str_buff),
-            subghz_history_get_type_protocol(subghz->txrx->history, i));
+    subghz_view_receiver_set_item_callback(
+        subghz->subghz_receiver, subghz_scene_receiver_item_callback, subghz);
+    subghz_view_receiver_set_item_count(
+        subghz->subghz_receiver, subghz_history_get_item(subghz->txrx->history));
+    if(subghz_history_get_item(subghz->txrx->history)) {
         subghz->txrx->rx_key_state = SubGhzRxKeyStateAddKey;
     }
-    furi_string_free(str_buff);
     subghz_scene_receiver_update_statusbar(subghz);
     subghz_view_receiver_set_callback(
         subghz->subghz_receiver, subghz_scene_receiver_callback, subghz);
@@ -204,7 +199,12 @@ bool subghz_scene_receiver_on_event(void* context, SceneManagerEvent event) {
             break;
         }
     } else if(event.type == SceneManagerEventTypeTick) {
+        subghz_history_flush(subghz->txrx->history);
         if(subghz->txrx->hopper_state != SubGhzHopperStateOFF) {
+            if(subghz->state_notifications == SubGhzNotificationStateRxDone) {
+                // Credit the key to current frequency before hopper moves on
+                subghz_hopper_key_received(subghz->txrx->hopper);
+            }
             subghz_hopper_update(subghz);
             subghz_scene_receiver_update_statusbar(subghz);
         }
@@ -175,6 +175,10 @@ static void subghz_scene_receiver_config_set_hopping_running(VariableItem* item)
             subghz_setting_get_frequency_default_index(subghz->setting));
     }
 
+    if((subghz->txrx->hopper_state == SubGhzHopperStateOFF) &&
+       (hopping_value[index] != SubGhzHopperStateOFF)) {
+        subghz_hopper_reset(subghz->txrx->hopper);
+    }
     subghz->txrx->hopper_state = hopping_value[index];
 }
 
@@ -1,109 +1,99 @@
 #include "subghz_history.h"
+#include <flipper_format/flipper_format_i.h>
+#include <lib/toolbox/stream/stream.h>
 #include <lib/subghz/receiver.h>
+#include <lib/subghz/subghz_history_store.h>
 #include <lib/subghz/protocols/came.h>
 
 #include <furi.h>
 
-#define SUBGHZ_HISTORY_MAX 50
+#define SUBGHZ_HISTORY_MAX 9999
+#define SUBGHZ_HISTORY_RAM_MAX 50
+#define SUBGHZ_HISTORY_SPILL_PATH EXT_PATH(".subghz_history")
+#define SUBGHZ_HISTORY_REPEAT_TIMEOUT 500
 #define TAG "SubGhzHistory"
 
-typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_string;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} SubGhzHistoryItem;
-
-ARRAY_DEF(SubGhzHistoryItemArray, SubGhzHistoryItem, M_POD_OPLIST)
-
-#define M_OPL_SubGhzHistoryItemArray_t() ARRAY_OPLIST(SubGhzHistoryItemArray, M_POD_OPLIST)
-
-typedef struct {
-    SubGhzHistoryItemArray_t data;
-} SubGhzHistoryStruct;
-
 struct SubGhzHistory {
-    uint32_t last_update_timestamp;
-    uint16_t last_index_write;
-    uint8_t code_last_hash_data;
+    SubGhzHistoryStore* store;
+    /* used by add_to_history, called from worker thread */
+    FlipperFormat* add_data;
+    FuriString* add_string;
+    /* returned to app by getters */
+    FlipperFormat* raw_data;
     FuriString* tmp_string;
-    SubGhzHistoryStruct* history;
+    SubGhzRadioPreset preset;
 };
 
 SubGhzHistory* subghz_history_alloc(void) {
     SubGhzHistory* instance = malloc(sizeof(SubGhzHistory));
+    instance->store = subghz_history_store_alloc(
+        SUBGHZ_HISTORY_SPILL_PATH, SUBGHZ_HISTORY_RAM_MAX, SUBGHZ_HISTORY_MAX);
+    instance->add_data = flipper_format_string_alloc();
+    instance->add_string = furi_string_alloc();
+    instance->raw_data = flipper_format_string_alloc();
     instance->tmp_string = furi_string_alloc();
-    instance->history = malloc(sizeof(SubGhzHistoryStruct));
-    SubGhzHistoryItemArray_init(instance->history->data);
+    instance->preset.name = furi_string_alloc();
     return instance;
 }
 
 void subghz_history_free(SubGhzHistory* instance) {
     furi_assert(instance);
+    subghz_history_store_free(instance->store);
+    flipper_format_free(instance->add_data);
+    furi_string_free(instance->add_string);
+    flipper_format_free(instance->raw_data);
     furi_string_free(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_clear(instance->history->data);
-    free(instance->history);
+    furi_string_free(instance->preset.name);
     free(instance);
 }
 
 uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset->frequency;
+    SubGhzHistoryRecord record;
+    if(!subghz_history_store_get_record(instance->store, idx, &record)) return 0;
+    return record.frequency;
 }
 
 SubGhzRadioPreset* subghz_history_get_radio_preset(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
+    if(!subghz_history_store_get_preset(instance->store, idx, &instance->preset)) {
+        FURI_LOG_E(TAG, "Missing preset");
+    }
+    return &instance->preset;
 }
 
 const char* subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return furi_string_get_cstr(item->preset->name);
+    return furi_string_get_cstr(subghz_history_get_radio_preset(instance, idx)->name);
 }
 
 void subghz_history_reset(SubGhzHistory* instance) {
     furi_assert(instance);
     furi_string_reset(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_reset(instance->history->data);
-    instance->last_index_write = 0;
-    instance->code_last_hash_data = 0;
+    subghz_history_store_reset(instance->store);
+}
+
+void subghz_history_flush(SubGhzHistory* instance) {
+    furi_assert(instance);
+    subghz_history_store_flush(instance->store);
 }
 
 uint16_t subghz_history_get_item(SubGhzHistory* instance) {
     furi_assert(instance);
-    return instance->last_index_write;
+    return subghz_history_store_get_count(instance->store);
 }
 
 uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    SubGhzHistoryRecord record;
+    if(!subghz_history_store_get_record(instance->store, idx, &record)) return 0;
+    return record.type;
 }
 
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+    FlipperFormat* data = subghz_history_get_raw_data(instance, idx);
+    if(!data || !flipper_format_read_string(data, "Protocol", instance->tmp_string)) {
         FURI_LOG_E(TAG, "Missing Protocol");
         furi_string_reset(instance->tmp_string);
     }
@@ -112,118 +102,151 @@ const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t i
 
 FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
+    if(subghz_history_store_get_data(instance->store, idx, instance->raw_data)) {
+        return instance->raw_data;
     } else {
         return NULL;
     }
 }
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, FuriString* output) {
     furi_assert(instance);
-    if(instance->last_index_write == SUBGHZ_HISTORY_MAX) {
+    uint16_t count = subghz_history_store_get_count(instance->store);
+    uint16_t capacity = subghz_history_store_get_capacity(instance->store);
+    if(count >= capacity) {
         if(output != NULL) furi_string_printf(output, "Memory is FULL");
         return true;
     }
-    if(output != NULL)
-        furi_string_printf(output, "%02u/%02u", instance->last_index_write, SUBGHZ_HISTORY_MAX);
+    if(output != NULL) {
+        if(subghz_history_store_is_spill_enabled(instance->store)) {
+            furi_string_printf(output, "%02u", count);
+        } else {
+            furi_string_printf(output, "%02u/%02u", count, capacity);
+        }
+    }
     return false;
 }
 
 void subghz_history_get_text_item_menu(SubGhzHistory* instance, FuriString* output, uint16_t idx) {
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    furi_string_set(output, item->item_str);
+    SubGhzHistoryRecord record;
+    if(subghz_history_store_get_record(instance->store, idx, &record)) {
+        furi_string_set(output, record.text);
+    } else {
+        furi_string_reset(output);
+    }
 }
 
-bool subghz_history_add_to_history(
-    SubGhzHistory* instance,
-    void* context,
-    SubGhzRadioPreset* preset) {
-    furi_assert(instance);
-    furi_assert(context);
-
-    if(instance->last_index_write >= SUBGHZ_HISTORY_MAX) return false;
-
-    SubGhzProtocolDecoderBase* decoder_base = context;
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
-        return false;
+static uint32_t subghz_history_get_hash(
+    SubGhzProtocolDecoderBase* decoder_base,
+    const SubGhzHistoryRecord* record) {
+    /* FNV-1a over protocol name and key, decoder hash alone is only 8 bits */
+    uint32_t hash = 2166136261UL;
+    for(const char* name = decoder_base->protocol->name; *name; name++) {
+        hash = (hash ^ (uint8_t)*name) * 16777619UL;
     }
+    for(uint8_t i = 0; i < sizeof(uint64_t); i++) {
+        hash = (hash ^ (uint8_t)(record->key >> (i * 8))) * 16777619UL;
+    }
+    hash = (hash ^ record->bits) * 16777619UL;
+    hash = (hash ^ subghz_protocol_decoder_base_get_hash_data(decoder_base)) * 16777619UL;
+    return hash;
+}
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
-
-    FuriString* text;
-    text = furi_string_alloc();
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_push_raw(instance->history->data);
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->type = decoder_base->protocol->type;
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
-
-    item->item_str = furi_string_alloc();
-    item->flipper_string = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
+static void subghz_history_fill_record(SubGhzHistory* instance, SubGhzHistoryRecord* record) {
+    FlipperFormat* data = instance->add_data;
+    FuriString* text = instance->add_string;
+    FuriString* protocol = furi_string_alloc();
 
     do {
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(data)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
-        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+        if(!flipper_format_read_string(data, "Protocol", protocol)) {
             FURI_LOG_E(TAG, "Missing Protocol");
             break;
         }
-        if(!strcmp(furi_string_get_cstr(instance->tmp_string), "KeeLoq")) {
-            furi_string_set(instance->tmp_string, "KL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+        if(!strcmp(furi_string_get_cstr(protocol), "KeeLoq")) {
+            furi_string_set(protocol, "KL ");
+            if(!flipper_format_read_string(data, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            furi_string_cat(instance->tmp_string, text);
-        } else if(!strcmp(furi_string_get_cstr(instance->tmp_string), "Star Line")) {
-            furi_string_set(instance->tmp_string, "SL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+            furi_string_cat(protocol, text);
+        } else if(!strcmp(furi_string_get_cstr(protocol), "Star Line")) {
+            furi_string_set(protocol, "SL ");
+            if(!flipper_format_read_string(data, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            furi_string_cat(instance->tmp_string, text);
+            furi_string_cat(protocol, text);
         }
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(data)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
+        uint32_t bits = 0;
+        if(flipper_format_read_uint32(data, "Bit", &bits, 1)) {
+            record->bits = bits;
+        }
         uint8_t key_data[sizeof(uint64_t)] = {0};
-        if(!flipper_format_read_hex(item->flipper_string, "Key", key_data, sizeof(uint64_t))) {
+        if(!flipper_format_read_hex(data, "Key", key_data, sizeof(uint64_t))) {
             FURI_LOG_E(TAG, "Missing Key");
             break;
         }
-        uint64_t data = 0;
         for(uint8_t i = 0; i < sizeof(uint64_t); i++) {
-            data = (data << 8) | key_data[i];
+            record->key = (record->key << 8) | key_data[i];
         }
-        if(!(uint32_t)(data >> 32)) {
-            furi_string_printf(
-                item->item_str,
+        if(!(uint32_t)(record->key >> 32)) {
+            snprintf(
+                record->text,
+                sizeof(record->text),
                 "%s %lX",
-                furi_string_get_cstr(instance->tmp_string),
-                (uint32_t)(data & 0xFFFFFFFF));
+                furi_string_get_cstr(protocol),
+                (uint32_t)(record->key & 0xFFFFFFFF));
         } else {
-            furi_string_printf(
-                item->item_str,
+            snprintf(
+                record->text,
+                sizeof(record->text),
                 "%s %lX%08lX",
-                furi_string_get_cstr(instance->tmp_string),
-                (uint32_t)(data >> 32),
-                (uint32_t)(data & 0xFFFFFFFF));
+                furi_string_get_cstr(protocol),
+                (uint32_t)(record->key >> 32),
+                (uint32_t)(record->key & 0xFFFFFFFF));
         }
     } while(false);
 
-    furi_string_free(text);
-    instance->last_index_write++;
-    return true;
+    furi_string_free(protocol);
+}
+
+bool subghz_history_add_to_history(
+    SubGhzHistory* instance,
+    void* context,
+    SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(context);
+
+    if(subghz_history_get_text_space_left(instance, NULL)) return false;
+
+    SubGhzProtocolDecoderBase* decoder_base = context;
+    SubGhzHistoryRecord record = {0};
+    record.type = decoder_base->protocol->type;
+    record.frequency = preset->frequency;
+    record.timestamp = furi_get_tick();
+
+    stream_clean(flipper_format_get_raw_stream(instance->add_data));
+    subghz_protocol_decoder_base_serialize(decoder_base, instance->add_data, preset);
+    subghz_history_fill_record(instance, &record);
+    record.hash = subghz_history_get_hash(decoder_base, &record);
+
+    uint16_t idx;
+    if(subghz_history_store_find(instance->store, record.hash, &idx)) {
+        SubGhzHistoryRecord found;
+        if(subghz_history_store_get_record(instance->store, idx, &found) &&
+           ((record.timestamp - found.timestamp) < SUBGHZ_HISTORY_REPEAT_TIMEOUT)) {
+            found.timestamp = record.timestamp;
+            subghz_history_store_update(instance->store, idx, &found, NULL);
+            return false;
+        }
+    }
+
+    return subghz_history_store_add(instance->store, &record, preset, instance->add_data);
 }
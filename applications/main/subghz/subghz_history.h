@@ -27,6 +27,12 @@ void subghz_history_free(SubGhzHistory* instance);
  */
 void subghz_history_reset(SubGhzHistory* instance);
 
+/** Move older records to SD-card, call periodically from app thread
+ * 
+ * @param instance - SubGhzHistory instance
+ */
+void subghz_history_flush(SubGhzHistory* instance);
+
 /** Get frequency to history[idx]
  * 
  * @param instance  - SubGhzHistory instance
@@ -85,6 +91,7 @@ void subghz_history_get_text_item_menu(SubGhzHistory* instance, FuriString* outp
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, FuriString* output);
 
 /** Add protocol to history
+ * Repeats are detected among records kept in RAM only
  * 
  * @param instance  - SubGhzHistory instance
  * @param context    - SubGhzProtocolCommon context
@@ -100,6 +107,6 @@ bool subghz_history_add_to_history(
  * 
  * @param instance  - SubGhzHistory instance
  * @param idx       - record index
- * @return SubGhzProtocolCommonLoad*
+ * @return SubGhzProtocolCommonLoad*, valid until next call
  */
 FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx);
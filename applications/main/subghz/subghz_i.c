@@ -549,6 +549,7 @@ void subghz_hopper_update(SubGhz* subghz) {
     case SubGhzHopperStateRSSITimeOut:
         if(subghz->txrx->hopper_timeout != 0) {
             subghz->txrx->hopper_timeout--;
+            subghz_hopper_dwell_tick(subghz->txrx->hopper);
             return;
         }
         break;
@@ -560,9 +561,10 @@ void subghz_hopper_update(SubGhz* subghz) {
         // See RSSI Calculation timings in CC1101 17.3 RSSI
         rssi = furi_hal_subghz_get_rssi();
 
-        // Stay if RSSI is high enough
-        if(rssi > -90.0f) {
-            subghz->txrx->hopper_timeout = 10;
+        // Stay if RSSI is high enough, hopper decides for how long
+        uint8_t dwell = subghz_hopper_rssi(subghz->txrx->hopper, rssi);
+        if(dwell) {
+            subghz->txrx->hopper_timeout = dwell;
             subghz->txrx->hopper_state = SubGhzHopperStateRSSITimeOut;
             return;
         }
@@ -570,20 +572,14 @@ void subghz_hopper_update(SubGhz* subghz) {
         subghz->txrx->hopper_state = SubGhzHopperStateRunnig;
     }
     // Select next frequency
-    if(subghz->txrx->hopper_idx_frequency <
-       subghz_setting_get_hopper_frequency_count(subghz->setting) - 1) {
-        subghz->txrx->hopper_idx_frequency++;
-    } else {
-        subghz->txrx->hopper_idx_frequency = 0;
-    }
+    uint32_t frequency = subghz_hopper_next(subghz->txrx->hopper);
 
     if(subghz->txrx->txrx_state == SubGhzTxRxStateRx) {
         subghz_rx_end(subghz);
     };
     if(subghz->txrx->txrx_state == SubGhzTxRxStateIDLE) {
         subghz_receiver_reset(subghz->txrx->receiver);
-        subghz->txrx->preset->frequency = subghz_setting_get_hopper_frequency(
-            subghz->setting, subghz->txrx->hopper_idx_frequency);
+        subghz->txrx->preset->frequency = frequency;
         subghz_rx(subghz, subghz->txrx->preset->frequency);
     }
 }
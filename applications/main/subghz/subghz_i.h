@@ -31,6 +31,7 @@
 #include <lib/subghz/transmitter.h>
 
 #include "subghz_history.h"
+#include <lib/subghz/subghz_hopper.h>
 
 #include <gui/modules/variable_item_list.h>
 #include <lib/toolbox/path.h>
@@ -54,8 +55,8 @@ struct SubGhzTxRx {
     SubGhzTxRxState txrx_state;
     SubGhzHopperState hopper_state;
     SubGhzSpeakerState speaker_state;
+    SubGhzHopper* hopper;
     uint8_t hopper_timeout;
-    uint8_t hopper_idx_frequency;
     SubGhzRxKeyState rx_key_state;
 
     float raw_threshold_rssi;
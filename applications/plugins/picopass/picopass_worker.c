@@ -4,6 +4,9 @@
 
 #define TAG "PicopassWorker"
 
+#define PICOPASS_DICT_RING_SIZE 16
+#define PICOPASS_DICT_PROGRESS_INTERVAL 1000
+
 const uint8_t picopass_iclass_key[] = {0xaf, 0xa7, 0x85, 0xa7, 0xda, 0xb3, 0x33, 0x78};
 const uint8_t picopass_factory_key[] = {0x76, 0x65, 0x54, 0x43, 0x32, 0x21, 0x10, 0x00};
 
@@ -67,6 +70,14 @@ void picopass_worker_start(
     furi_thread_start(picopass_worker->thread);
 }
 
+void picopass_worker_get_dict_attack_progress(
+    PicopassWorker* picopass_worker,
+    PicopassDictAttackProgress* progress) {
+    furi_assert(picopass_worker);
+    furi_assert(progress);
+    *progress = picopass_worker->dict_progress;
+}
+
 void picopass_worker_stop(PicopassWorker* picopass_worker) {
     furi_assert(picopass_worker);
     if(picopass_worker->state == PicopassWorkerStateBroken ||
@@ -197,7 +208,49 @@ static ReturnCode picopass_auth_standard(uint8_t* csn, uint8_t* div_key) {
     return rfalPicoPassPollerCheck(mac, &chkRes);
 }
 
+typedef struct {
+    uint8_t key[PICOPASS_BLOCK_LEN];
+    uint8_t div_key[PICOPASS_BLOCK_LEN];
+    bool last;
+} PicopassDictEntry;
+
+typedef struct {
+    IclassEliteDict* dict;
+    uint8_t* csn;
+    FuriMessageQueue* queue;
+    volatile bool run;
+} PicopassDictProducer;
+
+static void picopass_dict_producer_put(PicopassDictProducer* producer, PicopassDictEntry* entry) {
+    while(producer->run) {
+        if(furi_message_queue_put(producer->queue, entry, 100) == FuriStatusOk) break;
+    }
+}
+
+// Reads keys and diversifies them against CSN ahead of RF loop
+static int32_t picopass_dict_producer_task(void* context) {
+    PicopassDictProducer* producer = context;
+    PicopassDictEntry entry = {0};
+
+    while(producer->run && iclass_elite_dict_get_next_key(producer->dict, entry.key)) {
+        loclass_iclass_calc_div_key(producer->csn, entry.key, entry.div_key, true);
+        picopass_dict_producer_put(producer, &entry);
+    }
+
+    entry.last = true;
+    picopass_dict_producer_put(producer, &entry);
+
+    return 0;
+}
+
+static void picopass_worker_dict_progress(PicopassWorker* picopass_worker) {
+    if(picopass_worker->callback) {
+        picopass_worker->callback(PicopassWorkerEventDictAttackProgress, picopass_worker->context);
+    }
+}
+
 static ReturnCode picopass_auth_dict(
+    PicopassWorker* picopass_worker,
     uint8_t* csn,
     PicopassPacs* pacs,
     uint8_t* div_key,
@@ -211,7 +264,7 @@ static ReturnCode picopass_auth_dict(
     uint8_t ccnr[12] = {0};
 
     size_t index = 0;
-    uint8_t key[PICOPASS_BLOCK_LEN] = {0};
+    PicopassDictEntry entry = {0};
 
     if(!iclass_elite_dict_check_presence(dict_type)) {
         FURI_LOG_E(TAG, "Dictionary not found");
@@ -224,20 +277,44 @@ static ReturnCode picopass_auth_dict(
         return ERR_PARAM;
     }
 
-    FURI_LOG_D(TAG, "Loaded %lu keys", iclass_elite_dict_get_total_keys(dict));
-    while(iclass_elite_dict_get_next_key(dict, key)) {
+    PicopassDictAttackProgress* progress = &picopass_worker->dict_progress;
+    memset(progress, 0, sizeof(PicopassDictAttackProgress));
+    progress->keys_total = iclass_elite_dict_get_total_keys(dict);
+    FURI_LOG_D(TAG, "Loaded %lu keys", progress->keys_total);
+    picopass_worker_dict_progress(picopass_worker);
+
+    PicopassDictProducer producer = {
+        .dict = dict,
+        .csn = csn,
+        .queue = furi_message_queue_alloc(PICOPASS_DICT_RING_SIZE, sizeof(PicopassDictEntry)),
+        .run = true,
+    };
+    FuriThread* producer_thread = furi_thread_alloc_ex(
+        "PicopassDictWorker", 2048, picopass_dict_producer_task, &producer);
+    furi_thread_start(producer_thread);
+
+    uint32_t start_tick = furi_get_tick();
+    uint32_t report_tick = start_tick;
+    uint32_t report_keys = 0;
+
+    while(furi_message_queue_get(producer.queue, &entry, FuriWaitForever) == FuriStatusOk) {
+        if(entry.last) {
+            err = ERR_PARAM;
+            break;
+        }
+
         FURI_LOG_D(
             TAG,
             "Try to auth with key %zu %02x%02x%02x%02x%02x%02x%02x%02x",
             index++,
-            key[0],
-            key[1],
-            key[2],
-            key[3],
-            key[4],
-            key[5],
-            key[6],
-            key[7]);
+            entry.key[0],
+            entry.key[1],
+            entry.key[2],
+            entry.key[3],
+            entry.key[4],
+            entry.key[5],
+            entry.key[6],
+            entry.key[7]);
 
         err = rfalPicoPassPollerReadCheck(&rcRes);
         if(err != ERR_NONE) {
@@ -246,22 +323,47 @@ static ReturnCode picopass_auth_dict(
         }
         memcpy(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR)); // last 4 bytes left 0
 
-        loclass_iclass_calc_div_key(csn, key, div_key, true);
-        loclass_opt_doReaderMAC(ccnr, div_key, mac);
+        loclass_opt_doReaderMAC(ccnr, entry.div_key, mac);
 
         err = rfalPicoPassPollerCheck(mac, &chkRes);
+        progress->keys_tried++;
         if(err == ERR_NONE) {
-            memcpy(pacs->key, key, PICOPASS_BLOCK_LEN);
+            memcpy(pacs->key, entry.key, PICOPASS_BLOCK_LEN);
+            memcpy(div_key, entry.div_key, PICOPASS_BLOCK_LEN);
             break;
         }
+
+        uint32_t now = furi_get_tick();
+        if(now - report_tick >= furi_ms_to_ticks(PICOPASS_DICT_PROGRESS_INTERVAL)) {
+            progress->keys_per_sec = (progress->keys_tried - report_keys) *
+                                     furi_kernel_get_tick_frequency() / (now - report_tick);
+            report_tick = now;
+            report_keys = progress->keys_tried;
+            picopass_worker_dict_progress(picopass_worker);
+        }
     }
 
+    producer.run = false;
+    furi_thread_join(producer_thread);
+    furi_thread_free(producer_thread);
+    furi_message_queue_free(producer.queue);
     iclass_elite_dict_free(dict);
 
+    uint32_t elapsed = furi_get_tick() - start_tick;
+    if(elapsed) {
+        FURI_LOG_I(
+            TAG,
+            "Tried %lu keys in %lu ms, %lu keys/s",
+            progress->keys_tried,
+            elapsed * 1000 / furi_kernel_get_tick_frequency(),
+            progress->keys_tried * furi_kernel_get_tick_frequency() / elapsed);
+    }
+
     return err;
 }
 
-ReturnCode picopass_auth(PicopassBlock* AA1, PicopassPacs* pacs) {
+ReturnCode
+    picopass_auth(PicopassWorker* picopass_worker, PicopassBlock* AA1, PicopassPacs* pacs) {
     ReturnCode err;
 
     FURI_LOG_E(TAG, "Trying standard legacy key");
@@ -273,6 +375,7 @@ ReturnCode picopass_auth(PicopassBlock* AA1, PicopassPacs* pacs) {
 
     FURI_LOG_E(TAG, "Starting user dictionary attack");
     err = picopass_auth_dict(
+        picopass_worker,
         AA1[PICOPASS_CSN_BLOCK_INDEX].data,
         pacs,
         AA1[PICOPASS_KD_BLOCK_INDEX].data,
@@ -283,6 +386,7 @@ ReturnCode picopass_auth(PicopassBlock* AA1, PicopassPacs* pacs) {
 
     FURI_LOG_E(TAG, "Starting in-built dictionary attack");
     err = picopass_auth_dict(
+        picopass_worker,
         AA1[PICOPASS_CSN_BLOCK_INDEX].data,
         pacs,
         AA1[PICOPASS_KD_BLOCK_INDEX].data,
@@ -456,7 +560,7 @@ void picopass_worker_detect(PicopassWorker* picopass_worker) {
             }
 
             if(nextState == PicopassWorkerEventSuccess) {
-                err = picopass_auth(AA1, pacs);
+                err = picopass_auth(picopass_worker, AA1, pacs);
                 if(err != ERR_NONE) {
                     FURI_LOG_E(TAG, "picopass_try_auth error %d", err);
                     nextState = PicopassWorkerEventFail;
@@ -27,8 +27,15 @@ typedef enum {
     PicopassWorkerEventSeEnabled,
 
     PicopassWorkerEventStartReading,
+    PicopassWorkerEventDictAttackProgress,
 } PicopassWorkerEvent;
 
+typedef struct {
+    uint32_t keys_total;
+    uint32_t keys_tried;
+    uint32_t keys_per_sec;
+} PicopassDictAttackProgress;
+
 typedef void (*PicopassWorkerCallback)(PicopassWorkerEvent event, void* context);
 
 PicopassWorker* picopass_worker_alloc();
@@ -44,4 +51,8 @@ void picopass_worker_start(
     PicopassWorkerCallback callback,
     void* context);
 
+void picopass_worker_get_dict_attack_progress(
+    PicopassWorker* picopass_worker,
+    PicopassDictAttackProgress* progress);
+
 void picopass_worker_stop(PicopassWorker* picopass_worker);
@@ -23,6 +23,7 @@ struct PicopassWorker {
     void* context;
 
     PicopassWorkerState state;
+    PicopassDictAttackProgress dict_progress;
 };
 
 void picopass_worker_change_state(PicopassWorker* picopass_worker, PicopassWorkerState state);
@@ -2,9 +2,14 @@
 #include <dolphin/dolphin.h>
 
 void picopass_read_card_worker_callback(PicopassWorkerEvent event, void* context) {
-    UNUSED(event);
     Picopass* picopass = context;
-    view_dispatcher_send_custom_event(picopass->view_dispatcher, PicopassCustomEventWorkerExit);
+    if(event == PicopassWorkerEventDictAttackProgress) {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventDictAttackProgress);
+    } else {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventWorkerExit);
+    }
 }
 
 void picopass_scene_read_card_on_enter(void* context) {
@@ -36,6 +41,17 @@ bool picopass_scene_read_card_on_event(void* context, SceneManagerEvent event) {
         if(event.event == PicopassCustomEventWorkerExit) {
             scene_manager_next_scene(picopass->scene_manager, PicopassSceneReadCardSuccess);
             consumed = true;
+        } else if(event.event == PicopassCustomEventDictAttackProgress) {
+            PicopassDictAttackProgress progress;
+            picopass_worker_get_dict_attack_progress(picopass->worker, &progress);
+            picopass_text_store_set(
+                picopass,
+                "Dictionary\n%lu/%lu\n%lu keys/s",
+                progress.keys_tried,
+                progress.keys_total,
+                progress.keys_per_sec);
+            popup_set_header(picopass->popup, picopass->text_store, 68, 30, AlignLeft, AlignTop);
+            consumed = true;
         }
     }
     return consumed;
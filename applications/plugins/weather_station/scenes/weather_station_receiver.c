@@ -65,26 +65,31 @@ void weather_station_scene_receiver_callback(WSCustomEvent event, void* context)
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static void weather_station_scene_receiver_item_callback(
+    uint16_t idx,
+    FuriString* text,
+    uint8_t* type,
+    void* context) {
+    furi_assert(context);
+    WeatherStationApp* app = context;
+    ws_history_get_text_item_menu(app->txrx->history, text, idx);
+    *type = ws_history_get_type_protocol(app->txrx->history, idx);
+}
+
 static void weather_station_scene_receiver_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
     void* context) {
     furi_assert(context);
     WeatherStationApp* app = context;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
 
-    if(ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
-       WSHistoryStateAddKeyNewDada) {
-        furi_string_reset(str_buff);
-
-        ws_history_get_text_item_menu(
-            app->txrx->history, str_buff, ws_history_get_item(app->txrx->history) - 1);
-        ws_view_receiver_add_item_to_menu(
-            app->ws_receiver,
-            furi_string_get_cstr(str_buff),
-            ws_history_get_type_protocol(
-                app->txrx->history, ws_history_get_item(app->txrx->history) - 1));
+    WSHistoryStateAddKey state =
+        ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset);
+    if(state == WSHistoryStateAddKeyUpdateData) {
+        // Menu text is kept in history, just redraw
+        ws_view_receiver_set_item_count(app->ws_receiver, ws_history_get_item(app->txrx->history));
+    } else if(state == WSHistoryStateAddKeyNewDada) {
+        ws_view_receiver_set_item_count(app->ws_receiver, ws_history_get_item(app->txrx->history));
 
         weather_station_scene_receiver_update_statusbar(app);
         notification_message(app->notifications, &sequence_blink_green_10);
@@ -95,16 +100,14 @@ static void weather_station_scene_receiver_add_to_history_callback(
         }
     }
     subghz_receiver_reset(receiver);
-    furi_string_free(str_buff);
     app->txrx->rx_key_state = WSRxKeyStateAddKey;
+    // Called from worker thread, hopper is updated on tick
+    app->txrx->hopper_key_received = true;
 }
 
 void weather_station_scene_receiver_on_enter(void* context) {
     WeatherStationApp* app = context;
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(app->txrx->rx_key_state == WSRxKeyStateIDLE) {
         ws_preset_init(app, "AM650", subghz_setting_get_default_frequency(app->setting), NULL, 0);
         ws_history_reset(app->txrx->history);
@@ -113,18 +116,14 @@ void weather_station_scene_receiver_on_enter(void* context) {
 
     ws_view_receiver_set_lock(app->ws_receiver, app->lock);
 
-    //Load history to receiver
+    //Load history to receiver, items are read by view on demand
     ws_view_receiver_exit(app->ws_receiver);
-    for(uint8_t i = 0; i < ws_history_get_item(app->txrx->history); i++) {
-        furi_string_reset(str_buff);
-        ws_history_get_text_item_menu(app->txrx->history, str_buff, i);
-        ws_view_receiver_add_item_to_menu(
-            app->ws_receiver,
-            furi_string_get_cstr(str_buff),
-            ws_history_get_type_protocol(app->txrx->history, i));
+    ws_view_receiver_set_item_callback(
+        app->ws_receiver, weather_station_scene_receiver_item_callback, app);
+    ws_view_receiver_set_item_count(app->ws_receiver, ws_history_get_item(app->txrx->history));
+    if(ws_history_get_item(app->txrx->history)) {
         app->txrx->rx_key_state = WSRxKeyStateAddKey;
     }
-    furi_string_free(str_buff);
     weather_station_scene_receiver_update_statusbar(app);
 
     ws_view_receiver_set_callback(app->ws_receiver, weather_station_scene_receiver_callback, app);
@@ -191,7 +190,13 @@ bool weather_station_scene_receiver_on_event(void* context, SceneManagerEvent ev
             break;
         }
     } else if(event.type == SceneManagerEventTypeTick) {
+        ws_history_flush(app->txrx->history);
         if(app->txrx->hopper_state != WSHopperStateOFF) {
+            if(app->txrx->hopper_key_received) {
+                // Credit the key to current frequency before hopper moves on
+                app->txrx->hopper_key_received = false;
+                subghz_hopper_key_received(app->txrx->hopper);
+            }
             ws_hopper_update(app);
             weather_station_scene_receiver_update_statusbar(app);
         }
@@ -133,6 +133,10 @@ static void weather_station_scene_receiver_config_set_hopping_running(VariableIt
             subghz_setting_get_frequency_default_index(app->setting));
     }
 
+    if((app->txrx->hopper_state == WSHopperStateOFF) &&
+       (hopping_value[index] != WSHopperStateOFF)) {
+        subghz_hopper_reset(app->txrx->hopper);
+    }
     app->txrx->hopper_state = hopping_value[index];
 }
 
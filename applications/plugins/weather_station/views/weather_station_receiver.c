@@ -5,28 +5,12 @@
 
 #include <input/input.h>
 #include <gui/elements.h>
-#include <m-array.h>
 
 #define FRAME_HEIGHT 12
 #define MAX_LEN_PX 112
 #define MENU_ITEMS 4u
 #define UNLOCK_CNT 3
 
-typedef struct {
-    FuriString* item_str;
-    uint8_t type;
-} WSReceiverMenuItem;
-
-ARRAY_DEF(WSReceiverMenuItemArray, WSReceiverMenuItem, M_POD_OPLIST)
-
-#define M_OPL_WSReceiverMenuItemArray_t() ARRAY_OPLIST(WSReceiverMenuItemArray, M_POD_OPLIST)
-
-struct WSReceiverHistory {
-    WSReceiverMenuItemArray_t data;
-};
-
-typedef struct WSReceiverHistory WSReceiverHistory;
-
 static const Icon* ReceiverItemIcons[] = {
     [SubGhzProtocolTypeUnknown] = &I_Quest_7x8,
     [SubGhzProtocolTypeStatic] = &I_Unlock_7x8,
@@ -48,13 +32,16 @@ struct WSReceiver {
     View* view;
     WSReceiverCallback callback;
     void* context;
+    WSReceiverItemCallback item_callback;
+    void* item_context;
 };
 
 typedef struct {
     FuriString* frequency_str;
     FuriString* preset_str;
     FuriString* history_stat_str;
-    WSReceiverHistory* history;
+    FuriString* item_str;
+    WSReceiver* receiver;
     uint16_t idx;
     uint16_t list_offset;
     uint16_t history_item;
@@ -113,21 +100,32 @@ static void ws_view_receiver_update_offset(WSReceiver* ws_receiver) {
         true);
 }
 
-void ws_view_receiver_add_item_to_menu(WSReceiver* ws_receiver, const char* name, uint8_t type) {
+void ws_view_receiver_set_item_callback(
+    WSReceiver* ws_receiver,
+    WSReceiverItemCallback callback,
+    void* context) {
+    furi_assert(ws_receiver);
+    furi_assert(callback);
+    ws_receiver->item_callback = callback;
+    ws_receiver->item_context = context;
+}
+
+void ws_view_receiver_set_item_count(WSReceiver* ws_receiver, uint16_t count) {
     furi_assert(ws_receiver);
     with_view_model(
         ws_receiver->view,
         WSReceiverModel * model,
         {
-            WSReceiverMenuItem* item_menu = WSReceiverMenuItemArray_push_raw(model->history->data);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
-            if((model->idx == model->history_item - 1)) {
-                model->history_item++;
-                model->idx++;
-            } else {
-                model->history_item++;
+            if(count == 0) {
+                model->idx = 0;
+                model->list_offset = 0;
+            } else if((model->history_item != 0) && (model->idx == model->history_item - 1)) {
+                // Keep cursor on the newest item
+                model->idx = count - 1;
+            } else if(model->idx >= count) {
+                model->idx = count - 1;
             }
+            model->history_item = count;
         },
         true);
     ws_view_receiver_update_offset(ws_receiver);
@@ -173,29 +171,30 @@ void ws_view_receiver_draw(Canvas* canvas, WSReceiverModel* model) {
     canvas_draw_line(canvas, 46, 51, 125, 51);
 
     bool scrollbar = model->history_item > 4;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
-    WSReceiverMenuItem* item_menu;
+    FuriString* str_buff = model->item_str;
+    WSReceiver* ws_receiver = model->receiver;
 
     for(size_t i = 0; i < MIN(model->history_item, MENU_ITEMS); ++i) {
         size_t idx = CLAMP((uint16_t)(i + model->list_offset), model->history_item, 0);
-        item_menu = WSReceiverMenuItemArray_get(model->history->data, idx);
-        furi_string_set(str_buff, item_menu->item_str);
+        uint8_t type = SubGhzProtocolTypeUnknown;
+        // Items are taken from history on demand, only visible page is read
+        if(ws_receiver->item_callback) {
+            ws_receiver->item_callback(idx, str_buff, &type, ws_receiver->item_context);
+        }
+        if(type >= COUNT_OF(ReceiverItemIcons)) type = SubGhzProtocolTypeUnknown;
         elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
         if(model->idx == idx) {
             ws_view_receiver_draw_frame(canvas, i, scrollbar);
         } else {
             canvas_set_color(canvas, ColorBlack);
         }
-        canvas_draw_icon(canvas, 4, 2 + i * FRAME_HEIGHT, ReceiverItemIcons[item_menu->type]);
+        canvas_draw_icon(canvas, 4, 2 + i * FRAME_HEIGHT, ReceiverItemIcons[type]);
         canvas_draw_str(canvas, 14, 9 + i * FRAME_HEIGHT, furi_string_get_cstr(str_buff));
         furi_string_reset(str_buff);
     }
     if(scrollbar) {
         elements_scrollbar_pos(canvas, 128, 0, 49, model->idx, model->history_item);
     }
-    furi_string_free(str_buff);
 
     canvas_set_color(canvas, ColorBlack);
 
@@ -339,15 +338,9 @@ void ws_view_receiver_exit(void* context) {
             furi_string_reset(model->frequency_str);
             furi_string_reset(model->preset_str);
             furi_string_reset(model->history_stat_str);
-                for
-                    M_EACH(item_menu, model->history->data, WSReceiverMenuItemArray_t) {
-                        furi_string_free(item_menu->item_str);
-                        item_menu->type = 0;
-                    }
-                WSReceiverMenuItemArray_reset(model->history->data);
-                model->idx = 0;
-                model->list_offset = 0;
-                model->history_item = 0;
+            model->idx = 0;
+            model->list_offset = 0;
+            model->history_item = 0;
         },
         false);
     furi_timer_stop(ws_receiver->timer);
@@ -375,9 +368,9 @@ WSReceiver* ws_view_receiver_alloc() {
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
+            model->item_str = furi_string_alloc();
+            model->receiver = ws_receiver;
             model->bar_show = WSReceiverBarShowDefault;
-            model->history = malloc(sizeof(WSReceiverHistory));
-            WSReceiverMenuItemArray_init(model->history->data);
         },
         true);
     ws_receiver->timer =
@@ -395,13 +388,7 @@ void ws_view_receiver_free(WSReceiver* ws_receiver) {
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
-                for
-                    M_EACH(item_menu, model->history->data, WSReceiverMenuItemArray_t) {
-                        furi_string_free(item_menu->item_str);
-                        item_menu->type = 0;
-                    }
-                WSReceiverMenuItemArray_clear(model->history->data);
-                free(model->history);
+            furi_string_free(model->item_str);
         },
         false);
     furi_timer_free(ws_receiver->timer);
@@ -8,6 +8,12 @@ typedef struct WSReceiver WSReceiver;
 
 typedef void (*WSReceiverCallback)(WSCustomEvent event, void* context);
 
+typedef void (*WSReceiverItemCallback)(
+    uint16_t idx,
+    FuriString* text,
+    uint8_t* type,
+    void* context);
+
 void ws_view_receiver_set_lock(WSReceiver* ws_receiver, WSLock keyboard);
 
 void ws_view_receiver_set_callback(
@@ -27,7 +33,12 @@ void ws_view_receiver_add_data_statusbar(
     const char* preset_str,
     const char* history_stat_str);
 
-void ws_view_receiver_add_item_to_menu(WSReceiver* ws_receiver, const char* name, uint8_t type);
+void ws_view_receiver_set_item_callback(
+    WSReceiver* ws_receiver,
+    WSReceiverItemCallback callback,
+    void* context);
+
+void ws_view_receiver_set_item_count(WSReceiver* ws_receiver, uint16_t count);
 
 uint16_t ws_view_receiver_get_idx_menu(WSReceiver* ws_receiver);
 
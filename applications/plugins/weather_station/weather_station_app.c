@@ -91,6 +91,7 @@ WeatherStationApp* weather_station_app_alloc() {
     ws_preset_init(app, "AM650", subghz_setting_get_default_frequency(app->setting), NULL, 0);
 
     app->txrx->hopper_state = WSHopperStateOFF;
+    app->txrx->hopper = subghz_hopper_alloc(app->setting);
     app->txrx->history = ws_history_alloc();
     app->txrx->worker = subghz_worker_alloc();
     app->txrx->environment = subghz_environment_alloc();
@@ -139,6 +140,7 @@ void weather_station_app_free(WeatherStationApp* app) {
     ws_view_receiver_info_free(app->ws_receiver_info);
 
     //setting
+    subghz_hopper_free(app->txrx->hopper);
     subghz_setting_free(app->setting);
 
     //Worker & Protocol & History
@@ -116,6 +116,7 @@ void ws_hopper_update(WeatherStationApp* app) {
     case WSHopperStateRSSITimeOut:
         if(app->txrx->hopper_timeout != 0) {
             app->txrx->hopper_timeout--;
+            subghz_hopper_dwell_tick(app->txrx->hopper);
             return;
         }
         break;
@@ -127,9 +128,10 @@ void ws_hopper_update(WeatherStationApp* app) {
         // See RSSI Calculation timings in CC1101 17.3 RSSI
         rssi = furi_hal_subghz_get_rssi();
 
-        // Stay if RSSI is high enough
-        if(rssi > -90.0f) {
-            app->txrx->hopper_timeout = 10;
+        // Stay if RSSI is high enough, hopper decides for how long
+        uint8_t dwell = subghz_hopper_rssi(app->txrx->hopper, rssi);
+        if(dwell) {
+            app->txrx->hopper_timeout = dwell;
             app->txrx->hopper_state = WSHopperStateRSSITimeOut;
             return;
         }
@@ -137,20 +139,14 @@ void ws_hopper_update(WeatherStationApp* app) {
         app->txrx->hopper_state = WSHopperStateRunnig;
     }
     // Select next frequency
-    if(app->txrx->hopper_idx_frequency <
-       subghz_setting_get_hopper_frequency_count(app->setting) - 1) {
-        app->txrx->hopper_idx_frequency++;
-    } else {
-        app->txrx->hopper_idx_frequency = 0;
-    }
+    uint32_t frequency = subghz_hopper_next(app->txrx->hopper);
 
     if(app->txrx->txrx_state == WSTxRxStateRx) {
         ws_rx_end(app);
     };
     if(app->txrx->txrx_state == WSTxRxStateIDLE) {
         subghz_receiver_reset(app->txrx->receiver);
-        app->txrx->preset->frequency =
-            subghz_setting_get_hopper_frequency(app->setting, app->txrx->hopper_idx_frequency);
+        app->txrx->preset->frequency = frequency;
         ws_rx(app, app->txrx->preset->frequency);
     }
 }
@@ -15,6 +15,7 @@
 #include "weather_station_history.h"
 
 #include <lib/subghz/subghz_setting.h>
+#include <lib/subghz/subghz_hopper.h>
 #include <lib/subghz/subghz_worker.h>
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
@@ -32,8 +33,9 @@ struct WeatherStationTxRx {
     uint16_t idx_menu_chosen;
     WSTxRxState txrx_state;
     WSHopperState hopper_state;
+    SubGhzHopper* hopper;
     uint8_t hopper_timeout;
-    uint8_t hopper_idx_frequency;
+    volatile bool hopper_key_received;
     WSRxKeyState rx_key_state;
 };
 
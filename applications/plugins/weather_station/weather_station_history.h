@@ -36,6 +36,12 @@ void ws_history_free(WSHistory* instance);
  */
 void ws_history_reset(WSHistory* instance);
 
+/** Move older records to SD-card, call periodically from app thread
+ * 
+ * @param instance - WSHistory instance
+ */
+void ws_history_flush(WSHistory* instance);
+
 /** Get frequency to history[idx]
  * 
  * @param instance  - WSHistory instance
@@ -94,6 +100,7 @@ void ws_history_get_text_item_menu(WSHistory* instance, FuriString* output, uint
 bool ws_history_get_text_space_left(WSHistory* instance, FuriString* output);
 
 /** Add protocol to history
+ * Sensor is updated in place only while its record is kept in RAM
  * 
  * @param instance  - WSHistory instance
  * @param context    - SubGhzProtocolCommon context
@@ -107,6 +114,6 @@ WSHistoryStateAddKey
  * 
  * @param instance  - WSHistory instance
  * @param idx       - record index
- * @return SubGhzProtocolCommonLoad*
+ * @return SubGhzProtocolCommonLoad*, valid until next call
  */
 FlipperFormat* ws_history_get_raw_data(WSHistory* instance, uint16_t idx);
@@ -0,0 +1,308 @@
+#include "cli_command_profiler.h"
+
+#include <furi.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lib/toolbox/args.h>
+#include <lib/toolbox/profiler.h>
+
+#define CLI_PROFILER_FREQUENCY_DEFAULT 1000
+#define CLI_PROFILER_FREQUENCY_MIN 10
+#define CLI_PROFILER_FREQUENCY_MAX 10000
+#define CLI_PROFILER_SAMPLES_DEFAULT 2048
+#define CLI_PROFILER_TOP_PERIOD_MS 1000
+#define CLI_PROFILER_THREADS_MAX 32
+
+typedef struct {
+    FuriThreadId id;
+    const char* name;
+    size_t samples;
+    uint32_t hot_pc;
+    size_t hot_pc_samples;
+} CliProfilerThread;
+
+typedef struct {
+    CliProfilerThread threads[CLI_PROFILER_THREADS_MAX];
+    size_t thread_count;
+    size_t isr_samples;
+    size_t total;
+} CliProfilerReport;
+
+void cli_command_profiler_print_usage() {
+    printf("Usage:\r\n");
+    printf("profiler <cmd> <args>\r\n");
+    printf("Cmd list:\r\n");
+    printf("\ttop [frequency]\t - Show CPU usage per thread every second\r\n");
+    printf("\tstart [frequency] [samples]\t - Start collecting samples\r\n");
+    printf("\tstop\t - Stop collecting samples\r\n");
+    printf("\tdump\t - Stop and print collected samples for scripts/profiler.py\r\n");
+    printf("Samples due in critical sections are taken on exit from them\r\n");
+}
+
+static bool cli_command_profiler_read_arg(FuriString* args, int* value, int default_value) {
+    if(furi_string_empty(args)) {
+        *value = default_value;
+        return true;
+    }
+    return args_read_int_and_trim(args, value) && *value > 0;
+}
+
+static bool cli_command_profiler_read_frequency(FuriString* args, int* frequency) {
+    return cli_command_profiler_read_arg(args, frequency, CLI_PROFILER_FREQUENCY_DEFAULT) &&
+           *frequency >= CLI_PROFILER_FREQUENCY_MIN && *frequency <= CLI_PROFILER_FREQUENCY_MAX;
+}
+
+static bool cli_command_profiler_check_memory(size_t sample_count) {
+    if(sample_count * sizeof(ProfilerSample) >= memmgr_heap_get_max_free_block()) {
+        printf("Not enough memory for %zu samples\r\n", sample_count);
+        return false;
+    }
+    return true;
+}
+
+static int cli_command_profiler_sample_cmp(const void* a, const void* b) {
+    const ProfilerSample* sample_a = a;
+    const ProfilerSample* sample_b = b;
+
+    if(sample_a->thread != sample_b->thread) {
+        return (uintptr_t)sample_a->thread < (uintptr_t)sample_b->thread ? -1 : 1;
+    }
+    if(sample_a->pc != sample_b->pc) {
+        return sample_a->pc < sample_b->pc ? -1 : 1;
+    }
+    return 0;
+}
+
+static int cli_command_profiler_thread_cmp(const void* a, const void* b) {
+    const CliProfilerThread* thread_a = a;
+    const CliProfilerThread* thread_b = b;
+
+    if(thread_a->samples != thread_b->samples) {
+        return thread_a->samples > thread_b->samples ? -1 : 1;
+    }
+    return 0;
+}
+
+/* Thread may exit before report, so only names of live threads are used */
+static const char* cli_command_profiler_thread_name(
+    FuriThreadId thread_id,
+    const FuriThreadId* live_ids,
+    size_t live_count) {
+    for(size_t i = 0; i < live_count; i++) {
+        if(live_ids[i] == thread_id) {
+            return furi_thread_get_name(thread_id);
+        }
+    }
+    return "<exited>";
+}
+
+/* Sorts samples by thread and address */
+static void cli_command_profiler_build_report(
+    CliProfilerReport* report,
+    ProfilerSample* samples,
+    size_t count) {
+    memset(report, 0, sizeof(CliProfilerReport));
+    report->total = count;
+    if(!samples) return;
+
+    qsort(samples, count, sizeof(ProfilerSample), cli_command_profiler_sample_cmp);
+
+    FuriThreadId live_ids[CLI_PROFILER_THREADS_MAX];
+    size_t live_count = furi_thread_enumerate(live_ids, CLI_PROFILER_THREADS_MAX);
+
+    CliProfilerThread* thread = NULL;
+    size_t run = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(samples[i].pc == 0) {
+            report->isr_samples++;
+            continue;
+        }
+
+        if(!thread || thread->id != samples[i].thread) {
+            if(report->thread_count == CLI_PROFILER_THREADS_MAX) break;
+            thread = &report->threads[report->thread_count++];
+            thread->id = samples[i].thread;
+            thread->name =
+                cli_command_profiler_thread_name(samples[i].thread, live_ids, live_count);
+            run = 0;
+        }
+
+        thread->samples++;
+        if(run && samples[i].pc == samples[i - 1].pc) {
+            run++;
+        } else {
+            run = 1;
+        }
+        if(run > thread->hot_pc_samples) {
+            thread->hot_pc = samples[i].pc;
+            thread->hot_pc_samples = run;
+        }
+    }
+
+    qsort(
+        report->threads,
+        report->thread_count,
+        sizeof(CliProfilerThread),
+        cli_command_profiler_thread_cmp);
+}
+
+static void cli_command_profiler_print_report(const CliProfilerReport* report) {
+    if(!report->total) {
+        printf("No samples\r\n");
+        return;
+    }
+
+    printf("%-20s %-8s %-7s %-12s %s\r\n", "Thread", "Samples", "CPU", "Hot address", "Hits");
+    for(size_t i = 0; i < report->thread_count; i++) {
+        const CliProfilerThread* thread = &report->threads[i];
+        printf(
+            "%-20s %-8zu %5.1f%%  0x%08lX   %zu\r\n",
+            thread->name,
+            thread->samples,
+            (double)thread->samples * 100.0 / (double)report->total,
+            thread->hot_pc,
+            thread->hot_pc_samples);
+    }
+    printf(
+        "%-20s %-8zu %5.1f%%\r\n",
+        "[interrupts]",
+        report->isr_samples,
+        (double)report->isr_samples * 100.0 / (double)report->total);
+}
+
+static void cli_command_profiler_top(Cli* cli, FuriString* args) {
+    int frequency;
+    if(!cli_command_profiler_read_frequency(args, &frequency)) {
+        cli_print_usage("profiler top", "[frequency]", furi_string_get_cstr(args));
+        return;
+    }
+    if(profiler_sampling_is_running()) {
+        printf("Sampling is already running, stop it first\r\n");
+        return;
+    }
+
+    // Extra 10% for delay jitter
+    size_t sample_count = frequency * CLI_PROFILER_TOP_PERIOD_MS / 1000 * 11 / 10;
+    if(!cli_command_profiler_check_memory(sample_count)) {
+        return;
+    }
+
+    CliProfilerReport* report = malloc(sizeof(CliProfilerReport));
+
+    printf("Press Ctrl+C to stop\r\n");
+    while(!cli_cmd_interrupt_received(cli)) {
+        profiler_sampling_start(frequency, sample_count);
+        furi_delay_ms(CLI_PROFILER_TOP_PERIOD_MS);
+        profiler_sampling_stop();
+
+        size_t count;
+        ProfilerSample* samples = profiler_sampling_get_samples(&count, NULL);
+        cli_command_profiler_build_report(report, samples, count);
+        printf("\r\n");
+        cli_command_profiler_print_report(report);
+    }
+
+    profiler_sampling_free();
+    free(report);
+}
+
+static void cli_command_profiler_start(FuriString* args) {
+    int frequency;
+    int sample_count;
+    if(!cli_command_profiler_read_frequency(args, &frequency) ||
+       !cli_command_profiler_read_arg(args, &sample_count, CLI_PROFILER_SAMPLES_DEFAULT)) {
+        cli_print_usage("profiler start", "[frequency] [samples]", furi_string_get_cstr(args));
+        return;
+    }
+    if(profiler_sampling_is_running()) {
+        printf("Sampling is already running\r\n");
+        return;
+    }
+    if(!cli_command_profiler_check_memory(sample_count)) {
+        return;
+    }
+
+    profiler_sampling_start(frequency, sample_count);
+    printf("Sampling at %d Hz into %d samples buffer\r\n", frequency, sample_count);
+}
+
+static void cli_command_profiler_stop() {
+    if(profiler_sampling_is_running()) {
+        profiler_sampling_stop();
+    }
+
+    size_t count;
+    size_t dropped;
+    profiler_sampling_get_samples(&count, &dropped);
+    printf("Collected %zu samples, %zu dropped\r\n", count, dropped);
+}
+
+/* One line per thread and address: "<address> <samples> <thread name>" */
+static void cli_command_profiler_dump() {
+    if(profiler_sampling_is_running()) {
+        profiler_sampling_stop();
+    }
+
+    size_t count;
+    size_t dropped;
+    ProfilerSample* samples = profiler_sampling_get_samples(&count, &dropped);
+    printf("# samples %zu dropped %zu\r\n", count, dropped);
+    if(!samples) return;
+
+    qsort(samples, count, sizeof(ProfilerSample), cli_command_profiler_sample_cmp);
+
+    FuriThreadId live_ids[CLI_PROFILER_THREADS_MAX];
+    size_t live_count = furi_thread_enumerate(live_ids, CLI_PROFILER_THREADS_MAX);
+
+    size_t run = 1;
+    for(size_t i = 0; i < count; i++) {
+        if(i + 1 < count && !cli_command_profiler_sample_cmp(&samples[i], &samples[i + 1])) {
+            run++;
+            continue;
+        }
+
+        const char* name =
+            samples[i].pc ?
+                cli_command_profiler_thread_name(samples[i].thread, live_ids, live_count) :
+                "[interrupts]";
+        printf("0x%08lX %zu %s\r\n", samples[i].pc, run, name);
+        run = 1;
+    }
+}
+
+void cli_command_profiler(Cli* cli, FuriString* args, void* context) {
+    UNUSED(context);
+    FuriString* cmd;
+    cmd = furi_string_alloc();
+
+    do {
+        if(!args_read_string_and_trim(args, cmd)) {
+            cli_command_profiler_print_usage();
+            break;
+        }
+
+        if(furi_string_cmp_str(cmd, "top") == 0) {
+            cli_command_profiler_top(cli, args);
+            break;
+        }
+
+        if(furi_string_cmp_str(cmd, "start") == 0) {
+            cli_command_profiler_start(args);
+            break;
+        }
+
+        if(furi_string_cmp_str(cmd, "stop") == 0) {
+            cli_command_profiler_stop();
+            break;
+        }
+
+        if(furi_string_cmp_str(cmd, "dump") == 0) {
+            cli_command_profiler_dump();
+            break;
+        }
+
+        cli_command_profiler_print_usage();
+    } while(false);
+
+    furi_string_free(cmd);
+}
@@ -1,5 +1,6 @@
 #include "cli_commands.h"
 #include "cli_command_gpio.h"
+#include "cli_command_profiler.h"
 
 #include <furi_hal.h>
 #include <furi_hal_info.h>
@@ -8,6 +9,7 @@
 #include <notification/notification_messages.h>
 #include <loader/loader.h>
 #include <lib/toolbox/args.h>
+#include <lib/toolbox/cpu_load.h>
 
 // Close to ISO, `date +'%Y-%m-%d %H:%M:%S %u'`
 #define CLI_DATE_FORMAT "%.4d-%.2d-%.2d %.2d:%.2d:%.2d %d"
@@ -163,8 +165,18 @@ void cli_command_log_level_set_from_string(FuriString* level) {
     }
 }
 
+void cli_command_log_dump_puts(const char* data) {
+    printf("%s", data);
+}
+
 void cli_command_log(Cli* cli, FuriString* args, void* context) {
     UNUSED(context);
+    if(!furi_string_cmp(args, "dump")) {
+        // Records kept in log ring, including ones printed before
+        furi_log_dump(cli_command_log_dump_puts);
+        return;
+    }
+
     FuriStreamBuffer* ring = furi_stream_buffer_alloc(CLI_COMMAND_LOG_RING_SIZE, 1);
     uint8_t buffer[CLI_COMMAND_LOG_BUFFER_SIZE];
     FuriLogLevel previous_level = furi_log_get_level();
@@ -341,6 +353,22 @@ void cli_command_led(Cli* cli, FuriString* args, void* context) {
     furi_record_close(RECORD_NOTIFICATION);
 }
 
+void cli_command_notification_stats(Cli* cli, FuriString* args, void* context) {
+    UNUSED(cli);
+    UNUSED(args);
+    UNUSED(context);
+
+    NotificationStats stats;
+    NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
+    notification_get_stats(notification, &stats);
+    furi_record_close(RECORD_NOTIFICATION);
+
+    printf("Processed: %lu\r\n", stats.processed);
+    printf("Preempted: %lu\r\n", stats.preempted);
+    printf("Queue latency avg: %lums\r\n", stats.latency_avg_ms);
+    printf("Queue latency max: %lums\r\n", stats.latency_max_ms);
+}
+
 void cli_command_ps(Cli* cli, FuriString* args, void* context) {
     UNUSED(cli);
     UNUSED(args);
@@ -350,20 +378,86 @@ void cli_command_ps(Cli* cli, FuriString* args, void* context) {
     FuriThreadId threads_ids[threads_num_max];
     uint8_t thread_num = furi_thread_enumerate(threads_ids, threads_num_max);
     printf(
-        "%-20s %-14s %-8s %-8s %s\r\n", "Name", "Stack start", "Heap", "Stack", "Stack min free");
+        "%-20s %-14s %-8s %-8s %-14s %s\r\n",
+        "Name",
+        "Stack start",
+        "Heap",
+        "Stack",
+        "Stack min free",
+        "CPU ms");
     for(uint8_t i = 0; i < thread_num; i++) {
         TaskControlBlock* tcb = (TaskControlBlock*)threads_ids[i];
         printf(
-            "%-20s 0x%-12lx %-8zu %-8lu %-8lu\r\n",
+            "%-20s 0x%-12lx %-8zu %-8lu %-14lu %lu\r\n",
             furi_thread_get_name(threads_ids[i]),
             (uint32_t)tcb->pxStack,
             memmgr_heap_get_thread_memory(threads_ids[i]),
             (uint32_t)(tcb->pxEndOfStack - tcb->pxStack + 1) * sizeof(StackType_t),
-            furi_thread_get_stack_space(threads_ids[i]));
+            furi_thread_get_stack_space(threads_ids[i]),
+            (uint32_t)(furi_thread_get_run_time(threads_ids[i]) / 1000));
     }
     printf("\r\nTotal: %d", thread_num);
 }
 
+#define CLI_COMMAND_TOP_PERIOD_DEFAULT 1000
+#define CLI_COMMAND_TOP_PERIOD_MIN 100
+#define CLI_COMMAND_TOP_PERIOD_MAX 10000
+#define CLI_COMMAND_TOP_POLL_MS 50
+
+static void cli_command_top_print(CpuLoad* cpu_load) {
+    printf("\r\n%-20s %-10s %s\r\n", "Name", "Time ms", "CPU");
+    for(size_t i = 0; i < cpu_load_get_thread_count(cpu_load); i++) {
+        const CpuLoadThread* thread = cpu_load_get_thread(cpu_load, i);
+        printf(
+            "%-20s %-10lu %5.1f%%\r\n",
+            thread->name,
+            (uint32_t)(thread->delta / 1000),
+            (double)cpu_load_get_percent(cpu_load, thread->delta));
+    }
+
+    uint64_t idle = cpu_load_get_idle_time(cpu_load);
+    uint64_t isr = cpu_load_get_isr_time(cpu_load);
+    printf(
+        "%-20s %-10lu %5.1f%%\r\n",
+        "[idle]",
+        (uint32_t)(idle / 1000),
+        (double)cpu_load_get_percent(cpu_load, idle));
+    printf(
+        "%-20s %-10lu %5.1f%%\r\n",
+        "[interrupts]",
+        (uint32_t)(isr / 1000),
+        (double)cpu_load_get_percent(cpu_load, isr));
+}
+
+void cli_command_top(Cli* cli, FuriString* args, void* context) {
+    UNUSED(context);
+
+    int period = CLI_COMMAND_TOP_PERIOD_DEFAULT;
+    if(!furi_string_empty(args) &&
+       (!args_read_int_and_trim(args, &period) || period < CLI_COMMAND_TOP_PERIOD_MIN ||
+        period > CLI_COMMAND_TOP_PERIOD_MAX)) {
+        cli_print_usage("top", "[period_ms 100-10000]", furi_string_get_cstr(args));
+        return;
+    }
+
+    CpuLoad* cpu_load = cpu_load_alloc();
+    cpu_load_update(cpu_load);
+
+    printf("Thread time includes interrupts it was preempted by\r\n");
+    printf("Press CTRL+C to stop...\r\n");
+    uint32_t start = furi_get_tick();
+    while(!cli_cmd_interrupt_received(cli)) {
+        furi_delay_ms(CLI_COMMAND_TOP_POLL_MS);
+        if(furi_get_tick() - start < furi_ms_to_ticks(period)) continue;
+
+        start = furi_get_tick();
+        cpu_load_update(cpu_load);
+        cli_command_top_print(cpu_load);
+    }
+
+    cpu_load_free(cpu_load);
+}
+
 void cli_command_free(Cli* cli, FuriString* args, void* context) {
     UNUSED(cli);
     UNUSED(args);
@@ -420,11 +514,19 @@ void cli_commands_init(Cli* cli) {
     cli_add_command(cli, "log", CliCommandFlagParallelSafe, cli_command_log, NULL);
     cli_add_command(cli, "sysctl", CliCommandFlagDefault, cli_command_sysctl, NULL);
     cli_add_command(cli, "ps", CliCommandFlagParallelSafe, cli_command_ps, NULL);
+    cli_add_command(cli, "top", CliCommandFlagParallelSafe, cli_command_top, NULL);
     cli_add_command(cli, "free", CliCommandFlagParallelSafe, cli_command_free, NULL);
     cli_add_command(cli, "free_blocks", CliCommandFlagParallelSafe, cli_command_free_blocks, NULL);
+    cli_add_command(cli, "profiler", CliCommandFlagParallelSafe, cli_command_profiler, NULL);
 
     cli_add_command(cli, "vibro", CliCommandFlagDefault, cli_command_vibro, NULL);
     cli_add_command(cli, "led", CliCommandFlagDefault, cli_command_led, NULL);
+    cli_add_command(
+        cli,
+        "notification_stats",
+        CliCommandFlagParallelSafe,
+        cli_command_notification_stats,
+        NULL);
     cli_add_command(cli, "gpio", CliCommandFlagDefault, cli_command_gpio, NULL);
     cli_add_command(cli, "i2c", CliCommandFlagDefault, cli_command_i2c, NULL);
 }
@@ -0,0 +1,443 @@
+#include "animation_frame_stream.h"
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#define TAG "AnimationFrameStream"
+
+#define ANIMATION_BUNDLE_FILE "frames.bin"
+#define ANIMATION_BUNDLE_MAGIC 0x4c444e42
+#define ANIMATION_BUNDLE_MAX_SUPPORTED_VERSION 1
+
+#define ANIMATION_FRAME_STREAM_STACK_SIZE 1024
+#define ANIMATION_FRAME_NONE (-1)
+
+typedef enum {
+    AnimationFrameStreamEventRequest = (1 << 0),
+    AnimationFrameStreamEventStop = (1 << 1),
+} AnimationFrameStreamEvent;
+
+#define ANIMATION_FRAME_STREAM_EVENTS_ALL \
+    (AnimationFrameStreamEventRequest | AnimationFrameStreamEventStop)
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t width;
+    uint8_t height;
+    uint8_t frame_count;
+} AnimationBundleHeader;
+_Static_assert(sizeof(AnimationBundleHeader) == 8, "Incorrect AnimationBundleHeader size");
+
+typedef struct {
+    uint32_t offset;
+    uint16_t size;
+} AnimationBundleFrame;
+_Static_assert(sizeof(AnimationBundleFrame) == 6, "Incorrect AnimationBundleFrame size");
+
+#pragma pack(pop)
+
+typedef struct {
+    uint8_t* data;
+    int16_t frame;
+    bool loading;
+    uint32_t last_used;
+} AnimationFrameSlot;
+
+struct AnimationFrameStream {
+    Storage* storage;
+    FuriString* directory;
+    FuriString* path;
+    File* bundle;
+    AnimationBundleFrame* bundle_frames;
+    size_t max_frame_size;
+    uint8_t frame_count;
+
+    /* guards slots and wanted frames */
+    FuriMutex* mutex;
+    /* serializes storage access between worker and direct reads */
+    FuriMutex* io_mutex;
+    AnimationFrameSlot slots[ANIMATION_FRAME_STREAM_CACHE_SIZE];
+    uint8_t slot_count;
+    int8_t shown_slot;
+    uint32_t use_counter;
+    uint8_t wanted[ANIMATION_FRAME_STREAM_CACHE_SIZE];
+    uint8_t wanted_count;
+
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t loads;
+
+    FuriThread* thread;
+};
+
+static bool animation_frame_stream_open_bundle(
+    AnimationFrameStream* stream,
+    uint8_t width,
+    uint8_t height) {
+    furi_string_printf(
+        stream->path, "%s/" ANIMATION_BUNDLE_FILE, furi_string_get_cstr(stream->directory));
+
+    stream->bundle = storage_file_alloc(stream->storage);
+    bool success = false;
+    do {
+        if(!storage_file_open(
+               stream->bundle, furi_string_get_cstr(stream->path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+
+        AnimationBundleHeader header;
+        if((storage_file_read(stream->bundle, &header, sizeof(header)) != sizeof(header)) ||
+           (header.magic != ANIMATION_BUNDLE_MAGIC) ||
+           (header.version > ANIMATION_BUNDLE_MAX_SUPPORTED_VERSION)) {
+            FURI_LOG_W(TAG, "Bundle header is invalid");
+            break;
+        }
+        if((header.width != width) || (header.height != height) ||
+           (header.frame_count != stream->frame_count)) {
+            FURI_LOG_W(TAG, "Bundle doesn't match meta");
+            break;
+        }
+
+        size_t table_size = sizeof(AnimationBundleFrame) * stream->frame_count;
+        stream->bundle_frames = malloc(table_size);
+        if(storage_file_read(stream->bundle, stream->bundle_frames, table_size) != table_size)
+            break;
+
+        success = true;
+        for(size_t i = 0; i < stream->frame_count; ++i) {
+            if(stream->bundle_frames[i].size > stream->max_frame_size) {
+                FURI_LOG_E(
+                    TAG,
+                    "Frame %u size %u, max: %u",
+                    i,
+                    stream->bundle_frames[i].size,
+                    stream->max_frame_size);
+                success = false;
+                break;
+            }
+        }
+    } while(0);
+
+    if(!success) {
+        if(stream->bundle_frames) {
+            free(stream->bundle_frames);
+            stream->bundle_frames = NULL;
+        }
+        storage_file_free(stream->bundle);
+        stream->bundle = NULL;
+    }
+
+    return success;
+}
+
+static bool animation_frame_stream_check_files(AnimationFrameStream* stream) {
+    FileInfo file_info;
+
+    for(size_t i = 0; i < stream->frame_count; ++i) {
+        furi_string_printf(
+            stream->path, "%s/frame_%u.bm", furi_string_get_cstr(stream->directory), i);
+        if(storage_common_stat(stream->storage, furi_string_get_cstr(stream->path), &file_info) !=
+           FSE_OK) {
+            FURI_LOG_E(TAG, "Can't stat \'%s\'", furi_string_get_cstr(stream->path));
+            return false;
+        }
+        if(file_info.size > stream->max_frame_size) {
+            FURI_LOG_E(
+                TAG,
+                "Filesize %lld, max: %d ('%s')",
+                file_info.size,
+                stream->max_frame_size,
+                furi_string_get_cstr(stream->path));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+    animation_frame_stream_load(AnimationFrameStream* stream, uint8_t frame, uint8_t* buffer) {
+    furi_assert(frame < stream->frame_count);
+    bool success = false;
+
+    furi_check(furi_mutex_acquire(stream->io_mutex, FuriWaitForever) == FuriStatusOk);
+    if(stream->bundle) {
+        const AnimationBundleFrame* bundle_frame = &stream->bundle_frames[frame];
+        success = storage_file_seek(stream->bundle, bundle_frame->offset, true) &&
+                  (storage_file_read(stream->bundle, buffer, bundle_frame->size) ==
+                   bundle_frame->size);
+    } else {
+        File* file = storage_file_alloc(stream->storage);
+        furi_string_printf(
+            stream->path, "%s/frame_%u.bm", furi_string_get_cstr(stream->directory), frame);
+        if(storage_file_open(
+               file, furi_string_get_cstr(stream->path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            uint64_t size = storage_file_size(file);
+            success = (size <= stream->max_frame_size) &&
+                      (storage_file_read(file, buffer, size) == size);
+        }
+        storage_file_free(file);
+    }
+    furi_mutex_release(stream->io_mutex);
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to read frame %u", frame);
+    }
+
+    return success;
+}
+
+static int8_t animation_frame_stream_find_slot(AnimationFrameStream* stream, uint8_t frame) {
+    for(uint8_t i = 0; i < stream->slot_count; ++i) {
+        if(stream->slots[i].frame == frame) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool animation_frame_stream_is_wanted(AnimationFrameStream* stream, int16_t frame) {
+    for(uint8_t i = 0; i < stream->wanted_count; ++i) {
+        if(stream->wanted[i] == frame) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Evict empty slot first, then least recently used one which is
+ * neither shown nor wanted soon */
+static int8_t animation_frame_stream_pick_victim(AnimationFrameStream* stream) {
+    int8_t victim = -1;
+
+    for(uint8_t i = 0; i < stream->slot_count; ++i) {
+        AnimationFrameSlot* slot = &stream->slots[i];
+        if(slot->loading || (i == stream->shown_slot)) continue;
+        if(slot->frame == ANIMATION_FRAME_NONE) return i;
+        if(animation_frame_stream_is_wanted(stream, slot->frame)) continue;
+        if((victim < 0) || (slot->last_used < stream->slots[victim].last_used)) {
+            victim = i;
+        }
+    }
+
+    return victim;
+}
+
+/* Load one missing wanted frame. Returns false when there is nothing to do. */
+static bool animation_frame_stream_fill_next(AnimationFrameStream* stream) {
+    int8_t victim = -1;
+    uint8_t frame = 0;
+
+    furi_check(furi_mutex_acquire(stream->mutex, FuriWaitForever) == FuriStatusOk);
+    for(uint8_t i = 0; i < stream->wanted_count; ++i) {
+        frame = stream->wanted[i];
+        if(animation_frame_stream_find_slot(stream, frame) < 0) {
+            victim = animation_frame_stream_pick_victim(stream);
+            break;
+        }
+    }
+    if(victim >= 0) {
+        stream->slots[victim].frame = frame;
+        stream->slots[victim].loading = true;
+    }
+    furi_mutex_release(stream->mutex);
+
+    if(victim < 0) {
+        return false;
+    }
+
+    bool loaded = animation_frame_stream_load(stream, frame, stream->slots[victim].data);
+
+    furi_check(furi_mutex_acquire(stream->mutex, FuriWaitForever) == FuriStatusOk);
+    AnimationFrameSlot* slot = &stream->slots[victim];
+    slot->loading = false;
+    if(loaded) {
+        slot->last_used = ++stream->use_counter;
+        ++stream->loads;
+    } else {
+        /* don't retry broken frame until it is requested again */
+        slot->frame = ANIMATION_FRAME_NONE;
+        for(uint8_t i = 0; i < stream->wanted_count; ++i) {
+            if(stream->wanted[i] == frame) {
+                stream->wanted[i] = stream->wanted[--stream->wanted_count];
+                break;
+            }
+        }
+    }
+    furi_mutex_release(stream->mutex);
+
+    return true;
+}
+
+static int32_t animation_frame_stream_worker(void* context) {
+    furi_assert(context);
+    AnimationFrameStream* stream = context;
+
+    while(1) {
+        uint32_t events = furi_thread_flags_wait(
+            ANIMATION_FRAME_STREAM_EVENTS_ALL, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((events & FuriFlagError) == 0);
+
+        if(events & AnimationFrameStreamEventStop) break;
+        if(events & AnimationFrameStreamEventRequest) {
+            while(animation_frame_stream_fill_next(stream))
+                ;
+        }
+    }
+
+    return 0;
+}
+
+AnimationFrameStream* animation_frame_stream_alloc(
+    const char* directory,
+    uint8_t width,
+    uint8_t height,
+    uint8_t frame_count) {
+    furi_assert(directory);
+    furi_assert(frame_count);
+
+    AnimationFrameStream* stream = malloc(sizeof(AnimationFrameStream));
+    stream->storage = furi_record_open(RECORD_STORAGE);
+    stream->directory = furi_string_alloc_set(directory);
+    stream->path = furi_string_alloc();
+    stream->frame_count = frame_count;
+    /* bitmap is either compressed or raw with 1 byte header */
+    stream->max_frame_size = ROUND_UP_TO(width, 8) * height + 1;
+
+    if(!animation_frame_stream_open_bundle(stream, width, height) &&
+       !animation_frame_stream_check_files(stream)) {
+        furi_string_free(stream->path);
+        furi_string_free(stream->directory);
+        furi_record_close(RECORD_STORAGE);
+        free(stream);
+        return NULL;
+    }
+
+    stream->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    stream->io_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    stream->slot_count = MIN(frame_count, ANIMATION_FRAME_STREAM_CACHE_SIZE);
+    stream->shown_slot = -1;
+    for(uint8_t i = 0; i < stream->slot_count; ++i) {
+        stream->slots[i].data = malloc(stream->max_frame_size);
+        stream->slots[i].frame = ANIMATION_FRAME_NONE;
+    }
+
+    stream->thread = furi_thread_alloc_ex(
+        "AnimationFrameStream",
+        ANIMATION_FRAME_STREAM_STACK_SIZE,
+        animation_frame_stream_worker,
+        stream);
+    furi_thread_start(stream->thread);
+
+    FURI_LOG_D(
+        TAG,
+        "%s: %u frames from %s, %u slots",
+        directory,
+        frame_count,
+        stream->bundle ? "bundle" : "files",
+        stream->slot_count);
+
+    return stream;
+}
+
+void animation_frame_stream_free(AnimationFrameStream* stream) {
+    furi_assert(stream);
+
+    furi_thread_flags_set(furi_thread_get_id(stream->thread), AnimationFrameStreamEventStop);
+    furi_thread_join(stream->thread);
+    furi_thread_free(stream->thread);
+
+    FURI_LOG_D(
+        TAG,
+        "Frames: %lu hits, %lu misses, %lu loads",
+        stream->hits,
+        stream->misses,
+        stream->loads);
+
+    for(uint8_t i = 0; i < stream->slot_count; ++i) {
+        free(stream->slots[i].data);
+    }
+    if(stream->bundle) {
+        storage_file_free(stream->bundle);
+        free(stream->bundle_frames);
+    }
+    furi_mutex_free(stream->io_mutex);
+    furi_mutex_free(stream->mutex);
+    furi_string_free(stream->path);
+    furi_string_free(stream->directory);
+    furi_record_close(RECORD_STORAGE);
+    free(stream);
+}
+
+static void animation_frame_stream_set_wanted(
+    AnimationFrameStream* stream,
+    const uint8_t* frames,
+    size_t count) {
+    furi_check(furi_mutex_acquire(stream->mutex, FuriWaitForever) == FuriStatusOk);
+    stream->wanted_count = 0;
+    for(size_t i = 0; i < count && stream->wanted_count < stream->slot_count; ++i) {
+        if((frames[i] < stream->frame_count) &&
+           !animation_frame_stream_is_wanted(stream, frames[i])) {
+            stream->wanted[stream->wanted_count++] = frames[i];
+        }
+    }
+    furi_mutex_release(stream->mutex);
+}
+
+void animation_frame_stream_prefetch(
+    AnimationFrameStream* stream,
+    const uint8_t* frames,
+    size_t count) {
+    furi_assert(stream);
+    furi_assert(frames);
+
+    animation_frame_stream_set_wanted(stream, frames, count);
+    furi_thread_flags_set(furi_thread_get_id(stream->thread), AnimationFrameStreamEventRequest);
+}
+
+void animation_frame_stream_preload(
+    AnimationFrameStream* stream,
+    const uint8_t* frames,
+    size_t count) {
+    furi_assert(stream);
+    furi_assert(frames);
+
+    animation_frame_stream_set_wanted(stream, frames, count);
+    while(animation_frame_stream_fill_next(stream))
+        ;
+}
+
+const uint8_t* animation_frame_stream_get(AnimationFrameStream* stream, uint8_t frame) {
+    furi_assert(stream);
+    const uint8_t* data = NULL;
+
+    furi_check(furi_mutex_acquire(stream->mutex, FuriWaitForever) == FuriStatusOk);
+    int8_t slot = animation_frame_stream_find_slot(stream, frame);
+    if((slot >= 0) && !stream->slots[slot].loading) {
+        stream->shown_slot = slot;
+        stream->slots[slot].last_used = ++stream->use_counter;
+        ++stream->hits;
+    } else {
+        ++stream->misses;
+    }
+    if(stream->shown_slot >= 0) {
+        data = stream->slots[stream->shown_slot].data;
+    }
+    furi_mutex_release(stream->mutex);
+
+    return data;
+}
+
+bool animation_frame_stream_read(AnimationFrameStream* stream, uint8_t frame, uint8_t* buffer) {
+    furi_assert(stream);
+    furi_assert(buffer);
+
+    return (frame < stream->frame_count) && animation_frame_stream_load(stream, frame, buffer);
+}
+
+size_t animation_frame_stream_get_max_frame_size(AnimationFrameStream* stream) {
+    furi_assert(stream);
+    return stream->max_frame_size;
+}
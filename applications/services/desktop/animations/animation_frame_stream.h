@@ -0,0 +1,96 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Amount of frames kept in RAM for a single streamed animation */
+#define ANIMATION_FRAME_STREAM_CACHE_SIZE 6
+
+/** Frame streamer for animations stored on SD-card.
+ * Keeps only a small ring of decoded-ready frames in RAM and
+ * reads upcoming frames in a background thread, so heap usage
+ * doesn't depend on animation length.
+ *
+ * Frames are taken from the packed bundle (frames.bin) if it
+ * is present in animation directory, or from frame_N.bm files
+ * otherwise.
+ */
+typedef struct AnimationFrameStream AnimationFrameStream;
+
+/**
+ * Allocate frame stream and validate frames source.
+ *
+ * @directory       animation directory
+ * @width           frame width
+ * @height          frame height
+ * @frame_count     amount of unique frames
+ * @return          frame stream, NULL if frames are missing or invalid
+ */
+AnimationFrameStream* animation_frame_stream_alloc(
+    const char* directory,
+    uint8_t width,
+    uint8_t height,
+    uint8_t frame_count);
+
+/**
+ * Stop background thread and free frame stream.
+ *
+ * @stream          frame stream instance
+ */
+void animation_frame_stream_free(AnimationFrameStream* stream);
+
+/**
+ * Set frames which will be shown next, in order of appearance.
+ * Missing frames are read in background, frames not mentioned
+ * are evicted first. Non-blocking, can be called from timer.
+ *
+ * @stream          frame stream instance
+ * @frames          frame indexes
+ * @count           amount of frames, only first cache-size are taken
+ */
+void animation_frame_stream_prefetch(
+    AnimationFrameStream* stream,
+    const uint8_t* frames,
+    size_t count);
+
+/**
+ * Same as animation_frame_stream_prefetch, but reads missing
+ * frames in caller context before return.
+ *
+ * @stream          frame stream instance
+ * @frames          frame indexes
+ * @count           amount of frames, only first cache-size are taken
+ */
+void animation_frame_stream_preload(
+    AnimationFrameStream* stream,
+    const uint8_t* frames,
+    size_t count);
+
+/**
+ * Get frame bitmap for drawing. Never blocks on storage: if frame is
+ * not streamed yet, previously returned frame is given instead.
+ * Returned data is valid until next call of this function.
+ *
+ * @stream          frame stream instance
+ * @frame           frame index
+ * @return          frame bitmap, NULL if nothing is loaded yet
+ */
+const uint8_t* animation_frame_stream_get(AnimationFrameStream* stream, uint8_t frame);
+
+/**
+ * Read frame directly from storage, bypassing cache.
+ *
+ * @stream          frame stream instance
+ * @frame           frame index
+ * @buffer          destination, at least animation_frame_stream_get_max_frame_size()
+ * @return          true on success
+ */
+bool animation_frame_stream_read(AnimationFrameStream* stream, uint8_t frame, uint8_t* buffer);
+
+/**
+ * Get max frame size in bytes.
+ *
+ * @stream          frame stream instance
+ * @return          size of biggest possible frame
+ */
+size_t animation_frame_stream_get_max_frame_size(AnimationFrameStream* stream);
@@ -252,18 +252,13 @@ static bool animation_storage_cast_align(FuriString* align_str, Align* align) {
 static void animation_storage_free_frames(BubbleAnimation* animation) {
     furi_assert(animation);
 
-    const Icon* icon = &animation->icon_animation;
-    for(int i = 0; i < icon->frame_count; ++i) {
-        if(icon->frames[i]) {
-            free((void*)icon->frames[i]);
-        }
+    if(animation->frame_stream) {
+        animation_frame_stream_free(animation->frame_stream);
+        animation->frame_stream = NULL;
     }
-
-    free((void*)icon->frames);
 }
 
 static bool animation_storage_load_frames(
-    Storage* storage,
     const char* name,
     BubbleAnimation* animation,
     uint32_t* frame_order,
@@ -286,66 +281,25 @@ static bool animation_storage_load_frames(
     FURI_CONST_ASSIGN(icon->frame_rate, 0);
     FURI_CONST_ASSIGN(icon->height, height);
     FURI_CONST_ASSIGN(icon->width, width);
-    icon->frames = malloc(sizeof(const uint8_t*) * icon->frame_count);
-
-    bool frames_ok = false;
-    File* file = storage_file_alloc(storage);
-    FileInfo file_info;
-    FuriString* filename;
-    filename = furi_string_alloc();
-    size_t max_filesize = ROUND_UP_TO(width, 8) * height + 1;
-
-    for(int i = 0; i < icon->frame_count; ++i) {
-        frames_ok = false;
-        furi_string_printf(filename, ANIMATION_DIR "/%s/frame_%d.bm", name, i);
-
-        if(storage_common_stat(storage, furi_string_get_cstr(filename), &file_info) != FSE_OK)
-            break;
-        if(file_info.size > max_filesize) {
-            FURI_LOG_E(
-                TAG,
-                "Filesize %lld, max: %d (width %d, height %d)",
-                file_info.size,
-                max_filesize,
-                width,
-                height);
-            break;
-        }
-        if(!storage_file_open(
-               file, furi_string_get_cstr(filename), FSAM_READ, FSOM_OPEN_EXISTING)) {
-            FURI_LOG_E(TAG, "Can't open file \'%s\'", furi_string_get_cstr(filename));
-            break;
-        }
+    /* frames are streamed, only a few of them are kept in RAM at once */
+    icon->frames = NULL;
 
-        FURI_CONST_ASSIGN_PTR(icon->frames[i], malloc(file_info.size));
-        if(storage_file_read(file, (void*)icon->frames[i], file_info.size) != file_info.size) {
-            FURI_LOG_E(TAG, "Read failed: \'%s\'", furi_string_get_cstr(filename));
-            break;
-        }
-        storage_file_close(file);
-        frames_ok = true;
-    }
+    FuriString* directory;
+    directory = furi_string_alloc_printf(ANIMATION_DIR "/%s", name);
+    animation->frame_stream = animation_frame_stream_alloc(
+        furi_string_get_cstr(directory), width, height, icon->frame_count);
+    furi_string_free(directory);
 
-    if(!frames_ok) {
-        FURI_LOG_E(
-            TAG,
-            "Load \'%s\' failed, %dx%d, size: %lld",
-            furi_string_get_cstr(filename),
-            width,
-            height,
-            file_info.size);
-        animation_storage_free_frames(animation);
-    } else {
-        furi_check(animation->icon_animation.frames);
-        for(int i = 0; i < animation->icon_animation.frame_count; ++i) {
-            furi_check(animation->icon_animation.frames[i]);
-        }
+    if(!animation->frame_stream) {
+        FURI_LOG_E(TAG, "Load \'%s\' frames failed, %dx%d", name, width, height);
+        return false;
     }
 
-    storage_file_free(file);
-    furi_string_free(filename);
+    /* first passive frames are ready by the time animation is shown */
+    animation_frame_stream_preload(
+        animation->frame_stream, animation->frame_order, animation->passive_frames);
 
-    return frames_ok;
+    return true;
 }
 
 static bool animation_storage_load_bubbles(BubbleAnimation* animation, FlipperFormat* ff) {
@@ -477,8 +431,7 @@ static BubbleAnimation* animation_storage_load_animation(const char* name) {
         }
 
         /* passive and active frames must be loaded up to this point */
-        if(!animation_storage_load_frames(storage, name, animation, u32array, width, height))
-            break;
+        if(!animation_storage_load_frames(name, animation, u32array, width, height)) break;
 
         if(!flipper_format_read_uint32(ff, "Active cycles", &u32value, 1)) break; //-V779
         animation->active_cycles = u32value;
@@ -500,6 +453,7 @@ static BubbleAnimation* animation_storage_load_animation(const char* name) {
     }
 
     if(!success) { //-V547
+        animation_storage_free_frames(animation);
         if(animation->frame_order) {
             free((void*)animation->frame_order);
         }
@@ -13,6 +13,8 @@
 #include <stdint.h>
 #include <core/dangerous_defines.h>
 
+#define TAG "BubbleAnimationView"
+
 #define ACTIVE_SHIFT 2
 
 typedef struct {
@@ -37,23 +39,57 @@ struct BubbleAnimationView {
 static void bubble_animation_activate(BubbleAnimationView* view, bool force);
 static void bubble_animation_activate_right_now(BubbleAnimationView* view);
 
-static uint8_t bubble_animation_get_frame_index(BubbleAnimationViewModel* model) {
-    furi_assert(model);
+static uint8_t
+    bubble_animation_get_frame_index(const BubbleAnimation* animation, uint8_t current_frame) {
+    furi_assert(animation);
     uint8_t icon_index = 0;
-    const BubbleAnimation* animation = model->current;
 
-    if(model->current_frame < animation->passive_frames) {
-        icon_index = model->current_frame;
+    if(current_frame < animation->passive_frames) {
+        icon_index = current_frame;
     } else {
-        icon_index =
-            (model->current_frame - animation->passive_frames) % animation->active_frames +
-            animation->passive_frames;
+        icon_index = (current_frame - animation->passive_frames) % animation->active_frames +
+                     animation->passive_frames;
     }
     furi_assert(icon_index < (animation->passive_frames + animation->active_frames));
 
     return animation->frame_order[icon_index];
 }
 
+/* Tell frame stream which frames are going to be shown next,
+ * following the same steps as bubble_animation_next_frame() */
+static void bubble_animation_prefetch_frames(BubbleAnimationViewModel* model) {
+    furi_assert(model);
+    const BubbleAnimation* animation = model->current;
+    if(!animation || !animation->frame_stream) {
+        return;
+    }
+
+    uint8_t frames[ANIMATION_FRAME_STREAM_CACHE_SIZE];
+    uint8_t current_frame = model->current_frame;
+    uint8_t active_cycle = model->active_cycle;
+    uint8_t active_shift = model->active_shift;
+
+    for(size_t i = 0; i < COUNT_OF(frames); ++i) {
+        frames[i] = bubble_animation_get_frame_index(animation, current_frame);
+
+        if(active_shift && !--active_shift && animation->active_frames) {
+            current_frame = animation->passive_frames;
+        } else if(current_frame < animation->passive_frames) {
+            current_frame = (current_frame + 1) % animation->passive_frames;
+        } else {
+            ++current_frame;
+            active_cycle +=
+                !((current_frame - animation->passive_frames) % animation->active_frames);
+            if(active_cycle >= animation->active_cycles) {
+                active_cycle = 0;
+                current_frame = 0;
+            }
+        }
+    }
+
+    animation_frame_stream_prefetch(animation->frame_stream, frames, COUNT_OF(frames));
+}
+
 static void bubble_animation_draw_callback(Canvas* canvas, void* model_) {
     furi_assert(model_);
     furi_assert(canvas);
@@ -73,12 +109,19 @@ static void bubble_animation_draw_callback(Canvas* canvas, void* model_) {
 
     furi_assert(model->current_frame < 255);
 
-    uint8_t index = bubble_animation_get_frame_index(model);
+    uint8_t index = bubble_animation_get_frame_index(animation, model->current_frame);
     uint8_t width = icon_get_width(&animation->icon_animation);
     uint8_t height = icon_get_height(&animation->icon_animation);
     uint8_t y_offset = canvas_height(canvas) - height;
-    canvas_draw_bitmap(
-        canvas, 0, y_offset, width, height, animation->icon_animation.frames[index]);
+    const uint8_t* frame = NULL;
+    if(animation->frame_stream) {
+        frame = animation_frame_stream_get(animation->frame_stream, index);
+    } else {
+        frame = animation->icon_animation.frames[index];
+    }
+    if(frame) {
+        canvas_draw_bitmap(canvas, 0, y_offset, width, height, frame);
+    }
 
     const FrameBubble* bubble = model->current_bubble;
     if(bubble) {
@@ -172,6 +215,7 @@ static void bubble_animation_activate(BubbleAnimationView* view, bool force) {
     if(ACTIVE_SHIFT > 0) {
         BubbleAnimationViewModel* model = view_get_model(view->view);
         model->active_shift = ACTIVE_SHIFT;
+        bubble_animation_prefetch_frames(model);
         view_commit_model(view->view, false);
     } else {
         bubble_animation_activate_right_now(view);
@@ -188,6 +232,7 @@ static void bubble_animation_activate_right_now(BubbleAnimationView* view) {
         model->current_frame = model->current->passive_frames;
         model->current_bubble = bubble_animation_pick_bubble(model, true);
         frame_rate = model->current->icon_animation.frame_rate;
+        bubble_animation_prefetch_frames(model);
     }
     view_commit_model(view->view, true);
 
@@ -239,6 +284,7 @@ static void bubble_animation_timer_callback(void* context) {
 
     if(!model->freeze_frame && !activate) {
         bubble_animation_next_frame(model);
+        bubble_animation_prefetch_frames(model);
     }
 
     view_commit_model(view->view, !activate);
@@ -252,10 +298,10 @@ static void bubble_animation_timer_callback(void* context) {
  * animation is always activated at unfreezing and played
  * passive frame first, and 2 frames after - active
  */
-static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
-    furi_assert(icon_orig);
-    furi_assert(icon_orig->frames);
-    furi_assert(icon_orig->frames[0]);
+static Icon* bubble_animation_clone_first_frame(const BubbleAnimation* animation) {
+    furi_assert(animation);
+    const Icon* icon_orig = &animation->icon_animation;
+    furi_assert(animation->frame_stream || (icon_orig->frames && icon_orig->frames[0]));
 
     Icon* icon_clone = malloc(sizeof(Icon));
     memcpy(icon_clone, icon_orig, sizeof(Icon));
@@ -268,7 +314,17 @@ static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
      */
     size_t max_bitmap_size = ROUND_UP_TO(icon_orig->width, 8) * icon_orig->height + 1;
     FURI_CONST_ASSIGN_PTR(icon_clone->frames[0], malloc(max_bitmap_size));
-    memcpy((void*)icon_clone->frames[0], icon_orig->frames[0], max_bitmap_size);
+    if(animation->frame_stream) {
+        /* streamed frame is kept in ring, so read own copy */
+        uint8_t* frame = (uint8_t*)icon_clone->frames[0];
+        if(!animation_frame_stream_read(animation->frame_stream, 0, frame)) {
+            /* zeroed bitmap is valid uncompressed blank frame */
+            FURI_LOG_E(TAG, "Failed to read first frame, freezing blank");
+            memset(frame, 0, max_bitmap_size);
+        }
+    } else {
+        memcpy((void*)icon_clone->frames[0], icon_orig->frames[0], max_bitmap_size);
+    }
     FURI_CONST_ASSIGN(icon_clone->frame_count, 1);
 
     return icon_clone;
@@ -370,6 +426,7 @@ void bubble_animation_view_set_animation(
     model->current_bubble = bubble_animation_pick_bubble(model, false);
     model->current_frame = 0;
     model->active_cycle = 0;
+    bubble_animation_prefetch_frames(model);
     view_commit_model(view->view, true);
 
     furi_timer_start(view->timer, 1000 / new_animation->icon_animation.frame_rate);
@@ -381,7 +438,7 @@ void bubble_animation_freeze(BubbleAnimationView* view) {
     BubbleAnimationViewModel* model = view_get_model(view->view);
     furi_assert(model->current);
     furi_assert(!model->freeze_frame);
-    model->freeze_frame = bubble_animation_clone_first_frame(&model->current->icon_animation);
+    model->freeze_frame = bubble_animation_clone_first_frame(model->current);
     model->current = NULL;
     view_commit_model(view->view, false);
     furi_timer_stop(view->timer);
@@ -50,6 +50,11 @@ bool desktop_scene_debug_on_event(void* context, SceneManagerEvent event) {
             consumed = true;
             break;
 
+        case DesktopDebugEventUpdateCpuLoad:
+            desktop_debug_update_cpu_load(desktop->debug_view);
+            consumed = true;
+            break;
+
         default:
             break;
         }
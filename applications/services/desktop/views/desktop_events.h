@@ -29,6 +29,7 @@ typedef enum {
     DesktopDebugEventWrongDeed,
     DesktopDebugEventSaveState,
     DesktopDebugEventExit,
+    DesktopDebugEventUpdateCpuLoad,
 
     DesktopLockMenuEventLock,
     DesktopLockMenuEventPinLock,
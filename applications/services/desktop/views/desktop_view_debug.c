@@ -7,6 +7,15 @@
 #include "../desktop_i.h"
 #include "desktop_view_debug.h"
 
+#define DESKTOP_DEBUG_CPU_UPDATE_PERIOD_MS 1000
+
+// Without dolphin state debug only device screens are available
+#ifdef SRV_DOLPHIN_STATE_DEBUG
+#define DESKTOP_DEBUG_SCREEN_COUNT DesktopViewStatsTotalCount
+#else
+#define DESKTOP_DEBUG_SCREEN_COUNT DesktopViewStatsMeta
+#endif
+
 void desktop_debug_set_callback(
     DesktopDebugView* debug_view,
     DesktopDebugViewCallback callback,
@@ -23,7 +32,7 @@ void desktop_debug_render(Canvas* canvas, void* model) {
     const Version* ver;
     char buffer[64];
 
-    static const char* headers[] = {"Device Info:", "Dolphin Info:"};
+    static const char* headers[] = {"Device Info:", "CPU Load:", "Dolphin Info:"};
 
     canvas_set_color(canvas, ColorBlack);
     canvas_set_font(canvas, FontPrimary);
@@ -31,7 +40,25 @@ void desktop_debug_render(Canvas* canvas, void* model) {
         canvas, 64, 1 + STATUS_BAR_Y_SHIFT, AlignCenter, AlignTop, headers[m->screen]);
     canvas_set_font(canvas, FontSecondary);
 
-    if(m->screen != DesktopViewStatsMeta) {
+    if(m->screen == DesktopViewStatsCpu) {
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "Idle: %.1f%%  IRQ: %.1f%%",
+            (double)m->cpu_idle,
+            (double)m->cpu_isr);
+        canvas_draw_str(canvas, 0, 19 + STATUS_BAR_Y_SHIFT, buffer);
+
+        for(size_t i = 0; i < m->cpu_thread_count; i++) {
+            snprintf(
+                buffer,
+                sizeof(buffer),
+                "%s: %.1f%%",
+                m->cpu_threads[i].name,
+                (double)m->cpu_threads[i].load);
+            canvas_draw_str(canvas, 0, 30 + i * 10 + STATUS_BAR_Y_SHIFT, buffer);
+        }
+    } else if(m->screen != DesktopViewStatsMeta) {
         // Hardware version
         const char* my_name = furi_hal_version_get_name_ptr();
         snprintf(
@@ -127,11 +154,12 @@ bool desktop_debug_input(InputEvent* event, void* context) {
         debug_view->view,
         DesktopDebugViewModel * model,
         {
-#ifdef SRV_DOLPHIN_STATE_DEBUG
-            if((event->key == InputKeyDown) || (event->key == InputKeyUp)) {
-                model->screen = !model->screen;
+            if(event->key == InputKeyDown) {
+                model->screen = (model->screen + 1) % DESKTOP_DEBUG_SCREEN_COUNT;
+            } else if(event->key == InputKeyUp) {
+                model->screen = (model->screen + DESKTOP_DEBUG_SCREEN_COUNT - 1) %
+                                DESKTOP_DEBUG_SCREEN_COUNT;
             }
-#endif
             current = model->screen;
         },
         true);
@@ -160,13 +188,60 @@ bool desktop_debug_input(InputEvent* event, void* context) {
     return true;
 }
 
+void desktop_debug_update_cpu_load(DesktopDebugView* debug_view) {
+    furi_assert(debug_view);
+    CpuLoad* cpu_load = debug_view->cpu_load;
+    cpu_load_update(cpu_load);
+
+    with_view_model(
+        debug_view->view,
+        DesktopDebugViewModel * model,
+        {
+            model->cpu_idle = cpu_load_get_percent(cpu_load, cpu_load_get_idle_time(cpu_load));
+            model->cpu_isr = cpu_load_get_percent(cpu_load, cpu_load_get_isr_time(cpu_load));
+            model->cpu_thread_count =
+                MIN(cpu_load_get_thread_count(cpu_load), (size_t)DESKTOP_DEBUG_CPU_THREADS);
+            for(size_t i = 0; i < model->cpu_thread_count; i++) {
+                const CpuLoadThread* thread = cpu_load_get_thread(cpu_load, i);
+                strlcpy(model->cpu_threads[i].name, thread->name, CPU_LOAD_THREAD_NAME_SIZE);
+                model->cpu_threads[i].load = cpu_load_get_percent(cpu_load, thread->delta);
+            }
+        },
+        true);
+}
+
+// Timer service stack is too small for the update, it is done by the scene
+static void desktop_debug_timer_callback(void* context) {
+    DesktopDebugView* debug_view = context;
+    if(debug_view->callback) {
+        debug_view->callback(DesktopDebugEventUpdateCpuLoad, debug_view->context);
+    }
+}
+
+static void desktop_debug_enter(void* context) {
+    DesktopDebugView* debug_view = context;
+    // Baseline, so first shown values are not averaged over whole uptime
+    cpu_load_update(debug_view->cpu_load);
+    furi_timer_start(debug_view->timer, furi_ms_to_ticks(DESKTOP_DEBUG_CPU_UPDATE_PERIOD_MS));
+}
+
+static void desktop_debug_exit(void* context) {
+    DesktopDebugView* debug_view = context;
+    furi_timer_stop(debug_view->timer);
+}
+
 DesktopDebugView* desktop_debug_alloc() {
     DesktopDebugView* debug_view = malloc(sizeof(DesktopDebugView));
     debug_view->view = view_alloc();
+    debug_view->cpu_load = cpu_load_alloc();
+    debug_view->timer =
+        furi_timer_alloc(desktop_debug_timer_callback, FuriTimerTypePeriodic, debug_view);
     view_allocate_model(debug_view->view, ViewModelTypeLocking, sizeof(DesktopDebugViewModel));
     view_set_context(debug_view->view, debug_view);
     view_set_draw_callback(debug_view->view, (ViewDrawCallback)desktop_debug_render);
     view_set_input_callback(debug_view->view, desktop_debug_input);
+    view_set_enter_callback(debug_view->view, desktop_debug_enter);
+    view_set_exit_callback(debug_view->view, desktop_debug_exit);
 
     return debug_view;
 }
@@ -174,6 +249,8 @@ DesktopDebugView* desktop_debug_alloc() {
 void desktop_debug_free(DesktopDebugView* debug_view) {
     furi_assert(debug_view);
 
+    furi_timer_free(debug_view->timer);
+    cpu_load_free(debug_view->cpu_load);
     view_free(debug_view->view);
     free(debug_view);
 }
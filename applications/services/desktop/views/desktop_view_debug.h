@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <gui/view.h>
+#include <toolbox/cpu_load.h>
 #include "desktop_events.h"
 
 typedef struct DesktopDebugView DesktopDebugView;
@@ -11,21 +12,35 @@ typedef void (*DesktopDebugViewCallback)(DesktopEvent event, void* context);
 // Debug info
 typedef enum {
     DesktopViewStatsFw,
+    DesktopViewStatsCpu,
     DesktopViewStatsMeta,
     DesktopViewStatsTotalCount,
 } DesktopViewStatsScreens;
 
+#define DESKTOP_DEBUG_CPU_THREADS 3
+
 struct DesktopDebugView {
     View* view;
+    CpuLoad* cpu_load;
+    FuriTimer* timer;
     DesktopDebugViewCallback callback;
     void* context;
 };
 
+typedef struct {
+    char name[CPU_LOAD_THREAD_NAME_SIZE];
+    float load;
+} DesktopDebugViewCpuThread;
+
 typedef struct {
     uint32_t icounter;
     uint32_t butthurt;
     uint64_t timestamp;
     DesktopViewStatsScreens screen;
+    DesktopDebugViewCpuThread cpu_threads[DESKTOP_DEBUG_CPU_THREADS];
+    size_t cpu_thread_count;
+    float cpu_idle;
+    float cpu_isr;
 } DesktopDebugViewModel;
 
 void desktop_debug_set_callback(
@@ -39,4 +54,5 @@ DesktopDebugView* desktop_debug_alloc();
 void desktop_debug_free(DesktopDebugView* debug_view);
 
 void desktop_debug_get_dolphin_data(DesktopDebugView* debug_view);
+void desktop_debug_update_cpu_load(DesktopDebugView* debug_view);
 void desktop_debug_reset_screen_idx(DesktopDebugView* debug_view);
@@ -40,6 +40,7 @@ static bool gui_redraw_fs(Gui* gui) {
     ViewPort* view_port = gui_view_port_find_enabled(gui->layers[GuiLayerFullscreen]);
     if(view_port) {
         view_port_draw(view_port, gui->canvas);
+        gui->frame_owner = view_port->owner;
         return true;
     } else {
         return false;
@@ -198,6 +199,7 @@ static bool gui_redraw_window(Gui* gui) {
     ViewPort* view_port = gui_view_port_find_enabled(gui->layers[GuiLayerWindow]);
     if(view_port) {
         view_port_draw(view_port, gui->canvas);
+        gui->frame_owner = view_port->owner;
         return true;
     }
     return false;
@@ -209,6 +211,7 @@ static bool gui_redraw_desktop(Gui* gui) {
     ViewPort* view_port = gui_view_port_find_enabled(gui->layers[GuiLayerDesktop]);
     if(view_port) {
         view_port_draw(view_port, gui->canvas);
+        gui->frame_owner = view_port->owner;
         return true;
     }
 
@@ -223,6 +226,7 @@ static void gui_redraw(Gui* gui) {
         if(gui->direct_draw) break;
 
         canvas_reset(gui->canvas);
+        gui->frame_owner = NULL;
 
         if(gui->lockdown) {
             gui_redraw_desktop(gui);
@@ -353,6 +357,7 @@ void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
     // Add view port and link with gui
     ViewPortArray_push_back(gui->layers[layer], view_port);
     view_port_gui_set(view_port, gui);
+    view_port->owner = furi_thread_get_current_id();
     gui_unlock(gui);
 
     // Request redraw
@@ -457,6 +462,11 @@ void gui_add_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, vo
     gui_update(gui);
 }
 
+FuriThreadId gui_get_frame_owner(Gui* gui) {
+    furi_assert(gui);
+    return gui->frame_owner;
+}
+
 void gui_remove_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context) {
     furi_assert(gui);
 
@@ -89,6 +89,16 @@ void gui_add_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, vo
  */
 void gui_remove_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context);
 
+/** Get thread that added the topmost view port of the last frame
+ *
+ * Meant to be called from canvas commit callback to tell whose frame it is
+ *
+ * @param      gui       Gui instance
+ *
+ * @return     FuriThreadId or NULL if only status bar was drawn
+ */
+FuriThreadId gui_get_frame_owner(Gui* gui);
+
 /** Get gui canvas frame buffer size
  * *
  * @param      gui       Gui instance
@@ -66,6 +66,8 @@ struct Gui {
     ViewPortArray_t layers[GuiLayerMAX];
     Canvas* canvas;
     CanvasCallbackPairArray_t canvas_callback_pair;
+    // Thread that added the topmost view port of the last frame
+    FuriThreadId frame_owner;
 
     // Input
     FuriMessageQueue* input_queue;
@@ -10,6 +10,7 @@
 
 struct ViewPort {
     Gui* gui;
+    FuriThreadId owner;
     bool is_enabled;
     ViewPortOrientation orientation;
 
@@ -20,6 +20,7 @@ static bool
     }
 
     FURI_LOG_I(TAG, "Starting: %s", loader_instance->application->name);
+    loader_timing_begin(loader_instance, loader_instance->application->name);
 
     FuriHalRtcHeapTrackMode mode = furi_hal_rtc_get_heap_track_mode();
     if(mode > FuriHalRtcHeapTrackModeNone) {
@@ -69,6 +70,7 @@ static void loader_cli_print_usage() {
     printf("\tlist\t - List available applications\r\n");
     printf("\topen <Application Name:string>\t - Open application by name\r\n");
     printf("\tinfo\t - Show loader state\r\n");
+    printf("\ttiming\t - Show recent application launch times\r\n");
 }
 
 static FlipperApplication const* loader_find_application_by_name_in_list(
@@ -188,6 +190,46 @@ static void loader_cli_info(Cli* cli, FuriString* args, Loader* instance) {
     }
 }
 
+static void loader_cli_timing(Cli* cli, FuriString* args, Loader* instance) {
+    UNUSED(cli);
+    UNUSED(args);
+    LoaderTimingRecord* records = malloc(sizeof(LoaderTimingRecord) * LOADER_TIMING_HISTORY_SIZE);
+    size_t count = loader_timing_get_history(instance, records, LOADER_TIMING_HISTORY_SIZE);
+
+    if(!count) {
+        printf("No launches recorded\r\n");
+    } else {
+        printf("Launch times, ms, newest first:\r\n");
+        printf(
+            "%-*s %6s %6s %6s %6s %6s %6s %6s %6s\r\n",
+            LOADER_TIMING_NAME_SIZE - 1,
+            "Name",
+            "Total",
+            "Start",
+            "Open",
+            "Sect",
+            "Syms",
+            "Reloc",
+            "Ctors",
+            "Frame");
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        printf("%-*s ", LOADER_TIMING_NAME_SIZE - 1, records[i].name);
+        if(records[i].total) {
+            printf("%6lu", records[i].total);
+        } else {
+            printf("%6s", "-");
+        }
+        for(size_t stage = 0; stage < LoaderTimingStageCount; stage++) {
+            printf(" %6lu", records[i].stage[stage]);
+        }
+        printf("\r\n");
+    }
+
+    free(records);
+}
+
 static void loader_cli(Cli* cli, FuriString* args, void* _ctx) {
     furi_assert(_ctx);
     Loader* instance = _ctx;
@@ -216,6 +258,11 @@ static void loader_cli(Cli* cli, FuriString* args, void* _ctx) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "timing") == 0) {
+            loader_cli_timing(cli, args, instance);
+            break;
+        }
+
         loader_cli_print_usage();
     } while(false);
 
@@ -266,6 +313,79 @@ bool loader_is_locked(Loader* instance) {
     return instance->lock_count > 0;
 }
 
+void loader_timing_begin(Loader* instance, const char* name) {
+    furi_assert(instance);
+    furi_assert(name);
+
+    furi_check(furi_mutex_acquire(instance->timing_mutex, FuriWaitForever) == FuriStatusOk);
+    instance->timing_last = (instance->timing_last + 1) % LOADER_TIMING_HISTORY_SIZE;
+    if(instance->timing_count < LOADER_TIMING_HISTORY_SIZE) instance->timing_count++;
+
+    LoaderTimingRecord* record = &instance->timing_history[instance->timing_last];
+    memset(record, 0, sizeof(LoaderTimingRecord));
+    strlcpy(record->name, name, sizeof(record->name));
+    instance->timing_start = furi_get_tick();
+    instance->timing_thread = NULL;
+    furi_check(furi_mutex_release(instance->timing_mutex) == FuriStatusOk);
+}
+
+void loader_timing_set_stage(Loader* instance, LoaderTimingStage stage, uint32_t time) {
+    furi_assert(instance);
+    furi_check(stage < LoaderTimingStageCount);
+
+    furi_check(furi_mutex_acquire(instance->timing_mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->timing_count) {
+        instance->timing_history[instance->timing_last].stage[stage] = time;
+    }
+    furi_check(furi_mutex_release(instance->timing_mutex) == FuriStatusOk);
+}
+
+void loader_timing_set_frame_owner(Loader* instance, FuriThreadId thread_id) {
+    furi_assert(instance);
+
+    furi_check(furi_mutex_acquire(instance->timing_mutex, FuriWaitForever) == FuriStatusOk);
+    instance->timing_thread_start = furi_get_tick();
+    instance->timing_thread = thread_id;
+    furi_check(furi_mutex_release(instance->timing_mutex) == FuriStatusOk);
+}
+
+size_t loader_timing_get_history(Loader* instance, LoaderTimingRecord* records, size_t count) {
+    furi_assert(instance);
+    furi_assert(records);
+
+    furi_check(furi_mutex_acquire(instance->timing_mutex, FuriWaitForever) == FuriStatusOk);
+    count = MIN(count, instance->timing_count);
+    for(size_t i = 0; i < count; i++) {
+        size_t index =
+            (instance->timing_last + LOADER_TIMING_HISTORY_SIZE - i) % LOADER_TIMING_HISTORY_SIZE;
+        records[i] = instance->timing_history[index];
+    }
+    furi_check(furi_mutex_release(instance->timing_mutex) == FuriStatusOk);
+
+    return count;
+}
+
+// Called by gui on every frame, keep it short
+static void loader_framebuffer_callback(uint8_t* data, size_t size, void* context) {
+    UNUSED(data);
+    UNUSED(size);
+    Loader* instance = context;
+
+    if(!instance->timing_thread) return;
+    if(gui_get_frame_owner(instance->gui) != instance->timing_thread) return;
+
+    furi_check(furi_mutex_acquire(instance->timing_mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->timing_thread && instance->timing_count) {
+        uint32_t now = furi_get_tick();
+        LoaderTimingRecord* record = &instance->timing_history[instance->timing_last];
+        record->stage[LoaderTimingStageFirstFrame] = now - instance->timing_thread_start;
+        record->total = now - instance->timing_start;
+        instance->timing_thread = NULL;
+        FURI_LOG_I(TAG, "%s: first frame in %lums", record->name, record->total);
+    }
+    furi_check(furi_mutex_release(instance->timing_mutex) == FuriStatusOk);
+}
+
 static void loader_thread_state_callback(FuriThreadState thread_state, void* context) {
     furi_assert(context);
 
@@ -273,6 +393,11 @@ static void loader_thread_state_callback(FuriThreadState thread_state, void* con
     LoaderEvent event;
 
     if(thread_state == FuriThreadStateRunning) {
+        // Called from application thread
+        loader_timing_set_stage(
+            instance, LoaderTimingStageStart, furi_get_tick() - instance->timing_start);
+        loader_timing_set_frame_owner(instance, furi_thread_get_current_id());
+
         event.type = LoaderEventTypeApplicationStarted;
         furi_pubsub_publish(loader_instance->pubsub, &event);
 
@@ -318,6 +443,7 @@ static Loader* loader_alloc() {
     furi_thread_set_state_callback(instance->application_thread, loader_thread_state_callback);
 
     instance->pubsub = furi_pubsub_alloc();
+    instance->timing_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
 #ifdef SRV_CLI
     instance->cli = furi_record_open(RECORD_CLI);
@@ -334,6 +460,7 @@ static Loader* loader_alloc() {
     instance->view_dispatcher = view_dispatcher_alloc();
     view_dispatcher_attach_to_gui(
         instance->view_dispatcher, instance->gui, ViewDispatcherTypeFullscreen);
+    gui_add_framebuffer_callback(instance->gui, loader_framebuffer_callback, instance);
     // Primary menu
     instance->primary_menu = menu_alloc();
     view_set_previous_callback(menu_get_view(instance->primary_menu), loader_hide_menu);
@@ -378,6 +505,7 @@ static void loader_free(Loader* instance) {
     }
 
     furi_pubsub_free(instance->pubsub);
+    furi_mutex_free(instance->timing_mutex);
 
     furi_thread_free(instance->application_thread);
 
@@ -391,6 +519,7 @@ static void loader_free(Loader* instance) {
     view_dispatcher_remove_view(loader_instance->view_dispatcher, LoaderMenuViewSettings);
     view_dispatcher_free(loader_instance->view_dispatcher);
 
+    gui_remove_framebuffer_callback(instance->gui, loader_framebuffer_callback, instance);
     furi_record_close(RECORD_GUI);
 
     free(instance);
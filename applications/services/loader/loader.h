@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/pubsub.h>
+#include <core/thread.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -27,6 +28,26 @@ typedef struct {
     LoaderEventType type;
 } LoaderEvent;
 
+#define LOADER_TIMING_NAME_SIZE 24
+
+typedef enum {
+    LoaderTimingStageStart, /**< start request to application thread running */
+    LoaderTimingStageOpen, /**< file open, ELF headers and manifest */
+    LoaderTimingStageSections, /**< section table and section data load */
+    LoaderTimingStageSymbols, /**< symbol table load and import resolution */
+    LoaderTimingStageRelocation, /**< relocation */
+    LoaderTimingStageConstructors, /**< static constructors */
+    LoaderTimingStageFirstFrame, /**< application thread start to its first frame */
+    LoaderTimingStageCount,
+} LoaderTimingStage;
+
+/** Application launch measurements, in milliseconds */
+typedef struct {
+    char name[LOADER_TIMING_NAME_SIZE];
+    uint32_t stage[LoaderTimingStageCount]; /**< 0 if stage was not measured or preloaded */
+    uint32_t total; /**< start request to first frame, 0 if there was no frame yet */
+} LoaderTimingRecord;
+
 /** Start application
  * @param name - application name
  * @param args - application arguments
@@ -54,6 +75,30 @@ void loader_update_menu();
 /** Show primary loader */
 FuriPubSub* loader_get_pubsub(Loader* instance);
 
+/** Begin launch measurement record, for applications started without loader_start
+ * @param name - application name
+ */
+void loader_timing_begin(Loader* instance, const char* name);
+
+/** Set stage duration in the latest launch record
+ * @param stage - launch stage
+ * @param time - duration in milliseconds
+ */
+void loader_timing_set_stage(Loader* instance, LoaderTimingStage stage, uint32_t time);
+
+/** Set thread whose first frame completes the latest launch record
+ * Call it from application thread itself before it can draw, so no frame is missed
+ * @param thread_id - application thread
+ */
+void loader_timing_set_frame_owner(Loader* instance, FuriThreadId thread_id);
+
+/** Get recent launch records, newest first
+ * @param records - output array
+ * @param count - output array size
+ * @retval number of records written
+ */
+size_t loader_timing_get_history(Loader* instance, LoaderTimingRecord* records, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
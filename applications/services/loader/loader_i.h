@@ -14,6 +14,8 @@
 #include <applications.h>
 #include <assets_icons.h>
 
+#define LOADER_TIMING_HISTORY_SIZE 8
+
 struct Loader {
     FuriThreadId loader_thread;
 
@@ -33,6 +35,16 @@ struct Loader {
     volatile uint8_t lock_count;
 
     FuriPubSub* pubsub;
+
+    // Recent launches, ring buffer
+    FuriMutex* timing_mutex;
+    LoaderTimingRecord timing_history[LOADER_TIMING_HISTORY_SIZE];
+    size_t timing_last;
+    size_t timing_count;
+    uint32_t timing_start;
+    // Thread whose first frame completes the latest record
+    volatile FuriThreadId timing_thread;
+    uint32_t timing_thread_start;
 };
 
 typedef enum {
@@ -84,6 +84,13 @@ typedef struct {
 
 typedef const NotificationMessage* NotificationSequence[];
 
+typedef struct {
+    uint32_t processed; /**< messages taken from the queue */
+    uint32_t preempted; /**< sequences cut short by a newer one */
+    uint32_t latency_avg_ms; /**< average time a message waited in the queue */
+    uint32_t latency_max_ms; /**< maximum time a message waited in the queue */
+} NotificationStats;
+
 void notification_message(NotificationApp* app, const NotificationSequence* sequence);
 void notification_message_block(NotificationApp* app, const NotificationSequence* sequence);
 
@@ -105,6 +112,14 @@ void notification_internal_message_block(
     NotificationApp* app,
     const NotificationSequence* sequence);
 
+/**
+ * @brief Get notification service statistics
+ *
+ * @param app notification record content
+ * @param stats statistics
+ */
+void notification_get_stats(NotificationApp* app, NotificationStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,7 +31,9 @@ uint32_t notification_settings_display_off_delay_ticks(NotificationApp* app);
 
 void notification_message_save_settings(NotificationApp* app) {
     NotificationAppMessage m = {
-        .type = SaveSettingsMessage, .back_event = furi_event_flag_alloc()};
+        .type = SaveSettingsMessage,
+        .back_event = furi_event_flag_alloc(),
+        .queued_tick = furi_get_tick()};
     furi_check(furi_message_queue_put(app->queue, &m, FuriWaitForever) == FuriStatusOk);
     furi_event_flag_wait(
         m.back_event, NOTIFICATION_EVENT_COMPLETE, FuriFlagWaitAny, FuriWaitForever);
@@ -170,23 +172,131 @@ static void notification_display_timer(void* ctx) {
 }
 
 // message processing
-void notification_process_notification_message(
-    NotificationApp* app,
-    NotificationAppMessage* message) {
-    uint32_t notification_message_index = 0;
-    const NotificationMessage* notification_message;
-    notification_message = (*message->sequence)[notification_message_index];
+static const uint8_t channel_led_mask = 1 << 0;
+static const uint8_t channel_vibro_mask = 1 << 1;
+static const uint8_t channel_sound_mask = 1 << 2;
+static const uint8_t channel_display_mask = 1 << 3;
+
+// Channels used by sequence and whether it has timed steps
+static uint8_t
+    notification_sequence_get_channels(const NotificationSequence* sequence, bool* timed) {
+    uint8_t channels = 0;
+    *timed = false;
+
+    for(size_t i = 0; (*sequence)[i] != NULL; i++) {
+        switch((*sequence)[i]->type) {
+        case NotificationMessageTypeLedRed:
+        case NotificationMessageTypeLedGreen:
+        case NotificationMessageTypeLedBlue:
+        case NotificationMessageTypeLedBlinkStart:
+        case NotificationMessageTypeLedBlinkColor:
+        case NotificationMessageTypeLedBlinkStop:
+        case NotificationMessageTypeLedBrightnessSettingApply:
+            channels |= channel_led_mask;
+            break;
+        case NotificationMessageTypeVibro:
+            channels |= channel_vibro_mask;
+            break;
+        case NotificationMessageTypeSoundOn:
+        case NotificationMessageTypeSoundOff:
+            channels |= channel_sound_mask;
+            break;
+        case NotificationMessageTypeLedDisplayBacklight:
+        case NotificationMessageTypeLedDisplayBacklightEnforceOn:
+        case NotificationMessageTypeLedDisplayBacklightEnforceAuto:
+            channels |= channel_display_mask;
+            break;
+        case NotificationMessageTypeDelay:
+            *timed = true;
+            break;
+        default:
+            break;
+        }
+    }
 
-    bool led_active = false;
-    uint8_t led_values[NOTIFICATION_LED_COUNT] = {0x00, 0x00, 0x00};
-    bool reset_notifications = true;
-    float speaker_volume_setting = app->settings.speaker_volume;
-    bool vibro_setting = app->settings.vibro_on;
-    float display_brightness_setting = app->settings.display_brightness;
+    return channels;
+}
 
-    uint8_t reset_mask = 0;
+static void notification_player_wait(NotificationPlayer* player, uint32_t ms) {
+    player->wake_tick = furi_get_tick() + furi_ms_to_ticks(ms);
+}
 
-    while(notification_message != NULL) {
+static void notification_instant_state_store(NotificationApp* app, NotificationPlayer* player) {
+    NotificationInstantState* instant = &app->instant;
+    uint8_t mask = player->reset_mask & (reset_red_mask | reset_green_mask | reset_blue_mask |
+                                         reset_vibro_mask | reset_sound_mask);
+
+    for(uint8_t i = 0; i < NOTIFICATION_LED_COUNT; i++) {
+        if(mask & (reset_red_mask << i)) {
+            instant->led_values[i] = player->led_values[i];
+        }
+    }
+    if(mask & reset_vibro_mask) {
+        instant->vibro_on = player->vibro_on;
+    }
+    if(mask & reset_sound_mask) {
+        instant->sound_frequency = player->sound_frequency;
+        instant->sound_volume = player->sound_volume;
+    }
+    instant->mask |= mask;
+}
+
+static void notification_instant_state_restore(NotificationApp* app, uint8_t reset_mask) {
+    NotificationInstantState* instant = &app->instant;
+    uint8_t mask = reset_mask & instant->mask;
+
+    for(uint8_t i = 0; i < NOTIFICATION_LED_COUNT; i++) {
+        if(mask & (reset_red_mask << i)) {
+            notification_apply_notification_led_layer(
+                &app->led[i],
+                notification_settings_get_rgb_led_brightness(app, instant->led_values[i]));
+        }
+    }
+    if((mask & reset_vibro_mask) && instant->vibro_on) {
+        notification_vibro_on();
+    }
+    if((mask & reset_sound_mask) && instant->sound_volume > 0) {
+        notification_sound_on(instant->sound_frequency, instant->sound_volume);
+    }
+}
+
+static void notification_player_finish(NotificationApp* app, NotificationPlayer* player) {
+    if(player->reset_notifications) {
+        notification_reset_notification_layer(app, player->reset_mask);
+        if(player->timed) {
+            // instant sequences applied meanwhile must survive the end of timed one
+            notification_instant_state_restore(app, player->reset_mask);
+        } else {
+            app->instant.mask &= ~player->reset_mask;
+        }
+    } else if(!player->timed) {
+        notification_instant_state_store(app, player);
+    }
+    if(player->back_event != NULL) {
+        furi_event_flag_set(player->back_event, NOTIFICATION_EVENT_COMPLETE);
+    }
+    player->state = NotificationPlayerStateIdle;
+    player->sequence = NULL;
+    player->back_event = NULL;
+}
+
+// Run sequence until the next delay or the end
+static void notification_player_run(NotificationApp* app, NotificationPlayer* player) {
+    const NotificationMessage* notification_message;
+
+    if(player->state == NotificationPlayerStateFinishing) {
+        notification_player_finish(app, player);
+        return;
+    } else if(player->state == NotificationPlayerStateLedGap) {
+        // leds were off for minimal delay, now show them and do the delay itself
+        notification_apply_notification_leds(app, player->led_values);
+        player->state = NotificationPlayerStateRunning;
+        notification_message = (*player->sequence)[player->index++];
+        notification_player_wait(player, notification_message->data.delay.length);
+        return;
+    }
+
+    while((notification_message = (*player->sequence)[player->index]) != NULL) {
         switch(notification_message->type) {
         case NotificationMessageTypeLedDisplayBacklight:
             // if on - switch on and start timer
@@ -195,14 +305,14 @@ void notification_process_notification_message(
             if(notification_message->data.led.value > 0x00) {
                 notification_apply_notification_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * player->display_brightness_setting);
             } else {
                 notification_reset_notification_led_layer(&app->display);
                 if(furi_timer_is_running(app->display_timer)) {
                     furi_timer_stop(app->display_timer);
                 }
             }
-            reset_mask |= reset_display_mask;
+            player->reset_mask |= reset_display_mask;
             break;
         case NotificationMessageTypeLedDisplayBacklightEnforceOn:
             furi_assert(app->display_led_lock < UINT8_MAX);
@@ -210,7 +320,7 @@ void notification_process_notification_message(
             if(app->display_led_lock == 1) {
                 notification_apply_internal_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * player->display_brightness_setting);
             }
             break;
         case NotificationMessageTypeLedDisplayBacklightEnforceAuto:
@@ -219,137 +329,227 @@ void notification_process_notification_message(
             if(app->display_led_lock == 0) {
                 notification_apply_internal_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * player->display_brightness_setting);
             }
             break;
         case NotificationMessageTypeLedRed:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[0] = notification_message->data.led.value;
-            app->led[0].value_last[LayerNotification] = led_values[0];
-            reset_mask |= reset_red_mask;
+            player->led_active = true;
+            player->led_values[0] = notification_message->data.led.value;
+            app->led[0].value_last[LayerNotification] = player->led_values[0];
+            player->reset_mask |= reset_red_mask;
             break;
         case NotificationMessageTypeLedGreen:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[1] = notification_message->data.led.value;
-            app->led[1].value_last[LayerNotification] = led_values[1];
-            reset_mask |= reset_green_mask;
+            player->led_active = true;
+            player->led_values[1] = notification_message->data.led.value;
+            app->led[1].value_last[LayerNotification] = player->led_values[1];
+            player->reset_mask |= reset_green_mask;
             break;
         case NotificationMessageTypeLedBlue:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[2] = notification_message->data.led.value;
-            app->led[2].value_last[LayerNotification] = led_values[2];
-            reset_mask |= reset_blue_mask;
+            player->led_active = true;
+            player->led_values[2] = notification_message->data.led.value;
+            app->led[2].value_last[LayerNotification] = player->led_values[2];
+            player->reset_mask |= reset_blue_mask;
             break;
         case NotificationMessageTypeLedBlinkStart:
             // store and send on delay or after seq
-            led_active = true;
+            player->led_active = true;
             furi_hal_light_blink_start(
                 notification_message->data.led_blink.color,
                 app->settings.led_brightness * 255,
                 notification_message->data.led_blink.on_time,
                 notification_message->data.led_blink.period);
-            reset_mask |= reset_blink_mask;
-            reset_mask |= reset_red_mask;
-            reset_mask |= reset_green_mask;
-            reset_mask |= reset_blue_mask;
+            player->reset_mask |= reset_blink_mask;
+            player->reset_mask |= reset_red_mask;
+            player->reset_mask |= reset_green_mask;
+            player->reset_mask |= reset_blue_mask;
             break;
         case NotificationMessageTypeLedBlinkColor:
-            led_active = true;
+            player->led_active = true;
             furi_hal_light_blink_set_color(notification_message->data.led_blink.color);
             break;
         case NotificationMessageTypeLedBlinkStop:
             furi_hal_light_blink_stop();
-            reset_mask &= ~reset_blink_mask;
-            reset_mask |= reset_red_mask;
-            reset_mask |= reset_green_mask;
-            reset_mask |= reset_blue_mask;
+            player->reset_mask &= ~reset_blink_mask;
+            player->reset_mask |= reset_red_mask;
+            player->reset_mask |= reset_green_mask;
+            player->reset_mask |= reset_blue_mask;
             break;
         case NotificationMessageTypeVibro:
             if(notification_message->data.vibro.on) {
-                if(vibro_setting) notification_vibro_on();
+                if(player->vibro_setting) notification_vibro_on();
             } else {
                 notification_vibro_off();
             }
-            reset_mask |= reset_vibro_mask;
+            player->vibro_on = notification_message->data.vibro.on && player->vibro_setting;
+            player->reset_mask |= reset_vibro_mask;
             break;
         case NotificationMessageTypeSoundOn:
-            notification_sound_on(
-                notification_message->data.sound.frequency,
-                notification_message->data.sound.volume * speaker_volume_setting);
-            reset_mask |= reset_sound_mask;
+            player->sound_frequency = notification_message->data.sound.frequency;
+            player->sound_volume =
+                notification_message->data.sound.volume * player->speaker_volume_setting;
+            notification_sound_on(player->sound_frequency, player->sound_volume);
+            player->reset_mask |= reset_sound_mask;
             break;
         case NotificationMessageTypeSoundOff:
             notification_sound_off();
-            reset_mask |= reset_sound_mask;
+            player->sound_volume = 0;
+            player->reset_mask |= reset_sound_mask;
             break;
         case NotificationMessageTypeDelay:
-            if(led_active) {
+            if(player->led_active) {
+                player->led_active = false;
+                player->reset_mask |= reset_red_mask;
+                player->reset_mask |= reset_green_mask;
+                player->reset_mask |= reset_blue_mask;
+
                 if(notification_is_any_led_layer_internal_and_not_empty(app)) {
                     notification_apply_notification_leds(app, led_off_values);
-                    furi_delay_ms(minimal_delay);
+                    player->state = NotificationPlayerStateLedGap;
+                    notification_player_wait(player, minimal_delay);
+                    return;
                 }
 
-                led_active = false;
-
-                notification_apply_notification_leds(app, led_values);
-                reset_mask |= reset_red_mask;
-                reset_mask |= reset_green_mask;
-                reset_mask |= reset_blue_mask;
+                notification_apply_notification_leds(app, player->led_values);
             }
 
-            furi_delay_ms(notification_message->data.delay.length);
-            break;
+            player->index++;
+            notification_player_wait(player, notification_message->data.delay.length);
+            return;
         case NotificationMessageTypeDoNotReset:
-            reset_notifications = false;
+            player->reset_notifications = false;
             break;
         case NotificationMessageTypeForceSpeakerVolumeSetting:
-            speaker_volume_setting = notification_message->data.forced_settings.speaker_volume;
+            player->speaker_volume_setting =
+                notification_message->data.forced_settings.speaker_volume;
             break;
         case NotificationMessageTypeForceVibroSetting:
-            vibro_setting = notification_message->data.forced_settings.vibro;
+            player->vibro_setting = notification_message->data.forced_settings.vibro;
             break;
         case NotificationMessageTypeForceDisplayBrightnessSetting:
-            display_brightness_setting =
+            player->display_brightness_setting =
                 notification_message->data.forced_settings.display_brightness;
             break;
         case NotificationMessageTypeLedBrightnessSettingApply:
-            led_active = true;
+            player->led_active = true;
             for(uint8_t i = 0; i < NOTIFICATION_LED_COUNT; i++) {
-                led_values[i] = app->led[i].value_last[LayerNotification];
+                player->led_values[i] = app->led[i].value_last[LayerNotification];
             }
-            reset_mask |= reset_red_mask;
-            reset_mask |= reset_green_mask;
-            reset_mask |= reset_blue_mask;
+            player->reset_mask |= reset_red_mask;
+            player->reset_mask |= reset_green_mask;
+            player->reset_mask |= reset_blue_mask;
             break;
         }
-        notification_message_index++;
-        notification_message = (*message->sequence)[notification_message_index];
+        player->index++;
     };
 
     // send and do minimal delay
-    if(led_active) {
+    if(player->led_active) {
         bool need_minimal_delay = false;
         if(notification_is_any_led_layer_internal_and_not_empty(app)) {
             need_minimal_delay = true;
         }
 
-        notification_apply_notification_leds(app, led_values);
-        reset_mask |= reset_red_mask;
-        reset_mask |= reset_green_mask;
-        reset_mask |= reset_blue_mask;
+        player->led_active = false;
+        notification_apply_notification_leds(app, player->led_values);
+        player->reset_mask |= reset_red_mask;
+        player->reset_mask |= reset_green_mask;
+        player->reset_mask |= reset_blue_mask;
 
-        if((need_minimal_delay) && (reset_notifications)) {
+        if((need_minimal_delay) && (player->reset_notifications)) {
             notification_apply_notification_leds(app, led_off_values);
-            furi_delay_ms(minimal_delay);
+            player->state = NotificationPlayerStateFinishing;
+            notification_player_wait(player, minimal_delay);
+            return;
         }
     }
 
-    if(reset_notifications) {
-        notification_reset_notification_layer(app, reset_mask);
+    notification_player_finish(app, player);
+}
+
+void notification_process_notification_message(
+    NotificationApp* app,
+    NotificationAppMessage* message) {
+    bool timed;
+    uint8_t channels = notification_sequence_get_channels(message->sequence, &timed);
+
+    // Timed sequence takes over channels of older ones, instant ones are merged in place
+    NotificationPlayer* player = NULL;
+    NotificationPlayer* oldest = NULL;
+    for(size_t i = 0; i < NOTIFICATION_PLAYER_COUNT; i++) {
+        NotificationPlayer* item = &app->player[i];
+        if(item->state != NotificationPlayerStateIdle && timed && (item->channels & channels)) {
+            notification_player_finish(app, item);
+            app->stats.preempted++;
+        }
+
+        if(item->state == NotificationPlayerStateIdle) {
+            if(!player) player = item;
+        } else if(!oldest || (int32_t)(item->start_tick - oldest->start_tick) < 0) {
+            oldest = item;
+        }
+    }
+
+    // all players are busy: drop the oldest one
+    if(!player) {
+        player = oldest;
+        notification_player_finish(app, player);
+        app->stats.preempted++;
+    }
+
+    player->state = NotificationPlayerStateRunning;
+    player->sequence = message->sequence;
+    player->back_event = message->back_event;
+    player->index = 0;
+    player->channels = timed ? channels : 0;
+    player->timed = timed;
+    player->start_tick = furi_get_tick();
+    player->led_active = false;
+    memset(player->led_values, 0, sizeof(player->led_values));
+    player->reset_notifications = true;
+    player->speaker_volume_setting = app->settings.speaker_volume;
+    player->vibro_setting = app->settings.vibro_on;
+    player->display_brightness_setting = app->settings.display_brightness;
+    player->reset_mask = 0;
+    player->vibro_on = false;
+    player->sound_volume = 0;
+
+    notification_player_run(app, player);
+}
+
+// Resume players whose delay is over, returns time to wait for the next one
+static uint32_t notification_players_process(NotificationApp* app) {
+    uint32_t timeout = FuriWaitForever;
+
+    for(size_t i = 0; i < NOTIFICATION_PLAYER_COUNT; i++) {
+        NotificationPlayer* player = &app->player[i];
+        // Instant steps after a delay may end with another delay, loop until we must wait
+        while(player->state != NotificationPlayerStateIdle) {
+            int32_t left = player->wake_tick - furi_get_tick();
+            if(left > 0) {
+                timeout = MIN(timeout, (uint32_t)left);
+                break;
+            }
+            notification_player_run(app, player);
+        }
+    }
+
+    return timeout;
+}
+
+static void notification_account_latency(NotificationApp* app, NotificationAppMessage* message) {
+    uint32_t latency =
+        (furi_get_tick() - message->queued_tick) * 1000 / furi_kernel_get_tick_frequency();
+
+    FURI_CRITICAL_ENTER();
+    app->stats.processed++;
+    app->latency_total += latency;
+    if(latency > app->stats.latency_max_ms) {
+        app->stats.latency_max_ms = latency;
     }
+    FURI_CRITICAL_EXIT();
 }
 
 void notification_process_internal_message(NotificationApp* app, NotificationAppMessage* message) {
@@ -543,24 +743,36 @@ int32_t notification_srv(void* p) {
     furi_record_create(RECORD_NOTIFICATION, app);
 
     NotificationAppMessage message;
+    uint32_t timeout = FuriWaitForever;
     while(1) {
-        furi_check(furi_message_queue_get(app->queue, &message, FuriWaitForever) == FuriStatusOk);
+        // Wait for message or for the next step of a playing sequence
+        FuriStatus status = furi_message_queue_get(app->queue, &message, timeout);
+
+        if(status == FuriStatusOk) {
+            notification_account_latency(app, &message);
+
+            switch(message.type) {
+            case NotificationLayerMessage:
+                // completion is reported by player
+                notification_process_notification_message(app, &message);
+                message.back_event = NULL;
+                break;
+            case InternalLayerMessage:
+                notification_process_internal_message(app, &message);
+                break;
+            case SaveSettingsMessage:
+                notification_save_settings(app);
+                break;
+            }
 
-        switch(message.type) {
-        case NotificationLayerMessage:
-            notification_process_notification_message(app, &message);
-            break;
-        case InternalLayerMessage:
-            notification_process_internal_message(app, &message);
-            break;
-        case SaveSettingsMessage:
-            notification_save_settings(app);
-            break;
+            if(message.back_event != NULL) {
+                furi_event_flag_set(message.back_event, NOTIFICATION_EVENT_COMPLETE);
+            }
+        } else {
+            furi_check(status == FuriStatusErrorTimeout);
         }
 
-        if(message.back_event != NULL) {
-            furi_event_flag_set(message.back_event, NOTIFICATION_EVENT_COMPLETE);
-        }
+        timeout = notification_players_process(app);
     }
 
     return 0;
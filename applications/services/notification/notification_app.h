@@ -5,6 +5,7 @@
 #include "notification_settings_filename.h"
 
 #define NOTIFICATION_LED_COUNT 3
+#define NOTIFICATION_PLAYER_COUNT 4
 #define NOTIFICATION_EVENT_COMPLETE 0x00000001U
 
 typedef enum {
@@ -17,6 +18,7 @@ typedef struct {
     const NotificationSequence* sequence;
     NotificationAppMessageType type;
     FuriEventFlag* back_event;
+    uint32_t queued_tick;
 } NotificationAppMessage;
 
 typedef enum {
@@ -44,6 +46,49 @@ typedef struct {
     bool vibro_on;
 } NotificationSettings;
 
+typedef enum {
+    NotificationPlayerStateIdle,
+    NotificationPlayerStateRunning,
+    NotificationPlayerStateLedGap, // leds are off for minimal delay before current delay step
+    NotificationPlayerStateFinishing, // leds are off for minimal delay before reset
+} NotificationPlayerState;
+
+/* Channel state left by instant sequences with DoNotReset. Timed sequences restore it
+   when they end instead of resetting these channels to the internal layer. */
+typedef struct {
+    uint8_t mask; // reset masks of channels that hold instant state
+    uint8_t led_values[NOTIFICATION_LED_COUNT];
+    bool vibro_on;
+    float sound_frequency;
+    float sound_volume; // 0 if sound is off
+} NotificationInstantState;
+
+/* Sequence in progress. Delays are not slept in place: player stores its position
+   and notification thread resumes it at wake_tick while serving other messages. */
+typedef struct {
+    NotificationPlayerState state;
+    const NotificationSequence* sequence;
+    FuriEventFlag* back_event;
+    size_t index;
+    uint8_t channels;
+    bool timed;
+    uint32_t start_tick;
+    uint32_t wake_tick;
+
+    bool led_active;
+    uint8_t led_values[NOTIFICATION_LED_COUNT];
+    bool reset_notifications;
+    float speaker_volume_setting;
+    bool vibro_setting;
+    float display_brightness_setting;
+    uint8_t reset_mask;
+
+    // last vibro and sound state set by sequence
+    bool vibro_on;
+    float sound_frequency;
+    float sound_volume;
+} NotificationPlayer;
+
 struct NotificationApp {
     FuriMessageQueue* queue;
     FuriPubSub* event_record;
@@ -53,6 +98,11 @@ struct NotificationApp {
     NotificationLedLayer led[NOTIFICATION_LED_COUNT];
     uint8_t display_led_lock;
 
+    NotificationPlayer player[NOTIFICATION_PLAYER_COUNT];
+    NotificationInstantState instant;
+    NotificationStats stats;
+    uint64_t latency_total;
+
     NotificationSettings settings;
 };
 
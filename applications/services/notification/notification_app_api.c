@@ -6,13 +6,19 @@
 
 void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
     NotificationAppMessage m = {
-        .type = NotificationLayerMessage, .sequence = sequence, .back_event = NULL};
+        .type = NotificationLayerMessage,
+        .sequence = sequence,
+        .back_event = NULL,
+        .queued_tick = furi_get_tick()};
     furi_check(furi_message_queue_put(app->queue, &m, FuriWaitForever) == FuriStatusOk);
 };
 
 void notification_internal_message(NotificationApp* app, const NotificationSequence* sequence) {
     NotificationAppMessage m = {
-        .type = InternalLayerMessage, .sequence = sequence, .back_event = NULL};
+        .type = InternalLayerMessage,
+        .sequence = sequence,
+        .back_event = NULL,
+        .queued_tick = furi_get_tick()};
     furi_check(furi_message_queue_put(app->queue, &m, FuriWaitForever) == FuriStatusOk);
 };
 
@@ -20,7 +26,8 @@ void notification_message_block(NotificationApp* app, const NotificationSequence
     NotificationAppMessage m = {
         .type = NotificationLayerMessage,
         .sequence = sequence,
-        .back_event = furi_event_flag_alloc()};
+        .back_event = furi_event_flag_alloc(),
+        .queued_tick = furi_get_tick()};
     furi_check(furi_message_queue_put(app->queue, &m, FuriWaitForever) == FuriStatusOk);
     furi_event_flag_wait(
         m.back_event, NOTIFICATION_EVENT_COMPLETE, FuriFlagWaitAny, FuriWaitForever);
@@ -31,9 +38,25 @@ void notification_internal_message_block(
     NotificationApp* app,
     const NotificationSequence* sequence) {
     NotificationAppMessage m = {
-        .type = InternalLayerMessage, .sequence = sequence, .back_event = furi_event_flag_alloc()};
+        .type = InternalLayerMessage,
+        .sequence = sequence,
+        .back_event = furi_event_flag_alloc(),
+        .queued_tick = furi_get_tick()};
     furi_check(furi_message_queue_put(app->queue, &m, FuriWaitForever) == FuriStatusOk);
     furi_event_flag_wait(
         m.back_event, NOTIFICATION_EVENT_COMPLETE, FuriFlagWaitAny, FuriWaitForever);
     furi_event_flag_free(m.back_event);
 };
+
+void notification_get_stats(NotificationApp* app, NotificationStats* stats) {
+    furi_assert(app);
+    furi_assert(stats);
+
+    uint64_t latency_total;
+    FURI_CRITICAL_ENTER();
+    *stats = app->stats;
+    latency_total = app->latency_total;
+    FURI_CRITICAL_EXIT();
+
+    stats->latency_avg_ms = stats->processed ? (latency_total / stats->processed) : 0;
+}
@@ -9,7 +9,7 @@
 #include "storage/filesystem_api_defines.h"
 #include "storage/storage.h"
 #include <stdint.h>
-#include <lib/toolbox/md5.h>
+#include <lib/toolbox/hash.h>
 #include <lib/toolbox/path.h>
 #include <update_util/lfs_backup.h>
 
@@ -19,6 +19,10 @@
 
 static const size_t MAX_DATA_SIZE = 512;
 
+/* Storage is accessed in blocks of this size, messages still carry MAX_DATA_SIZE chunks */
+#define RPC_STORAGE_BLOCK_SIZE (4096)
+#define RPC_STORAGE_READ_AHEAD_STACK_SIZE (1024)
+
 typedef enum {
     RpcStorageStateIdle = 0,
     RpcStorageStateWriting,
@@ -30,8 +34,138 @@ typedef struct {
     File* file;
     RpcStorageState state;
     uint32_t current_command_id;
+    uint8_t* write_buffer;
+    size_t write_buffer_used;
+    size_t write_total;
+    uint32_t write_start_tick;
 } RpcStorageSystem;
 
+/** Double-buffered file reader: worker thread fills one block while caller consumes the other */
+typedef struct {
+    File* file;
+    size_t size;
+    size_t block_capacity;
+    uint8_t* block[2];
+    size_t block_size[2];
+    size_t block_index;
+    FuriSemaphore* free_blocks;
+    FuriSemaphore* ready_blocks;
+    FuriThread* thread;
+} RpcStorageReadAhead;
+
+static int32_t rpc_system_storage_read_ahead_worker(void* context) {
+    RpcStorageReadAhead* read_ahead = context;
+    size_t size_left = read_ahead->size;
+
+    for(size_t index = 0; size_left > 0; index ^= 1) {
+        furi_check(
+            furi_semaphore_acquire(read_ahead->free_blocks, FuriWaitForever) == FuriStatusOk);
+
+        size_t read_size = MIN(size_left, read_ahead->block_capacity);
+        read_ahead->block_size[index] =
+            storage_file_read(read_ahead->file, read_ahead->block[index], read_size);
+        bool success = (read_ahead->block_size[index] == read_size);
+        size_left -= read_ahead->block_size[index];
+
+        furi_semaphore_release(read_ahead->ready_blocks);
+        if(!success) break;
+    }
+
+    return 0;
+}
+
+static RpcStorageReadAhead* rpc_system_storage_read_ahead_alloc(File* file, size_t size) {
+    furi_assert(file);
+    furi_assert(size);
+
+    RpcStorageReadAhead* read_ahead = malloc(sizeof(RpcStorageReadAhead));
+    read_ahead->file = file;
+    read_ahead->size = size;
+    read_ahead->block_capacity = MIN(size, (size_t)RPC_STORAGE_BLOCK_SIZE);
+    read_ahead->block[0] = malloc(read_ahead->block_capacity);
+    read_ahead->block[1] = malloc(read_ahead->block_capacity);
+    read_ahead->block_index = 0;
+    read_ahead->free_blocks = furi_semaphore_alloc(2, 2);
+    read_ahead->ready_blocks = furi_semaphore_alloc(2, 0);
+    read_ahead->thread = furi_thread_alloc_ex(
+        "RpcStorageReadAhead",
+        RPC_STORAGE_READ_AHEAD_STACK_SIZE,
+        rpc_system_storage_read_ahead_worker,
+        read_ahead);
+    furi_thread_start(read_ahead->thread);
+
+    return read_ahead;
+}
+
+/** Wait for next block. Returns false if storage failed to provide expected amount of data */
+static bool rpc_system_storage_read_ahead_get(
+    RpcStorageReadAhead* read_ahead,
+    size_t size_left,
+    uint8_t** data,
+    size_t* data_size) {
+    furi_check(
+        furi_semaphore_acquire(read_ahead->ready_blocks, FuriWaitForever) == FuriStatusOk);
+
+    *data = read_ahead->block[read_ahead->block_index];
+    *data_size = read_ahead->block_size[read_ahead->block_index];
+
+    return *data_size == MIN(size_left, read_ahead->block_capacity);
+}
+
+/** Give consumed block back to worker */
+static void rpc_system_storage_read_ahead_put(RpcStorageReadAhead* read_ahead) {
+    read_ahead->block_index ^= 1;
+    furi_semaphore_release(read_ahead->free_blocks);
+}
+
+static void rpc_system_storage_read_ahead_free(RpcStorageReadAhead* read_ahead) {
+    /* Worker stops by itself once whole file is read or on the first failed read */
+    furi_thread_join(read_ahead->thread);
+    furi_thread_free(read_ahead->thread);
+    furi_semaphore_free(read_ahead->free_blocks);
+    furi_semaphore_free(read_ahead->ready_blocks);
+    free(read_ahead->block[0]);
+    free(read_ahead->block[1]);
+    free(read_ahead);
+}
+
+static void rpc_system_storage_log_throughput(const char* operation, size_t size, uint32_t start) {
+    uint32_t elapsed_ms = (furi_get_tick() - start) * 1000 / furi_kernel_get_tick_frequency();
+    uint32_t speed = elapsed_ms ? (uint32_t)((uint64_t)size * 1000 / elapsed_ms / 1024) : 0;
+    FURI_LOG_I(TAG, "%s: %u bytes, %lu ms, %lu KiB/s", operation, size, elapsed_ms, speed);
+}
+
+static bool rpc_system_storage_write_flush(RpcStorageSystem* rpc_storage) {
+    bool success = true;
+    if(rpc_storage->write_buffer_used) {
+        size_t written_size = storage_file_write(
+            rpc_storage->file, rpc_storage->write_buffer, rpc_storage->write_buffer_used);
+        success = (written_size == rpc_storage->write_buffer_used);
+        rpc_storage->write_buffer_used = 0;
+    }
+    return success;
+}
+
+static bool
+    rpc_system_storage_write_buffered(RpcStorageSystem* rpc_storage, uint8_t* data, size_t size) {
+    bool success = true;
+    rpc_storage->write_total += size;
+
+    while(size && success) {
+        size_t chunk_size = MIN(size, RPC_STORAGE_BLOCK_SIZE - rpc_storage->write_buffer_used);
+        memcpy(rpc_storage->write_buffer + rpc_storage->write_buffer_used, data, chunk_size);
+        rpc_storage->write_buffer_used += chunk_size;
+        data += chunk_size;
+        size -= chunk_size;
+
+        if(rpc_storage->write_buffer_used == RPC_STORAGE_BLOCK_SIZE) {
+            success = rpc_system_storage_write_flush(rpc_storage);
+        }
+    }
+
+    return success;
+}
+
 static void rpc_system_storage_reset_state(
     RpcStorageSystem* rpc_storage,
     RpcSession* session,
@@ -48,9 +182,12 @@ static void rpc_system_storage_reset_state(
         }
 
         if(rpc_storage->state == RpcStorageStateWriting) {
+            rpc_system_storage_write_flush(rpc_storage);
             storage_file_close(rpc_storage->file);
             storage_file_free(rpc_storage->file);
             furi_record_close(RECORD_STORAGE);
+            free(rpc_storage->write_buffer);
+            rpc_storage->write_buffer = NULL;
         }
 
         rpc_storage->state = RpcStorageStateIdle;
@@ -338,38 +475,53 @@ static void rpc_system_storage_read_process(const PB_Main* request, void* contex
     bool fs_operation_success = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
 
     if(fs_operation_success) {
-        size_t size_left = storage_file_size(file);
-        do {
-            response->command_id = request->command_id;
-            response->which_content = PB_Main_storage_read_response_tag;
-            response->command_status = PB_CommandStatus_OK;
-
-            size_t read_size = MIN(size_left, MAX_DATA_SIZE);
-            if(read_size) {
-                response->content.storage_read_response.has_file = true;
-                response->content.storage_read_response.file.data =
-                    malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(read_size));
-                uint8_t* buffer = &response->content.storage_read_response.file.data->bytes[0];
-                uint16_t* read_size_msg = &response->content.storage_read_response.file.data->size;
-
-                *read_size_msg = storage_file_read(file, buffer, read_size);
-                size_left -= *read_size_msg;
-                fs_operation_success = (*read_size_msg == read_size);
-
-                response->has_next = fs_operation_success && (size_left > 0);
-            } else {
-                response->content.storage_read_response.file.data =
-                    malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(0));
-                response->content.storage_read_response.file.data->size = 0;
-                response->content.storage_read_response.has_file = true;
-                response->has_next = false;
-                fs_operation_success = true;
+        size_t file_size = storage_file_size(file);
+        response->command_id = request->command_id;
+        response->which_content = PB_Main_storage_read_response_tag;
+        response->command_status = PB_CommandStatus_OK;
+        response->content.storage_read_response.has_file = true;
+
+        if(file_size) {
+            /* Single message buffer is reused for every chunk */
+            pb_bytes_array_t* data = malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(MAX_DATA_SIZE));
+            response->content.storage_read_response.file.data = data;
+
+            uint32_t start = furi_get_tick();
+            size_t size_left = file_size;
+            RpcStorageReadAhead* read_ahead = rpc_system_storage_read_ahead_alloc(file, file_size);
+
+            while(size_left && fs_operation_success) {
+                uint8_t* block;
+                size_t block_size;
+                fs_operation_success =
+                    rpc_system_storage_read_ahead_get(read_ahead, size_left, &block, &block_size);
+
+                for(size_t offset = 0; fs_operation_success && (offset < block_size);) {
+                    data->size = MIN(block_size - offset, MAX_DATA_SIZE);
+                    memcpy(data->bytes, block + offset, data->size);
+                    offset += data->size;
+                    size_left -= data->size;
+                    response->has_next = (size_left > 0);
+                    rpc_send(session, response);
+                }
+
+                rpc_system_storage_read_ahead_put(read_ahead);
             }
 
+            rpc_system_storage_read_ahead_free(read_ahead);
+            response->content.storage_read_response.file.data = NULL;
+            free(data);
+
             if(fs_operation_success) {
-                rpc_send_and_release(session, response);
+                rpc_system_storage_log_throughput("Read", file_size, start);
             }
-        } while((size_left != 0) && fs_operation_success);
+        } else {
+            response->content.storage_read_response.file.data =
+                malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(0));
+            response->content.storage_read_response.file.data->size = 0;
+            response->has_next = false;
+            rpc_send_and_release(session, response);
+        }
     }
 
     if(!fs_operation_success) {
@@ -415,6 +567,10 @@ static void rpc_system_storage_write_process(const PB_Main* request, void* conte
         rpc_storage->file = storage_file_alloc(rpc_storage->api);
         rpc_storage->current_command_id = request->command_id;
         rpc_storage->state = RpcStorageStateWriting;
+        rpc_storage->write_buffer = malloc(RPC_STORAGE_BLOCK_SIZE);
+        rpc_storage->write_buffer_used = 0;
+        rpc_storage->write_total = 0;
+        rpc_storage->write_start_tick = furi_get_tick();
         const char* path = request->content.storage_write_request.path;
         fs_operation_success =
             storage_file_open(rpc_storage->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
@@ -429,8 +585,16 @@ static void rpc_system_storage_write_process(const PB_Main* request, void* conte
            request->content.storage_write_request.file.data->size) {
             uint8_t* buffer = request->content.storage_write_request.file.data->bytes;
             size_t buffer_size = request->content.storage_write_request.file.data->size;
-            uint16_t written_size = storage_file_write(file, buffer, buffer_size);
-            fs_operation_success = (written_size == buffer_size);
+            fs_operation_success =
+                rpc_system_storage_write_buffered(rpc_storage, buffer, buffer_size);
+        }
+
+        if(fs_operation_success && !request->has_next) {
+            fs_operation_success = rpc_system_storage_write_flush(rpc_storage);
+            if(fs_operation_success) {
+                rpc_system_storage_log_throughput(
+                    "Write", rpc_storage->write_total, rpc_storage->write_start_tick);
+            }
         }
 
         send_response = !request->has_next;
@@ -572,20 +736,26 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
     File* file = storage_file_alloc(fs_api);
 
     if(storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        const uint16_t size_to_read = 512;
-        const uint8_t hash_size = 16;
-        uint8_t* data = malloc(size_to_read);
-        uint8_t* hash = malloc(sizeof(uint8_t) * hash_size);
-        md5_context* md5_ctx = malloc(sizeof(md5_context));
-
-        md5_starts(md5_ctx);
-        while(true) {
-            uint16_t read_size = storage_file_read(file, data, size_to_read);
-            if(read_size == 0) break;
-            md5_update(md5_ctx, data, read_size);
+        Hash* hash = hash_alloc(HashTypeMd5);
+        FuriString* digest = furi_string_alloc();
+
+        size_t size_left = storage_file_size(file);
+        if(size_left) {
+            RpcStorageReadAhead* read_ahead = rpc_system_storage_read_ahead_alloc(file, size_left);
+            bool read_success = true;
+            while(size_left && read_success) {
+                uint8_t* block;
+                size_t block_size;
+                read_success =
+                    rpc_system_storage_read_ahead_get(read_ahead, size_left, &block, &block_size);
+                hash_update(hash, block, block_size);
+                size_left -= block_size;
+                rpc_system_storage_read_ahead_put(read_ahead);
+            }
+            rpc_system_storage_read_ahead_free(read_ahead);
         }
-        md5_finish(md5_ctx, hash);
-        free(md5_ctx);
+        hash_finish_hex(hash, digest);
+        hash_free(hash);
 
         PB_Main response = {
             .command_id = request->command_id,
@@ -594,16 +764,12 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
             .has_next = false,
         };
 
-        char* md5sum = response.content.storage_md5sum_response.md5sum;
-        size_t md5sum_size = sizeof(response.content.storage_md5sum_response.md5sum);
-        (void)md5sum_size;
-        furi_assert(hash_size <= ((md5sum_size - 1) / 2)); //-V547
-        for(uint8_t i = 0; i < hash_size; i++) {
-            md5sum += snprintf(md5sum, md5sum_size, "%02x", hash[i]);
-        }
+        strlcpy(
+            response.content.storage_md5sum_response.md5sum,
+            furi_string_get_cstr(digest),
+            sizeof(response.content.storage_md5sum_response.md5sum));
 
-        free(hash);
-        free(data);
+        furi_string_free(digest);
         storage_file_close(file);
         rpc_send_and_release(session, &response);
     } else {
@@ -697,6 +863,7 @@ void* rpc_system_storage_alloc(RpcSession* session) {
     rpc_storage->api = furi_record_open(RECORD_STORAGE);
     rpc_storage->session = session;
     rpc_storage->state = RpcStorageStateIdle;
+    rpc_storage->write_buffer = NULL;
 
     RpcHandler rpc_handler = {
         .message_handler = NULL,
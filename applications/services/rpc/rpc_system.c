@@ -9,6 +9,8 @@
 
 #define TAG "RpcSystem"
 
+#define RPC_SYSTEM_CPU_THREADS_MAX 32
+
 typedef struct {
     RpcSession* session;
     PB_Main* response;
@@ -90,6 +92,42 @@ static void rpc_system_system_device_info_callback(
     rpc_send_and_release(ctx->session, ctx->response);
 }
 
+/* CPU time keys are appended after info, so info end is not the stream end */
+static void rpc_system_system_device_info_continue_callback(
+    const char* key,
+    const char* value,
+    bool last,
+    void* context) {
+    UNUSED(last);
+    rpc_system_system_device_info_callback(key, value, false, context);
+}
+
+/* Cumulative microseconds, clients compute load from deltas between requests */
+static void rpc_system_system_device_info_cpu_time(RpcSystemContext* ctx) {
+    FuriString* key = furi_string_alloc();
+    FuriString* value = furi_string_alloc();
+
+    FuriThreadId ids[RPC_SYSTEM_CPU_THREADS_MAX];
+    size_t count = furi_thread_enumerate(ids, RPC_SYSTEM_CPU_THREADS_MAX);
+    for(size_t i = 0; i < count; i++) {
+        furi_string_printf(key, "cpu_time_thread_%s", furi_thread_get_name(ids[i]));
+        furi_string_printf(value, "%llu", furi_thread_get_run_time(ids[i]));
+        rpc_system_system_device_info_callback(
+            furi_string_get_cstr(key), furi_string_get_cstr(value), false, ctx);
+    }
+
+    furi_string_printf(value, "%llu", furi_hal_interrupt_get_time_total());
+    rpc_system_system_device_info_callback(
+        "cpu_time_interrupts", furi_string_get_cstr(value), false, ctx);
+
+    furi_string_printf(value, "%llu", furi_kernel_get_run_time());
+    rpc_system_system_device_info_callback(
+        "cpu_time_total", furi_string_get_cstr(value), true, ctx);
+
+    furi_string_free(value);
+    furi_string_free(key);
+}
+
 static void rpc_system_system_device_info_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(request->which_content == PB_Main_system_device_info_request_tag);
@@ -108,7 +146,9 @@ static void rpc_system_system_device_info_process(const PB_Main* request, void*
         .session = session,
         .response = response,
     };
-    furi_hal_info_get(rpc_system_system_device_info_callback, '_', &device_info_context);
+    furi_hal_info_get(
+        rpc_system_system_device_info_continue_callback, '_', &device_info_context);
+    rpc_system_system_device_info_cpu_time(&device_info_context);
 
     free(response);
 }
@@ -3,10 +3,11 @@
 
 #include <cli/cli.h>
 #include <lib/toolbox/args.h>
-#include <lib/toolbox/md5.h>
+#include <lib/toolbox/hash.h>
 #include <lib/toolbox/dir_walk.h>
 #include <storage/storage.h>
 #include <storage/storage_sd_api.h>
+#include <sector_cache.h>
 #include <power/power_service/power.h>
 
 #define MAX_NAME_LENGTH 255
@@ -31,6 +32,8 @@ static void storage_cli_print_usage() {
     printf("\trename\t - move file to new file, <args> must contain new path\r\n");
     printf("\tmkdir\t - creates a new directory\r\n");
     printf("\tmd5\t - md5 hash of the file\r\n");
+    printf(
+        "\thash\t - hash of the file or of every file in the dir, <args> can be md5, sha1, sha256 (default) or crc32\r\n");
     printf("\tstat\t - info about file or dir\r\n");
     printf("\ttimestamp\t - last modification timestamp\r\n");
 };
@@ -71,6 +74,19 @@ static void storage_cli_info(Cli* cli, FuriString* path) {
                 sd_api_get_fs_type_text(sd_info.fs_type),
                 sd_info.kb_total,
                 sd_info.kb_free);
+
+            SectorCacheStats cache_stats;
+            sector_cache_get_stats(&cache_stats);
+            printf(
+                "Cache: %u sectors (%u meta, %u hot, %u probation)\r\n"
+                "Cache: %lu hits, %lu misses, %lu evictions\r\n",
+                cache_stats.size,
+                cache_stats.meta_sectors,
+                cache_stats.hot_sectors,
+                cache_stats.probation_sectors,
+                cache_stats.hits,
+                cache_stats.misses,
+                cache_stats.evictions);
         }
     } else {
         storage_cli_print_usage();
@@ -469,41 +485,85 @@ static void storage_cli_mkdir(Cli* cli, FuriString* path) {
     furi_record_close(RECORD_STORAGE);
 }
 
+static bool storage_cli_hash_file(File* file, const char* path, Hash* hash, FuriString* digest) {
+    bool result = false;
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        if(hash_update_file(hash, file, NULL, NULL)) {
+            hash_finish_hex(hash, digest);
+            result = true;
+        } else {
+            hash_reset(hash);
+        }
+    }
+
+    if(!result) {
+        storage_cli_print_error(storage_file_get_error(file));
+    }
+
+    storage_file_close(file);
+    return result;
+}
+
 static void storage_cli_md5(Cli* cli, FuriString* path) {
     UNUSED(cli);
     Storage* api = furi_record_open(RECORD_STORAGE);
     File* file = storage_file_alloc(api);
+    Hash* hash = hash_alloc(HashTypeMd5);
+    FuriString* digest = furi_string_alloc();
 
-    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
-        const uint16_t buffer_size = 512;
-        const uint8_t hash_size = 16;
-        uint8_t* data = malloc(buffer_size);
-        uint8_t* hash = malloc(sizeof(uint8_t) * hash_size);
-        md5_context* md5_ctx = malloc(sizeof(md5_context));
+    if(storage_cli_hash_file(file, furi_string_get_cstr(path), hash, digest)) {
+        printf("%s\r\n", furi_string_get_cstr(digest));
+    }
 
-        md5_starts(md5_ctx);
-        while(true) {
-            uint16_t read_size = storage_file_read(file, data, buffer_size);
-            if(read_size == 0) break;
-            md5_update(md5_ctx, data, read_size);
-        }
-        md5_finish(md5_ctx, hash);
-        free(md5_ctx);
+    furi_string_free(digest);
+    hash_free(hash);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
 
-        for(uint8_t i = 0; i < hash_size; i++) {
-            printf("%02x", hash[i]);
+static void storage_cli_hash(Cli* cli, FuriString* path, FuriString* args) {
+    HashType type = HashTypeSha256;
+    if(args_length(args) && !hash_type_from_name(furi_string_get_cstr(args), &type)) {
+        storage_cli_print_usage();
+        return;
+    }
+
+    Storage* api = furi_record_open(RECORD_STORAGE);
+    File* dir = storage_file_alloc(api);
+    File* file = storage_file_alloc(api);
+    Hash* hash = hash_alloc(type);
+    FuriString* digest = furi_string_alloc();
+
+    if(storage_dir_open(dir, furi_string_get_cstr(path))) {
+        // Same output as *sum utilities: one line per file
+        FileInfo fileinfo;
+        char name[MAX_NAME_LENGTH];
+        FuriString* file_path = furi_string_alloc();
+
+        while(storage_dir_read(dir, &fileinfo, name, MAX_NAME_LENGTH)) {
+            if(fileinfo.flags & FSF_DIRECTORY) continue;
+
+            furi_string_printf(file_path, "%s/%s", furi_string_get_cstr(path), name);
+            if(!storage_cli_hash_file(file, furi_string_get_cstr(file_path), hash, digest)) {
+                break;
+            }
+            printf("%s  %s\r\n", furi_string_get_cstr(digest), name);
+
+            if(cli_cmd_interrupt_received(cli)) break;
         }
-        printf("\r\n");
 
-        free(hash);
-        free(data);
-    } else {
-        storage_cli_print_error(storage_file_get_error(file));
+        furi_string_free(file_path);
+    } else if(storage_cli_hash_file(file, furi_string_get_cstr(path), hash, digest)) {
+        printf("%s  %s\r\n", furi_string_get_cstr(digest), furi_string_get_cstr(path));
     }
 
-    storage_file_close(file);
-    storage_file_free(file);
+    storage_dir_close(dir);
 
+    furi_string_free(digest);
+    hash_free(hash);
+    storage_file_free(file);
+    storage_file_free(dir);
     furi_record_close(RECORD_STORAGE);
 }
 
@@ -590,6 +650,11 @@ void storage_cli(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "hash") == 0) {
+            storage_cli_hash(cli, path, args);
+            break;
+        }
+
         if(furi_string_cmp_str(cmd, "stat") == 0) {
             storage_cli_stat(cli, path);
             break;
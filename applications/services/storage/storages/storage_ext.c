@@ -1,4 +1,5 @@
 #include "fatfs.h"
+#include "sector_cache.h"
 #include "../filesystem_api_internal.h"
 #include "storage_ext.h"
 #include <furi_hal.h>
@@ -24,6 +25,23 @@ static FS_Error storage_ext_parse_error(SDError error);
 
 /******************* Core Functions *******************/
 
+static bool sd_cluster_range(FATFS* fs, DWORD cluster, uint32_t* start, uint32_t* end) {
+    if(cluster < 2 || cluster >= fs->n_fatent) return false;
+    *start = fs->database + (cluster - 2) * fs->csize;
+    *end = *start + fs->csize;
+    return true;
+}
+
+static void sd_pin_metadata(FATFS* fs) {
+    // FAT12/16 root directory lies between FAT and data area, FAT32/exFAT root is a cluster
+    sector_cache_set_pinned_range(fs->fatbase, fs->database);
+
+    uint32_t start, end;
+    if(fs->fs_type >= FS_FAT32 && sd_cluster_range(fs, fs->dirbase, &start, &end)) {
+        sector_cache_set_root_dir_range(start, end);
+    }
+}
+
 static bool sd_mount_card(StorageData* storage, bool notify) {
     bool result = false;
     uint8_t counter = BSP_SD_MaxMountRetryCount();
@@ -65,6 +83,7 @@ static bool sd_mount_card(StorageData* storage, bool notify) {
                 }
 
                 if(status == FR_OK) {
+                    sd_pin_metadata(sd_data->fs);
                     storage->status = StorageStatusOK;
                 } else if(status == FR_NO_FILESYSTEM) {
                     storage->status = StorageStatusNoFS;
@@ -135,6 +154,7 @@ FS_Error sd_format_card(StorageData* storage) {
         storage->status = StorageStatusNotMounted;
         error = f_mount(sd_data->fs, sd_data->path, 1);
         if(error != FR_OK) break;
+        sd_pin_metadata(sd_data->fs);
         storage->status = StorageStatusOK;
     } while(false);
 
@@ -451,6 +471,14 @@ static bool storage_ext_dir_open(void* ctx, File* file, const char* path) {
     storage_set_storage_file_data(file, file_data, storage);
     file->internal_error_id = f_opendir(file_data, path);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
+
+    // First cluster of directory is kept in cache along with FAT, root is pinned on mount
+    uint32_t start, end;
+    if(file->error_id == FSE_OK &&
+       sd_cluster_range(file_data->obj.fs, file_data->obj.sclust, &start, &end)) {
+        sector_cache_pin_dir_range(start, end);
+    }
+
     return (file->error_id == FSE_OK);
 }
 
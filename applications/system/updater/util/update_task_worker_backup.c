@@ -41,21 +41,24 @@ static bool update_task_pre_update(UpdateTask* update_task) {
     return success;
 }
 
+#define UPDATE_TASK_RESOURCE_AVG_ENTRY_SIZE 2048
+
 typedef struct {
     UpdateTask* update_task;
-    int32_t total_files, processed_files;
+    TarArchive* archive;
 } TarUnpackProgress;
 
 static bool update_task_resource_unpack_cb(const char* name, bool is_directory, void* context) {
     UNUSED(name);
     UNUSED(is_directory);
     TarUnpackProgress* unpack_progress = context;
-    unpack_progress->processed_files++;
+    uint32_t processed, total;
+    tar_archive_get_read_progress(unpack_progress->archive, &processed, &total);
     update_task_set_progress(
         unpack_progress->update_task,
         UpdateTaskStageProgress,
         /* For this stage, last 70% of progress = extraction */
-        30 + (unpack_progress->processed_files * 70) / (unpack_progress->total_files + 1));
+        30 + ((uint64_t)processed * 70) / (total + 1));
     return true;
 }
 
@@ -154,8 +157,7 @@ static bool update_task_post_update(UpdateTask* update_task) {
         if(update_task->state.groups & UpdateTaskStageGroupResources) {
             TarUnpackProgress progress = {
                 .update_task = update_task,
-                .total_files = 0,
-                .processed_files = 0,
+                .archive = archive,
             };
             update_task_set_progress(update_task, UpdateTaskStageResourcesUpdate, 0);
 
@@ -168,9 +170,12 @@ static bool update_task_post_update(UpdateTask* update_task) {
             CHECK_RESULT(
                 tar_archive_open(archive, furi_string_get_cstr(file_path), TAR_OPEN_MODE_READ));
 
-            progress.total_files = tar_archive_get_entries_count(archive);
-            if(progress.total_files > 0) {
-                update_task_cleanup_resources(update_task, progress.total_files);
+            /* Entry count only scales cleanup progress, estimate it from archive size */
+            uint32_t processed, total;
+            tar_archive_get_read_progress(archive, &processed, &total);
+            if(total > 0) {
+                update_task_cleanup_resources(
+                    update_task, total / UPDATE_TASK_RESOURCE_AVG_ENTRY_SIZE);
 
                 CHECK_RESULT(tar_archive_unpack_to(archive, STORAGE_EXT_PATH_PREFIX, NULL));
             }
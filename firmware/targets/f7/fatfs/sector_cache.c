@@ -7,55 +7,310 @@
 #include <furi_hal_memory.h>
 
 #define SECTOR_SIZE 512
-#define N_SECTORS 8
 #define TAG "SDCache"
 
+#define SECTOR_CACHE_NONE 0xFF
+#define SECTOR_CACHE_HASH_SIZE 64
+/* FAT region, root directory and recently opened directories */
+#define SECTOR_CACHE_PINNED_DIRS 4
+#define SECTOR_CACHE_PINNED_RANGES (2 + SECTOR_CACHE_PINNED_DIRS)
+
+_Static_assert(
+    SECTOR_CACHE_MAX_SECTORS < SECTOR_CACHE_NONE,
+    "SECTOR_CACHE_MAX_SECTORS must fit in uint8_t index");
+
+/* Sectors are kept in one of the lists:
+ * - probation: read once, FIFO, big sequential reads only pass through it
+ * - hot: referenced again while in probation, LRU
+ * - meta: sectors in pinned ranges (FAT, root and recent directories), LRU,
+ *   never evicted by data sectors
+ */
+typedef enum {
+    SectorCacheListFree,
+    SectorCacheListProbation,
+    SectorCacheListHot,
+    SectorCacheListMeta,
+    SectorCacheListCount,
+} SectorCacheList;
+
 typedef struct {
-    uint32_t itr;
-    uint32_t sectors[N_SECTORS];
-    uint8_t sector_data[N_SECTORS][SECTOR_SIZE];
+    uint32_t sector;
+    uint8_t prev;
+    uint8_t next;
+    uint8_t hash_next;
+    uint8_t list;
+} SectorCacheEntry;
+
+typedef struct {
+    uint8_t head;
+    uint8_t tail;
+    uint8_t count;
+} SectorCacheListHead;
+
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} SectorCacheRange;
+
+typedef enum {
+    SectorCacheRangeFat,
+    SectorCacheRangeRootDir,
+    SectorCacheRangeDirs, /* SECTOR_CACHE_PINNED_DIRS ranges, most recent first */
+} SectorCacheRangeId;
+
+typedef struct {
+    uint8_t size;
+    uint8_t probation_max;
+    uint8_t meta_max;
+    SectorCacheRange pinned[SECTOR_CACHE_PINNED_RANGES];
+    SectorCacheStats stats;
+    SectorCacheListHead lists[SectorCacheListCount];
+    uint8_t hash[SECTOR_CACHE_HASH_SIZE];
+    SectorCacheEntry entries[SECTOR_CACHE_MAX_SECTORS];
+    uint8_t* sector_data;
 } SectorCache;
 
 static SectorCache* cache = NULL;
 
+static inline uint8_t sector_cache_hash(uint32_t n_sector) {
+    return n_sector % SECTOR_CACHE_HASH_SIZE;
+}
+
+static void sector_cache_list_remove(uint8_t index) {
+    SectorCacheEntry* entry = &cache->entries[index];
+    SectorCacheListHead* list = &cache->lists[entry->list];
+
+    if(entry->prev != SECTOR_CACHE_NONE) {
+        cache->entries[entry->prev].next = entry->next;
+    } else {
+        list->head = entry->next;
+    }
+    if(entry->next != SECTOR_CACHE_NONE) {
+        cache->entries[entry->next].prev = entry->prev;
+    } else {
+        list->tail = entry->prev;
+    }
+    list->count--;
+}
+
+static void sector_cache_list_push_front(uint8_t index, SectorCacheList list_id) {
+    SectorCacheEntry* entry = &cache->entries[index];
+    SectorCacheListHead* list = &cache->lists[list_id];
+
+    entry->list = list_id;
+    entry->prev = SECTOR_CACHE_NONE;
+    entry->next = list->head;
+    if(list->head != SECTOR_CACHE_NONE) {
+        cache->entries[list->head].prev = index;
+    } else {
+        list->tail = index;
+    }
+    list->head = index;
+    list->count++;
+}
+
+static void sector_cache_hash_remove(uint8_t index) {
+    uint8_t* link = &cache->hash[sector_cache_hash(cache->entries[index].sector)];
+    while(*link != SECTOR_CACHE_NONE) {
+        if(*link == index) {
+            *link = cache->entries[index].hash_next;
+            break;
+        }
+        link = &cache->entries[*link].hash_next;
+    }
+}
+
+static void sector_cache_hash_insert(uint8_t index) {
+    uint8_t* bucket = &cache->hash[sector_cache_hash(cache->entries[index].sector)];
+    cache->entries[index].hash_next = *bucket;
+    *bucket = index;
+}
+
+static uint8_t sector_cache_find(uint32_t n_sector) {
+    uint8_t index = cache->hash[sector_cache_hash(n_sector)];
+    while(index != SECTOR_CACHE_NONE && cache->entries[index].sector != n_sector) {
+        index = cache->entries[index].hash_next;
+    }
+    return index;
+}
+
+static void sector_cache_release(uint8_t index) {
+    sector_cache_hash_remove(index);
+    sector_cache_list_remove(index);
+    sector_cache_list_push_front(index, SectorCacheListFree);
+}
+
+static bool sector_cache_is_pinned(uint32_t n_sector) {
+    for(size_t i = 0; i < SECTOR_CACHE_PINNED_RANGES; ++i) {
+        if((n_sector >= cache->pinned[i].start) && (n_sector < cache->pinned[i].end)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint8_t sector_cache_evict(SectorCacheList for_list) {
+    SectorCacheListHead* lists = cache->lists;
+    SectorCacheList victim_list;
+
+    if((for_list == SectorCacheListMeta) && (lists[SectorCacheListMeta].count >= cache->meta_max)) {
+        victim_list = SectorCacheListMeta;
+    } else if(
+        lists[SectorCacheListProbation].count &&
+        ((lists[SectorCacheListProbation].count >= cache->probation_max) ||
+         !lists[SectorCacheListHot].count)) {
+        victim_list = SectorCacheListProbation;
+    } else if(lists[SectorCacheListHot].count) {
+        victim_list = SectorCacheListHot;
+    } else {
+        victim_list = SectorCacheListMeta;
+    }
+
+    uint8_t index = lists[victim_list].tail;
+    furi_assert(index != SECTOR_CACHE_NONE);
+    sector_cache_release(index);
+    cache->stats.evictions++;
+
+    return index;
+}
+
+static void sector_cache_reset() {
+    memset(cache->hash, SECTOR_CACHE_NONE, sizeof(cache->hash));
+    for(size_t i = 0; i < SectorCacheListCount; ++i) {
+        cache->lists[i].head = SECTOR_CACHE_NONE;
+        cache->lists[i].tail = SECTOR_CACHE_NONE;
+        cache->lists[i].count = 0;
+    }
+    for(uint8_t i = 0; i < cache->size; ++i) {
+        cache->entries[i].sector = 0;
+        cache->entries[i].hash_next = SECTOR_CACHE_NONE;
+        sector_cache_list_push_front(i, SectorCacheListFree);
+    }
+    memset(cache->pinned, 0, sizeof(cache->pinned));
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    cache->stats.size = cache->size;
+}
+
 void sector_cache_init() {
     if(cache == NULL) {
-        // TODO: tuneup allocation order, to place cache in mem pool (MEM2)
+        /* take as much as MEM2 pool allows, but no less than minimum */
+        size_t pool_free = memmgr_pool_get_max_block();
+        size_t size = SECTOR_CACHE_MAX_SECTORS;
+        while((size > SECTOR_CACHE_MIN_SECTORS) &&
+              (sizeof(SectorCache) + size * SECTOR_SIZE > pool_free)) {
+            size--;
+        }
+
         cache = memmgr_alloc_from_pool(sizeof(SectorCache));
+        if(cache != NULL) {
+            cache->sector_data = memmgr_alloc_from_pool(size * SECTOR_SIZE);
+            cache->size = size;
+            cache->probation_max = MAX(size / 4, 1);
+            cache->meta_max = MAX(size / 2, 1);
+        }
     }
 
     if(cache != NULL) {
-        FURI_LOG_I(TAG, "Init");
-        memset(cache, 0, sizeof(SectorCache));
+        FURI_LOG_I(TAG, "Init: %u sectors", cache->size);
+        sector_cache_reset();
     } else {
         FURI_LOG_E(TAG, "Init failed");
     }
 }
 
+void sector_cache_set_pinned_range(uint32_t start_sector, uint32_t end_sector) {
+    if(cache == NULL) return;
+    /* new filesystem, directory ranges of previous one are stale */
+    memset(cache->pinned, 0, sizeof(cache->pinned));
+    cache->pinned[SectorCacheRangeFat].start = start_sector;
+    cache->pinned[SectorCacheRangeFat].end = end_sector;
+}
+
+void sector_cache_set_root_dir_range(uint32_t start_sector, uint32_t end_sector) {
+    if(cache == NULL) return;
+    cache->pinned[SectorCacheRangeRootDir].start = start_sector;
+    cache->pinned[SectorCacheRangeRootDir].end = end_sector;
+}
+
+void sector_cache_pin_dir_range(uint32_t start_sector, uint32_t end_sector) {
+    if(cache == NULL) return;
+    SectorCacheRange* dirs = &cache->pinned[SectorCacheRangeDirs];
+
+    /* move to front, dropping least recently opened directory if it is new */
+    size_t pos = 0;
+    while((pos < SECTOR_CACHE_PINNED_DIRS - 1) && (dirs[pos].start != start_sector)) {
+        pos++;
+    }
+    memmove(&dirs[1], &dirs[0], pos * sizeof(SectorCacheRange));
+    dirs[0].start = start_sector;
+    dirs[0].end = end_sector;
+}
+
 uint8_t* sector_cache_get(uint32_t n_sector) {
-    if(cache != NULL && n_sector != 0) {
-        for(int sector_i = 0; sector_i < N_SECTORS; ++sector_i) {
-            if(cache->sectors[sector_i] == n_sector) {
-                return cache->sector_data[sector_i];
-            }
-        }
+    if(cache == NULL || n_sector == 0) return NULL;
+
+    uint8_t index = sector_cache_find(n_sector);
+    if(index == SECTOR_CACHE_NONE) {
+        cache->stats.misses++;
+        return NULL;
     }
-    return NULL;
+
+    cache->stats.hits++;
+    SectorCacheList list = cache->entries[index].list;
+    sector_cache_list_remove(index);
+    /* second reference moves sector out of probation */
+    sector_cache_list_push_front(
+        index, (list == SectorCacheListProbation) ? SectorCacheListHot : list);
+
+    return &cache->sector_data[index * SECTOR_SIZE];
 }
 
 void sector_cache_put(uint32_t n_sector, uint8_t* data) {
-    if(cache == NULL) return;
-    cache->sectors[cache->itr % N_SECTORS] = n_sector;
-    memcpy(cache->sector_data[cache->itr % N_SECTORS], data, SECTOR_SIZE);
-    cache->itr++;
+    if(cache == NULL || n_sector == 0) return;
+
+    SectorCacheList list =
+        sector_cache_is_pinned(n_sector) ? SectorCacheListMeta : SectorCacheListProbation;
+
+    uint8_t index = sector_cache_find(n_sector);
+    if(index != SECTOR_CACHE_NONE) {
+        sector_cache_release(index);
+    }
+
+    if((list == SectorCacheListMeta) &&
+       (cache->lists[SectorCacheListMeta].count >= cache->meta_max)) {
+        index = sector_cache_evict(list);
+    } else if(cache->lists[SectorCacheListFree].count) {
+        index = cache->lists[SectorCacheListFree].head;
+    } else {
+        index = sector_cache_evict(list);
+    }
+
+    sector_cache_list_remove(index);
+    cache->entries[index].sector = n_sector;
+    sector_cache_hash_insert(index);
+    sector_cache_list_push_front(index, list);
+    memcpy(&cache->sector_data[index * SECTOR_SIZE], data, SECTOR_SIZE);
 }
 
 void sector_cache_invalidate_range(uint32_t start_sector, uint32_t end_sector) {
     if(cache == NULL) return;
-    for(int sector_i = 0; sector_i < N_SECTORS; ++sector_i) {
-        if((cache->sectors[sector_i] >= start_sector) &&
-           (cache->sectors[sector_i] <= end_sector)) {
-            cache->sectors[sector_i] = 0;
+    for(uint8_t index = 0; index < cache->size; ++index) {
+        SectorCacheEntry* entry = &cache->entries[index];
+        if((entry->list != SectorCacheListFree) && (entry->sector >= start_sector) &&
+           (entry->sector <= end_sector)) {
+            sector_cache_release(index);
         }
     }
-}
\ No newline at end of file
+}
+
+void sector_cache_get_stats(SectorCacheStats* stats) {
+    furi_assert(stats);
+    if(cache == NULL) {
+        memset(stats, 0, sizeof(SectorCacheStats));
+        return;
+    }
+    *stats = cache->stats;
+    stats->meta_sectors = cache->lists[SectorCacheListMeta].count;
+    stats->hot_sectors = cache->lists[SectorCacheListHot].count;
+    stats->probation_sectors = cache->lists[SectorCacheListProbation].count;
+}
@@ -5,6 +5,26 @@
 extern "C" {
 #endif
 
+/** Max amount of cached sectors, actual size depends on free MEM2 pool */
+#ifndef SECTOR_CACHE_MAX_SECTORS
+#define SECTOR_CACHE_MAX_SECTORS 32
+#endif
+
+/** Min amount of cached sectors */
+#ifndef SECTOR_CACHE_MIN_SECTORS
+#define SECTOR_CACHE_MIN_SECTORS 8
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint8_t size;
+    uint8_t meta_sectors;
+    uint8_t hot_sectors;
+    uint8_t probation_sectors;
+} SectorCacheStats;
+
 /**
  * @brief Init sector cache system
  */
@@ -24,6 +44,30 @@ uint8_t* sector_cache_get(uint32_t n_sector);
  */
 void sector_cache_put(uint32_t n_sector, uint8_t* data);
 
+/**
+ * @brief Set range of filesystem metadata sectors (FAT), which are kept
+ * in separate part of cache and never evicted by file data.
+ * Clears root and recent directory ranges.
+ * @param start_sector First sector number
+ * @param end_sector Sector number after the last one
+ */
+void sector_cache_set_pinned_range(uint32_t start_sector, uint32_t end_sector);
+
+/**
+ * @brief Set sector range of root directory, cached like FAT sectors
+ * @param start_sector First sector number
+ * @param end_sector Sector number after the last one
+ */
+void sector_cache_set_root_dir_range(uint32_t start_sector, uint32_t end_sector);
+
+/**
+ * @brief Pin sector range of opened directory, cached like FAT sectors.
+ * Only few most recently pinned directories are kept.
+ * @param start_sector First sector number
+ * @param end_sector Sector number after the last one
+ */
+void sector_cache_pin_dir_range(uint32_t start_sector, uint32_t end_sector);
+
 /**
  * @brief Invalidate sector cache for given range
  * @param start_sector Start sector number
@@ -31,6 +75,12 @@ void sector_cache_put(uint32_t n_sector, uint8_t* data);
  */
 void sector_cache_invalidate_range(uint32_t start_sector, uint32_t end_sector);
 
+/**
+ * @brief Get cache statistics
+ * @param stats Pointer to stats to fill
+ */
+void sector_cache_get_stats(SectorCacheStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
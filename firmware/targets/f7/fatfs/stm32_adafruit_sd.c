@@ -162,7 +162,7 @@ typedef enum {
 #define SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE \
     0xFE /* Data token start byte, Start Single Block Write */
 #define SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE \
-    0xFD /* Data token start byte, Start Multiple Block Write */
+    0xFC /* Data token start byte, Start Multiple Block Write */
 #define SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE \
     0xFD /* Data toke stop byte, Stop Multiple Block Write */
 
@@ -194,9 +194,13 @@ typedef enum {
 #define SD_CMD_UNTAG_ERASE_GROUP 37 /* CMD37 = 0x65 */
 #define SD_CMD_ERASE 38 /* CMD38 = 0x66 */
 #define SD_CMD_SD_APP_OP_COND 41 /* CMD41 = 0x69 */
+#define SD_CMD_SET_WR_BLK_ERASE_COUNT 23 /* ACMD23 = 0x57 */
 #define SD_CMD_APP_CMD 55 /* CMD55 = 0x77 */
 #define SD_CMD_READ_OCR 58 /* CMD55 = 0x79 */
 
+/* Maximum busy time after write or stop, SDXC cards may take up to 500ms */
+#define SD_BUSY_TIMEOUT_US 500000
+
 /**
   * @brief  SD reponses and error flags
   */
@@ -270,6 +274,9 @@ static uint8_t SD_GoIdleState(void);
 static SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t Answer);
 static uint8_t SD_WaitData(uint8_t data);
 static uint8_t SD_ReadData(void);
+static uint8_t SD_StopTransmission(void);
+static uint8_t SD_WaitNotBusy(void);
+static uint8_t SD_WriteSingleBlock(uint8_t* pData, uint32_t Addr);
 /** @defgroup STM32_ADAFRUIT_SD_Private_Function_Prototypes
   * @{
   */
@@ -452,34 +459,40 @@ uint8_t
     /* Initialize the address */
     addr = (ReadAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
 
-    /* Data transfer */
-    while(NumOfBlocks--) {
+    if(single_sector_read) {
         /* Send CMD17 (SD_CMD_READ_SINGLE_BLOCK) to read one block */
         /* Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
         response = SD_SendCmd(SD_CMD_READ_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
+    } else {
+        /* Send CMD18 (SD_CMD_READ_MULT_BLOCK) to read blocks one after another
+           without command handshake per block, stopped with CMD12 */
+        response = SD_SendCmd(SD_CMD_READ_MULT_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
+    }
+    if(response.r1 != SD_R1_NO_ERROR) {
+        goto error;
+    }
 
+    /* Data transfer */
+    while(NumOfBlocks--) {
         /* Now look for the data token to signify the start of the data */
-        if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
-            /* Read the SD block data : read NumByteToRead data */
-            SD_IO_WriteReadData(NULL, (uint8_t*)pData + offset, BlockSize);
-
-            /* Set next read address*/
-            offset += BlockSize;
-            addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
-
-            /* get CRC bytes (not really needed by us, but required by SD) */
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-        } else {
+        if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) != BSP_SD_OK) {
+            if(!single_sector_read) {
+                SD_StopTransmission();
+            }
             goto error;
         }
 
-        /* End the command data read cycle */
-        SD_IO_CSState(1);
+        /* Read the SD block data : read NumByteToRead data */
+        SD_IO_WriteReadData(NULL, (uint8_t*)pData + offset, BlockSize);
+        offset += BlockSize;
+
+        /* get CRC bytes (not really needed by us, but required by SD) */
         SD_IO_WriteByte(SD_DUMMY_BYTE);
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
+    }
+
+    if(!single_sector_read && (SD_StopTransmission() != BSP_SD_OK)) {
+        goto error;
     }
 
     if(single_sector_read) {
@@ -531,42 +544,78 @@ uint8_t BSP_SD_WriteBlocks(
     /* Initialize the address */
     addr = (WriteAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
 
-    /* Data transfer */
-    while(NumOfBlocks--) {
-        /* Send CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) to write blocks  and
-       Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_WRITE_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
+    bool multi_block_write = (NumOfBlocks > 1);
+    if(multi_block_write) {
+        /* Send ACMD23 (SD_CMD_SET_WR_BLK_ERASE_COUNT) to let the card pre-erase
+           blocks which are going to be written. Cards which reject it are not
+           trusted with CMD25 either, blocks are written one by one instead */
+        response = SD_SendCmd(SD_CMD_APP_CMD, 0, 0xFF, SD_ANSWER_R1_EXPECTED);
+        SD_IO_CSState(1);
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        if(response.r1 == SD_R1_NO_ERROR) {
+            response = SD_SendCmd(
+                SD_CMD_SET_WR_BLK_ERASE_COUNT, NumOfBlocks, 0xFF, SD_ANSWER_R1_EXPECTED);
+            SD_IO_CSState(1);
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
+        }
+        multi_block_write = (response.r1 == SD_R1_NO_ERROR);
+    }
+
+    if(!multi_block_write) {
+        while(NumOfBlocks--) {
+            if(SD_WriteSingleBlock((uint8_t*)pData + offset, addr) != BSP_SD_OK) {
+                goto error;
+            }
+            offset += BlockSize;
+            addr += ((flag_SDHC == 1) ? 1 : BlockSize);
+
+            SD_IO_CSState(1);
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
+        }
+    } else {
+        /* Send CMD25 (SD_CMD_WRITE_MULT_BLOCK) to write blocks one after another
+           and Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
+        response = SD_SendCmd(SD_CMD_WRITE_MULT_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
         if(response.r1 != SD_R1_NO_ERROR) {
             goto error;
         }
 
         /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
         SD_IO_WriteByte(SD_DUMMY_BYTE);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
 
-        /* Send the data token to signify the start of the data */
-        SD_IO_WriteByte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
+        /* Data transfer */
+        uint8_t dataresponse = SD_DATA_OK;
+        while(NumOfBlocks--) {
+            /* Send the data token to signify the start of the data */
+            SD_IO_WriteByte(SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE);
 
-        /* Write the block data to SD */
-        SD_IO_WriteReadData((uint8_t*)pData + offset, NULL, BlockSize);
+            /* Write the block data to SD */
+            SD_IO_WriteReadData((uint8_t*)pData + offset, NULL, BlockSize);
+            offset += BlockSize;
 
-        /* Set next write address */
-        offset += BlockSize;
-        addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
+            /* Put CRC bytes (not really needed by us, but required by SD) */
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
 
-        /* Put CRC bytes (not really needed by us, but required by SD) */
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
+            /* Read data response, card is not busy after it */
+            dataresponse = SD_GetDataResponse();
+            if(dataresponse != SD_DATA_OK) {
+                break;
+            }
+        }
 
-        /* Read data response */
-        if(SD_GetDataResponse() != SD_DATA_OK) {
-            /* Set response value to failure */
+        /* Send stop token even on failure, to get the card out of receive state */
+        SD_IO_WriteByte(SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE);
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        if(SD_WaitNotBusy() != BSP_SD_OK) {
             goto error;
         }
 
-        SD_IO_CSState(1);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        if(dataresponse != SD_DATA_OK) {
+            goto error;
+        }
     }
+
     retr = BSP_SD_OK;
 
 error:
@@ -927,8 +976,9 @@ uint8_t SD_GetDataResponse(void) {
         SD_IO_CSState(0);
 
         /* Wait IO line return 0xFF */
-        while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
-            ;
+        if(SD_WaitNotBusy() != BSP_SD_OK) {
+            rvalue = SD_DATA_OTHER_ERROR;
+        }
         break;
     case SD_DATA_CRC_ERROR:
         rvalue = SD_DATA_CRC_ERROR;
@@ -1048,6 +1098,81 @@ uint8_t SD_GoIdleState(void) {
     return BSP_SD_OK;
 }
 
+/**
+  * @brief  Stops multiple block read.
+  *         CMD12 is followed by a stuff byte which has to be skipped,
+  *         then the R1 answer with busy signal.
+  * @param  None
+  * @retval SD status
+  */
+uint8_t SD_StopTransmission(void) {
+    uint8_t frame[SD_CMD_LENGTH] = {(SD_CMD_STOP_TRANSMISSION | 0x40), 0, 0, 0, 0, 0xFF};
+    uint8_t response;
+
+    SD_IO_WriteReadData(frame, NULL, SD_CMD_LENGTH);
+
+    /* Skip stuff byte */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    response = SD_ReadData();
+    if(SD_WaitNotBusy() != BSP_SD_OK) {
+        return BSP_SD_ERROR;
+    }
+
+    return (response == SD_R1_NO_ERROR) ? BSP_SD_OK : BSP_SD_ERROR;
+}
+
+/**
+  * @brief  Waits until the card releases the busy signal
+  * @param  None
+  * @retval BSP_SD_ERROR if the card is still busy after SD_BUSY_TIMEOUT_US
+  */
+uint8_t SD_WaitNotBusy(void) {
+    FuriHalCortexTimer timer = furi_hal_cortex_timer_get(SD_BUSY_TIMEOUT_US);
+
+    /* Wait IO line return 0xFF */
+    while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF) {
+        if(furi_hal_cortex_timer_is_expired(timer)) {
+            return BSP_SD_ERROR;
+        }
+    }
+
+    return BSP_SD_OK;
+}
+
+/**
+  * @brief  Writes one block with CMD24, CS is left low
+  * @param  pData: Pointer to the block data
+  * @param  Addr: Card address of the block, in bytes or blocks depending on card type
+  * @retval SD status
+  */
+uint8_t SD_WriteSingleBlock(uint8_t* pData, uint32_t Addr) {
+    SD_CmdAnswer_typedef response;
+
+    /* Send CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) to write block and
+       Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(SD_CMD_WRITE_SINGLE_BLOCK, Addr, 0xFF, SD_ANSWER_R1_EXPECTED);
+    if(response.r1 != SD_R1_NO_ERROR) {
+        return BSP_SD_ERROR;
+    }
+
+    /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+
+    /* Send the data token to signify the start of the data */
+    SD_IO_WriteByte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
+
+    /* Write the block data to SD */
+    SD_IO_WriteReadData(pData, NULL, 512);
+
+    /* Put CRC bytes (not really needed by us, but required by SD) */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+
+    /* Read data response */
+    return (SD_GetDataResponse() == SD_DATA_OK) ? BSP_SD_OK : BSP_SD_ERROR;
+}
+
 /**
   * @brief  Waits a data until a value different from SD_DUMMY_BITE
   * @param  None
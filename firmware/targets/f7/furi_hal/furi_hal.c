@@ -60,6 +60,7 @@ void furi_hal_init() {
     FURI_LOG_I(TAG, "Speaker OK");
 
     furi_hal_crypto_init();
+    furi_hal_crc_init();
 
     furi_hal_i2c_init();
 
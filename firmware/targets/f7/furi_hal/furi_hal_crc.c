@@ -0,0 +1,55 @@
+#include <furi_hal_crc.h>
+#include <furi.h>
+
+#include <stm32wbxx_ll_crc.h>
+
+#define TAG "FuriHalCrc"
+
+static FuriMutex* furi_hal_crc_mutex = NULL;
+
+void furi_hal_crc_init() {
+    furi_hal_crc_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    // CRC-32 polynomial, bits of every input byte and of the result are reversed
+    LL_CRC_SetPolynomialSize(CRC, LL_CRC_POLYLENGTH_32B);
+    LL_CRC_SetPolynomialCoef(CRC, LL_CRC_DEFAULT_CRC32_POLY);
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+
+    FURI_LOG_I(TAG, "Init OK");
+}
+
+uint32_t furi_hal_crc32(uint32_t crc, const void* buffer, size_t size) {
+    furi_assert(furi_hal_crc_mutex);
+    furi_check(!FURI_IS_ISR());
+    const uint8_t* data = buffer;
+
+    furi_check(furi_mutex_acquire(furi_hal_crc_mutex, FuriWaitForever) == FuriStatusOk);
+
+    // Unit works in not reflected domain: continue from previous value
+    LL_CRC_SetInitialData(CRC, __RBIT(~crc));
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+
+    while(size && ((uintptr_t)data & 3)) {
+        LL_CRC_FeedData8(CRC, *data++);
+        size--;
+    }
+
+    // Unit takes words MSB first, swap so bytes go in memory order
+    const uint32_t* word = (const uint32_t*)data;
+    while(size >= 4) {
+        LL_CRC_FeedData32(CRC, __REV(*word++));
+        size -= 4;
+    }
+
+    data = (const uint8_t*)word;
+    while(size--) {
+        LL_CRC_FeedData8(CRC, *data++);
+    }
+
+    crc = ~LL_CRC_ReadData32(CRC);
+
+    furi_check(furi_mutex_release(furi_hal_crc_mutex) == FuriStatusOk);
+
+    return crc;
+}
@@ -1,24 +1,47 @@
 #include <furi_hal_ibutton.h>
 #include <furi_hal_interrupt.h>
 #include <furi_hal_resources.h>
+#include <furi_hal_cortex.h>
 
 #include <stm32wbxx_ll_tim.h>
 #include <stm32wbxx_ll_exti.h>
+#include <stm32wbxx_ll_dma.h>
 
 #include <furi.h>
+#include <string.h>
 
 #define FURI_HAL_IBUTTON_TIMER TIM1
 #define FURI_HAL_IBUTTON_TIMER_IRQ FuriHalInterruptIdTim1UpTim16
 
+// iButton pin is TIM1_CH2N, CH3 compare triggers pin sampling
+#define FURI_HAL_IBUTTON_SLOTS_CHANNEL LL_TIM_CHANNEL_CH2
+#define FURI_HAL_IBUTTON_SLOTS_CHANNEL_OUT LL_TIM_CHANNEL_CH2N
+#define FURI_HAL_IBUTTON_SLOTS_CHANNEL_SAMPLE LL_TIM_CHANNEL_CH3
+#define FURI_HAL_IBUTTON_SLOTS_DMA DMA1
+#define FURI_HAL_IBUTTON_SLOTS_DMA_PULSE LL_DMA_CHANNEL_1
+#define FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE LL_DMA_CHANNEL_2
+#define FURI_HAL_IBUTTON_SLOTS_DMA_IRQ FuriHalInterruptIdDma1Ch2
+// Transfer timeout on top of its duration
+#define FURI_HAL_IBUTTON_SLOTS_MARGIN_US 10000UL
+
 typedef enum {
     FuriHalIbuttonStateIdle,
     FuriHalIbuttonStateRunning,
+    FuriHalIbuttonStateSlots,
 } FuriHalIbuttonState;
 
+typedef struct {
+    FuriSemaphore* done;
+    // Two trailing idle slots: one is preloaded while the last slot runs, one is sampled last
+    uint16_t pulse[FURI_HAL_IBUTTON_SLOTS_MAX + 2];
+    uint16_t sample[FURI_HAL_IBUTTON_SLOTS_MAX + 1];
+} FuriHalIbuttonSlots;
+
 typedef struct {
     FuriHalIbuttonState state;
     FuriHalIbuttonEmulateCallback callback;
     void* context;
+    FuriHalIbuttonSlots* slots;
 } FuriHalIbutton;
 
 FuriHalIbutton* furi_hal_ibutton = NULL;
@@ -89,6 +112,168 @@ void furi_hal_ibutton_emulate_stop() {
     }
 }
 
+static void furi_hal_ibutton_slots_dma_isr() {
+    if(LL_DMA_IsActiveFlag_TC2(FURI_HAL_IBUTTON_SLOTS_DMA)) {
+        LL_DMA_ClearFlag_TC2(FURI_HAL_IBUTTON_SLOTS_DMA);
+        LL_TIM_DisableCounter(FURI_HAL_IBUTTON_TIMER);
+        furi_semaphore_release(furi_hal_ibutton->slots->done);
+    }
+}
+
+void furi_hal_ibutton_slots_start() {
+    furi_assert(furi_hal_ibutton);
+    furi_assert(furi_hal_ibutton->state == FuriHalIbuttonStateIdle);
+
+    furi_hal_ibutton->state = FuriHalIbuttonStateSlots;
+    furi_hal_ibutton->slots = malloc(sizeof(FuriHalIbuttonSlots));
+    furi_hal_ibutton->slots->done = furi_semaphore_alloc(1, 0);
+
+    FURI_CRITICAL_ENTER();
+    LL_TIM_DeInit(FURI_HAL_IBUTTON_TIMER);
+    FURI_CRITICAL_EXIT();
+
+    // 1 us resolution, one timer period is one time slot
+    LL_TIM_SetPrescaler(FURI_HAL_IBUTTON_TIMER, SystemCoreClock / 1000000 - 1);
+    LL_TIM_SetCounterMode(FURI_HAL_IBUTTON_TIMER, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_EnableARRPreload(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_SetRepetitionCounter(FURI_HAL_IBUTTON_TIMER, 0);
+    LL_TIM_SetClockDivision(FURI_HAL_IBUTTON_TIMER, LL_TIM_CLOCKDIVISION_DIV1);
+    LL_TIM_SetClockSource(FURI_HAL_IBUTTON_TIMER, LL_TIM_CLOCKSOURCE_INTERNAL);
+
+    // Pin is pulled low from the slot start until the compare match
+    LL_TIM_OC_InitTypeDef TIM_OC_InitStruct = {0};
+    TIM_OC_InitStruct.OCMode = LL_TIM_OCMODE_PWM1;
+    TIM_OC_InitStruct.OCNState = LL_TIM_OCSTATE_ENABLE;
+    TIM_OC_InitStruct.OCNPolarity = LL_TIM_OCPOLARITY_LOW;
+    TIM_OC_InitStruct.CompareValue = 0;
+    LL_TIM_OC_Init(FURI_HAL_IBUTTON_TIMER, FURI_HAL_IBUTTON_SLOTS_CHANNEL, &TIM_OC_InitStruct);
+    LL_TIM_OC_EnablePreload(FURI_HAL_IBUTTON_TIMER, FURI_HAL_IBUTTON_SLOTS_CHANNEL);
+    LL_TIM_OC_SetMode(
+        FURI_HAL_IBUTTON_TIMER, FURI_HAL_IBUTTON_SLOTS_CHANNEL_SAMPLE, LL_TIM_OCMODE_FROZEN);
+
+    LL_TIM_GenerateEvent_UPDATE(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_EnableAllOutputs(FURI_HAL_IBUTTON_TIMER);
+
+    furi_hal_ibutton_pin_high();
+    furi_hal_gpio_init_ex(
+        &ibutton_gpio, GpioModeAltFunctionOpenDrain, GpioPullNo, GpioSpeedLow, GpioAltFn1TIM1);
+
+    furi_hal_interrupt_set_isr(
+        FURI_HAL_IBUTTON_SLOTS_DMA_IRQ, furi_hal_ibutton_slots_dma_isr, NULL);
+}
+
+void furi_hal_ibutton_slots_transfer(
+    const uint16_t* pulse,
+    bool* level,
+    size_t count,
+    uint16_t period,
+    uint16_t sample) {
+    furi_assert(furi_hal_ibutton);
+    furi_assert(furi_hal_ibutton->state == FuriHalIbuttonStateSlots);
+    furi_assert(count > 0 && count <= FURI_HAL_IBUTTON_SLOTS_MAX);
+    furi_assert(sample < period);
+
+    FuriHalIbuttonSlots* slots = furi_hal_ibutton->slots;
+    memcpy(slots->pulse, pulse, sizeof(uint16_t) * count);
+    slots->pulse[count] = 0;
+    slots->pulse[count + 1] = 0;
+
+    // Interrupts or kernel are masked (critical section): poll for completion,
+    // slot timing is done by hardware anyway
+    bool poll = FURI_IS_ISR() || (__get_BASEPRI() != 0U);
+
+    // First slot goes to shadow register on update, second one waits in preload
+    LL_TIM_SetAutoReload(FURI_HAL_IBUTTON_TIMER, period - 1);
+    LL_TIM_OC_SetCompareCH3(FURI_HAL_IBUTTON_TIMER, sample);
+    LL_TIM_OC_SetCompareCH2(FURI_HAL_IBUTTON_TIMER, slots->pulse[0]);
+    LL_TIM_GenerateEvent_UPDATE(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_OC_SetCompareCH2(FURI_HAL_IBUTTON_TIMER, slots->pulse[1]);
+    LL_TIM_ClearFlag_CC3(FURI_HAL_IBUTTON_TIMER);
+
+    // configure DMA "mem -> CCR2" channel, next slot on every update
+    LL_DMA_InitTypeDef dma_config = {0};
+    dma_config.PeriphOrM2MSrcAddress = (uint32_t) & (FURI_HAL_IBUTTON_TIMER->CCR2);
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)&slots->pulse[2];
+    dma_config.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_config.Mode = LL_DMA_MODE_NORMAL;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_WORD;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_HALFWORD;
+    dma_config.NbData = count;
+    dma_config.PeriphRequest = LL_DMAMUX_REQ_TIM1_UP;
+    dma_config.Priority = LL_DMA_PRIORITY_VERYHIGH;
+    LL_DMA_Init(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_PULSE, &dma_config);
+    LL_DMA_EnableChannel(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_PULSE);
+
+    // configure DMA "IDR -> mem" channel, one sample per slot plus the trailing idle one
+    dma_config.PeriphOrM2MSrcAddress = (uint32_t) & (ibutton_gpio.port->IDR);
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)slots->sample;
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.NbData = count + 1;
+    dma_config.PeriphRequest = LL_DMAMUX_REQ_TIM1_CH3;
+    LL_DMA_Init(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE, &dma_config);
+    LL_DMA_ClearFlag_TC2(FURI_HAL_IBUTTON_SLOTS_DMA);
+    if(!poll) {
+        LL_DMA_EnableIT_TC(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE);
+    }
+    LL_DMA_EnableChannel(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE);
+
+    LL_TIM_EnableDMAReq_UPDATE(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_EnableDMAReq_CC3(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_EnableCounter(FURI_HAL_IBUTTON_TIMER);
+
+    if(poll) {
+        FuriHalCortexTimer timer =
+            furi_hal_cortex_timer_get(((count + 1) * period + FURI_HAL_IBUTTON_SLOTS_MARGIN_US));
+        while(!LL_DMA_IsActiveFlag_TC2(FURI_HAL_IBUTTON_SLOTS_DMA)) {
+            furi_check(!furi_hal_cortex_timer_is_expired(timer));
+        }
+        LL_DMA_ClearFlag_TC2(FURI_HAL_IBUTTON_SLOTS_DMA);
+        LL_TIM_DisableCounter(FURI_HAL_IBUTTON_TIMER);
+    } else {
+        uint32_t timeout = furi_ms_to_ticks(
+            ((count + 1) * period + FURI_HAL_IBUTTON_SLOTS_MARGIN_US) / 1000 + 1);
+        furi_check(furi_semaphore_acquire(slots->done, timeout) == FuriStatusOk);
+    }
+
+    LL_TIM_DisableDMAReq_UPDATE(FURI_HAL_IBUTTON_TIMER);
+    LL_TIM_DisableDMAReq_CC3(FURI_HAL_IBUTTON_TIMER);
+    LL_DMA_DisableIT_TC(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE);
+    LL_DMA_DisableChannel(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_PULSE);
+    LL_DMA_DisableChannel(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE);
+
+    if(level) {
+        for(size_t i = 0; i < count; i++) {
+            level[i] = (slots->sample[i] & ibutton_gpio.pin) != 0;
+        }
+    }
+}
+
+void furi_hal_ibutton_slots_stop() {
+    furi_assert(furi_hal_ibutton);
+
+    if(furi_hal_ibutton->state == FuriHalIbuttonStateSlots) {
+        furi_hal_ibutton->state = FuriHalIbuttonStateIdle;
+
+        furi_hal_ibutton_pin_high();
+        furi_hal_gpio_init(&ibutton_gpio, GpioModeOutputOpenDrain, GpioPullNo, GpioSpeedLow);
+
+        LL_TIM_DisableCounter(FURI_HAL_IBUTTON_TIMER);
+        FURI_CRITICAL_ENTER();
+        LL_TIM_DeInit(FURI_HAL_IBUTTON_TIMER);
+        LL_DMA_DeInit(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_PULSE);
+        LL_DMA_DeInit(FURI_HAL_IBUTTON_SLOTS_DMA, FURI_HAL_IBUTTON_SLOTS_DMA_SAMPLE);
+        FURI_CRITICAL_EXIT();
+
+        furi_hal_interrupt_set_isr(FURI_HAL_IBUTTON_SLOTS_DMA_IRQ, NULL, NULL);
+
+        furi_semaphore_free(furi_hal_ibutton->slots->done);
+        free(furi_hal_ibutton->slots);
+        furi_hal_ibutton->slots = NULL;
+    }
+}
+
 void furi_hal_ibutton_start_drive() {
     furi_hal_ibutton_pin_high();
     furi_hal_gpio_init(&ibutton_gpio, GpioModeOutputOpenDrain, GpioPullNo, GpioSpeedLow);
@@ -1,5 +1,6 @@
 #include "furi_hal_interrupt.h"
 #include "furi_hal_os.h"
+#include "furi_hal_cortex.h"
 
 #include <furi.h>
 
@@ -19,6 +20,14 @@ typedef struct {
 
 FuriHalInterruptISRPair furi_hal_interrupt_isr[FuriHalInterruptIdMax] = {0};
 
+typedef struct {
+    uint32_t nesting;
+    uint32_t start;
+    uint64_t cycles;
+} FuriHalInterruptTime;
+
+static volatile FuriHalInterruptTime furi_hal_interrupt_time = {0};
+
 const IRQn_Type furi_hal_interrupt_irqn[FuriHalInterruptIdMax] = {
     // TIM1, TIM16, TIM17
     [FuriHalInterruptIdTim1TrgComTim17] = TIM1_TRG_COM_TIM17_IRQn,
@@ -60,10 +69,25 @@ const IRQn_Type furi_hal_interrupt_irqn[FuriHalInterruptIdMax] = {
     [FuriHalInterruptIdLpTim2] = LPTIM2_IRQn,
 };
 
+/* Nested handlers are counted as part of outer one */
+__attribute__((always_inline)) static inline void furi_hal_interrupt_time_enter() {
+    if(furi_hal_interrupt_time.nesting++ == 0) {
+        furi_hal_interrupt_time.start = DWT->CYCCNT;
+    }
+}
+
+__attribute__((always_inline)) static inline void furi_hal_interrupt_time_exit() {
+    if(--furi_hal_interrupt_time.nesting == 0) {
+        furi_hal_interrupt_time.cycles += DWT->CYCCNT - furi_hal_interrupt_time.start;
+    }
+}
+
 __attribute__((always_inline)) static inline void
     furi_hal_interrupt_call(FuriHalInterruptId index) {
     furi_assert(furi_hal_interrupt_isr[index].isr);
+    furi_hal_interrupt_time_enter();
     furi_hal_interrupt_isr[index].isr(furi_hal_interrupt_isr[index].context);
+    furi_hal_interrupt_time_exit();
 }
 
 __attribute__((always_inline)) static inline void
@@ -137,6 +161,15 @@ void furi_hal_interrupt_set_isr_ex(
     }
 }
 
+uint64_t furi_hal_interrupt_get_time_total() {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint64_t cycles = furi_hal_interrupt_time.cycles;
+    __set_PRIMASK(primask);
+
+    return cycles / furi_hal_cortex_instructions_per_microsecond();
+}
+
 /* Timer 2 */
 void TIM2_IRQHandler() {
     furi_hal_interrupt_call(FuriHalInterruptIdTIM2);
@@ -282,12 +315,16 @@ extern void HW_IPCC_Tx_Handler();
 extern void HW_IPCC_Rx_Handler();
 
 void SysTick_Handler() {
+    furi_hal_interrupt_time_enter();
     furi_hal_os_tick();
+    furi_hal_interrupt_time_exit();
 }
 
 void USB_LP_IRQHandler() {
 #ifndef FURI_RAM_EXEC
+    furi_hal_interrupt_time_enter();
     usbd_poll(&udev);
+    furi_hal_interrupt_time_exit();
 #endif
 }
 
@@ -295,11 +332,15 @@ void USB_HP_IRQHandler() {
 }
 
 void IPCC_C1_TX_IRQHandler() {
+    furi_hal_interrupt_time_enter();
     HW_IPCC_Tx_Handler();
+    furi_hal_interrupt_time_exit();
 }
 
 void IPCC_C1_RX_IRQHandler() {
+    furi_hal_interrupt_time_enter();
     HW_IPCC_Rx_Handler();
+    furi_hal_interrupt_time_exit();
 }
 
 void FPU_IRQHandler() {
@@ -77,6 +77,13 @@ void furi_hal_interrupt_set_isr_ex(
     FuriHalInterruptISR isr,
     void* context);
 
+/** Get time spent in interrupt handlers
+ * Counts handlers dispatched by this module, SysTick, USB and IPCC ones.
+ *
+ * @return     time in microseconds
+ */
+uint64_t furi_hal_interrupt_get_time_total();
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,7 @@
 
 #define FURI_HAL_IDLE_TIMER_CLK_HZ 32768
 #define FURI_HAL_OS_TICK_HZ configTICK_RATE_HZ
+#define FURI_HAL_OS_US_PER_TICK (1000000UL / FURI_HAL_OS_TICK_HZ)
 
 #define FURI_HAL_OS_IDLE_CNT_TO_TICKS(x) (((x)*FURI_HAL_OS_TICK_HZ) / FURI_HAL_IDLE_TIMER_CLK_HZ)
 #define FURI_HAL_OS_TICKS_TO_IDLE_CNT(x) (((x)*FURI_HAL_IDLE_TIMER_CLK_HZ) / FURI_HAL_OS_TICK_HZ)
@@ -40,6 +41,14 @@ extern void xPortSysTickHandler();
 
 static volatile uint32_t furi_hal_os_skew;
 
+typedef struct {
+    uint64_t last;
+    uint32_t last_tick;
+    uint32_t tick_epoch;
+} FuriHalOsRuntime;
+
+static FuriHalOsRuntime furi_hal_os_runtime = {0};
+
 void furi_hal_os_init() {
     furi_hal_idle_timer_init();
 
@@ -64,6 +73,41 @@ void furi_hal_os_tick() {
     }
 }
 
+uint64_t furi_hal_os_get_runtime() {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t tick = xTaskGetTickCount();
+    uint32_t reload = SysTick->LOAD;
+    uint32_t value = SysTick->VAL;
+    // Counter wrapped, but tick is not counted yet
+    if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        tick++;
+        value = SysTick->VAL;
+    }
+
+    // Tick counter overflow, stale tick is just a bit behind
+    if(tick < furi_hal_os_runtime.last_tick &&
+       furi_hal_os_runtime.last_tick - tick > (UINT32_MAX / 2)) {
+        furi_hal_os_runtime.tick_epoch++;
+    }
+    furi_hal_os_runtime.last_tick = tick;
+
+    uint64_t runtime = (((uint64_t)furi_hal_os_runtime.tick_epoch << 32) | tick) *
+                           FURI_HAL_OS_US_PER_TICK +
+                       (reload - value) * FURI_HAL_OS_US_PER_TICK / (reload + 1);
+
+    // Ticks are not counted while scheduler is suspended, never go back
+    if(runtime < furi_hal_os_runtime.last) {
+        runtime = furi_hal_os_runtime.last;
+    } else {
+        furi_hal_os_runtime.last = runtime;
+    }
+
+    __set_PRIMASK(primask);
+    return runtime;
+}
+
 #ifdef FURI_HAL_OS_DEBUG
 // Find out the IRQ number while debugging
 static void furi_hal_os_nvic_dbg_trap() {
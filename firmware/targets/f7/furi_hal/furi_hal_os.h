@@ -15,6 +15,11 @@ void furi_hal_os_init();
  */
 void furi_hal_os_tick();
 
+/* Get run time counter for OS run time stats
+ * Monotonic, in microseconds, includes time spent in sleep
+ */
+uint64_t furi_hal_os_get_runtime();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,101 @@
+#include <furi_hal_sampler.h>
+#include <furi_hal_interrupt.h>
+#include <furi_hal_power.h>
+#include <furi.h>
+
+#include <stm32wbxx_ll_tim.h>
+
+#define TAG "FuriHalSampler"
+
+#define FURI_HAL_SAMPLER_TIMER TIM17
+#define FURI_HAL_SAMPLER_TIMER_IRQ FuriHalInterruptIdTim1TrgComTim17
+// 1 MHz timer clock
+#define FURI_HAL_SAMPLER_PRESCALER (64 - 1)
+#define FURI_HAL_SAMPLER_TIMER_FREQUENCY 1000000UL
+// Highest priority allowed to use kernel state, critical sections mask the sampler
+#define FURI_HAL_SAMPLER_PRIORITY configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+
+#define FURI_HAL_SAMPLER_FREQUENCY_MIN 10
+#define FURI_HAL_SAMPLER_FREQUENCY_MAX 10000
+
+// Program counter position in exception stack frame
+#define FURI_HAL_SAMPLER_FRAME_PC 6
+
+typedef struct {
+    FuriHalSamplerCallback callback;
+    void* context;
+} FuriHalSampler;
+
+static FuriHalSampler furi_hal_sampler = {0};
+
+static void furi_hal_sampler_isr(void* context) {
+    UNUSED(context);
+
+    if(LL_TIM_IsActiveFlag_UPDATE(FURI_HAL_SAMPLER_TIMER)) {
+        LL_TIM_ClearFlag_UPDATE(FURI_HAL_SAMPLER_TIMER);
+
+        uint32_t pc = 0;
+        // No other active exceptions: we preempted a thread, its frame is on process stack
+        if(SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) {
+            pc = ((uint32_t*)__get_PSP())[FURI_HAL_SAMPLER_FRAME_PC];
+        }
+
+        furi_hal_sampler.callback(pc, furi_hal_sampler.context);
+    }
+}
+
+void furi_hal_sampler_start(uint32_t frequency, FuriHalSamplerCallback callback, void* context) {
+    furi_check(!FURI_IS_IRQ_MODE());
+    furi_check(!furi_hal_sampler.callback);
+    furi_check(callback);
+    furi_check(
+        frequency >= FURI_HAL_SAMPLER_FREQUENCY_MIN &&
+        frequency <= FURI_HAL_SAMPLER_FREQUENCY_MAX);
+
+    furi_hal_sampler.callback = callback;
+    furi_hal_sampler.context = context;
+
+    // Timer is stopped in deep sleep
+    furi_hal_power_insomnia_enter();
+
+    FURI_CRITICAL_ENTER();
+    LL_TIM_DeInit(FURI_HAL_SAMPLER_TIMER);
+    FURI_CRITICAL_EXIT();
+
+    LL_TIM_SetPrescaler(FURI_HAL_SAMPLER_TIMER, FURI_HAL_SAMPLER_PRESCALER);
+    LL_TIM_SetAutoReload(
+        FURI_HAL_SAMPLER_TIMER, FURI_HAL_SAMPLER_TIMER_FREQUENCY / frequency - 1);
+    LL_TIM_SetCounterMode(FURI_HAL_SAMPLER_TIMER, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_GenerateEvent_UPDATE(FURI_HAL_SAMPLER_TIMER);
+    LL_TIM_ClearFlag_UPDATE(FURI_HAL_SAMPLER_TIMER);
+
+    furi_hal_interrupt_set_isr_ex(
+        FURI_HAL_SAMPLER_TIMER_IRQ, FURI_HAL_SAMPLER_PRIORITY, furi_hal_sampler_isr, NULL);
+
+    LL_TIM_EnableIT_UPDATE(FURI_HAL_SAMPLER_TIMER);
+    LL_TIM_EnableCounter(FURI_HAL_SAMPLER_TIMER);
+
+    FURI_LOG_I(TAG, "Sampling at %lu Hz", frequency);
+}
+
+void furi_hal_sampler_stop() {
+    furi_check(!FURI_IS_IRQ_MODE());
+    furi_check(furi_hal_sampler.callback);
+
+    LL_TIM_DisableCounter(FURI_HAL_SAMPLER_TIMER);
+    LL_TIM_DisableIT_UPDATE(FURI_HAL_SAMPLER_TIMER);
+    furi_hal_interrupt_set_isr(FURI_HAL_SAMPLER_TIMER_IRQ, NULL, NULL);
+
+    FURI_CRITICAL_ENTER();
+    LL_TIM_DeInit(FURI_HAL_SAMPLER_TIMER);
+    FURI_CRITICAL_EXIT();
+
+    furi_hal_power_insomnia_exit();
+
+    furi_hal_sampler.callback = NULL;
+    furi_hal_sampler.context = NULL;
+}
+
+bool furi_hal_sampler_is_running() {
+    return furi_hal_sampler.callback != NULL;
+}
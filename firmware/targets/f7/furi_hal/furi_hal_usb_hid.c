@@ -292,6 +292,19 @@ bool furi_hal_hid_kb_press(uint16_t button) {
     return hid_send_report(ReportIdKeyboard);
 }
 
+bool furi_hal_hid_kb_press_multi(const uint16_t* buttons, uint8_t count) {
+    for(uint8_t i = 0; i < count; i++) {
+        for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+            if(hid_report.keyboard.btn[key_nb] == 0) {
+                hid_report.keyboard.btn[key_nb] = buttons[i] & 0xFF;
+                hid_report.keyboard.mods |= (buttons[i] >> 8);
+                break;
+            }
+        }
+    }
+    return hid_send_report(ReportIdKeyboard);
+}
+
 bool furi_hal_hid_kb_release(uint16_t button) {
     for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
         if(hid_report.keyboard.btn[key_nb] == (button & 0xFF)) {
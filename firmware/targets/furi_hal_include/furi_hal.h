@@ -13,6 +13,7 @@ struct STOP_EXTERNING_ME {};
 #include "furi_hal_cortex.h"
 #include "furi_hal_clock.h"
 #include "furi_hal_crypto.h"
+#include "furi_hal_crc.h"
 #include "furi_hal_console.h"
 #include "furi_hal_debug.h"
 #include "furi_hal_os.h"
@@ -41,6 +42,7 @@ struct STOP_EXTERNING_ME {};
 #include "furi_hal_uart.h"
 #include "furi_hal_info.h"
 #include "furi_hal_random.h"
+#include "furi_hal_sampler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,34 @@
+/**
+ * @file furi_hal_crc.h
+ * CRC calculation unit HAL API
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initialize CRC unit
+ */
+void furi_hal_crc_init();
+
+/** Calculate CRC-32 (IEEE 802.3) with CRC unit
+ *
+ * Result is the same as crc32_calc_buffer() one, so calls can be chained
+ * with software implementation. Must not be called from interrupt.
+ *
+ * @param[in]  crc     previous CRC value, 0 for the first block
+ * @param[in]  buffer  data pointer
+ * @param[in]  size    data size
+ *
+ * @return     updated CRC value
+ */
+uint32_t furi_hal_crc32(uint32_t crc, const void* buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "furi_hal_gpio.h"
 
@@ -13,6 +14,9 @@
 extern "C" {
 #endif
 
+/** Maximum number of time slots in one furi_hal_ibutton_slots_transfer call */
+#define FURI_HAL_IBUTTON_SLOTS_MAX 64
+
 typedef void (*FuriHalIbuttonEmulateCallback)(void* context);
 
 /** Initialize */
@@ -27,6 +31,33 @@ void furi_hal_ibutton_emulate_set_next(uint32_t period);
 
 void furi_hal_ibutton_emulate_stop();
 
+/**
+ * Start 1-Wire time slot generator: pin is driven by timer in open collector mode
+ */
+void furi_hal_ibutton_slots_start();
+
+/**
+ * Generate time slots on the pin and sample pin level in every slot.
+ * Slot timing is done by timer and DMA, the caller sleeps until transfer is complete
+ * (or busy waits if called from interrupt or critical section).
+ * @param pulse low time of every slot, us. 0 keeps the pin released
+ * @param level sampled pin level for every slot, can be NULL
+ * @param count slot count, 1..FURI_HAL_IBUTTON_SLOTS_MAX
+ * @param period slot length, us
+ * @param sample sample point from slot start, us
+ */
+void furi_hal_ibutton_slots_transfer(
+    const uint16_t* pulse,
+    bool* level,
+    size_t count,
+    uint16_t period,
+    uint16_t sample);
+
+/**
+ * Stop 1-Wire time slot generator, pin is left in normal mode (open collector)
+ */
+void furi_hal_ibutton_slots_stop();
+
 /**
  * Sets the pin to normal mode (open collector), and sets it to float
  */
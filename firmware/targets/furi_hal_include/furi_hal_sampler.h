@@ -0,0 +1,52 @@
+/**
+ * @file furi_hal_sampler.h
+ * Program counter sampling HAL API
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sample callback, called from timer interrupt
+ *
+ * @param      pc       program counter of interrupted thread, 0 if interrupt
+ *                      handler was interrupted
+ * @param      context  callback context
+ */
+typedef void (*FuriHalSamplerCallback)(uint32_t pc, void* context);
+
+/** Start periodic program counter sampling
+ *
+ * Device is kept out of deep sleep while sampling, so idle time is sampled
+ * too.
+ *
+ * Sampler interrupt runs at the kernel syscall priority, so it is masked by
+ * critical sections and doesn't preempt interrupts of the same priority. A
+ * sample due inside of them is taken right after they end and is attributed
+ * to the code that follows, so time spent in critical sections and handlers
+ * is skewed toward their exit points.
+ *
+ * @param[in]  frequency  sample rate, 10 to 10000 Hz
+ * @param[in]  callback   sample callback
+ * @param      context    callback context
+ */
+void furi_hal_sampler_start(uint32_t frequency, FuriHalSamplerCallback callback, void* context);
+
+/** Stop program counter sampling
+ */
+void furi_hal_sampler_stop();
+
+/** Check if sampling is running
+ *
+ * @return     true if running
+ */
+bool furi_hal_sampler_is_running();
+
+#ifdef __cplusplus
+}
+#endif
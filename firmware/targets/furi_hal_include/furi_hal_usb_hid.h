@@ -206,6 +206,14 @@ void furi_hal_hid_set_state_callback(HidStateCallback cb, void* ctx);
  */
 bool furi_hal_hid_kb_press(uint16_t button);
 
+/** Set several keys to pressed state and send single HID report
+ *
+ * @param      buttons  key codes with modifiers, keys exceeding free report
+ *                      slots are ignored along with their modifiers
+ * @param      count    amount of key codes
+ */
+bool furi_hal_hid_kb_press_multi(const uint16_t* buttons, uint8_t count);
+
 /** Set the following key to released state and send HID report
  *
  * @param      button  key code
@@ -1,5 +1,6 @@
 #include "check.h"
 #include "common_defines.h"
+#include "log.h"
 
 #include <stm32wbxx.h>
 #include <furi_hal_console.h>
@@ -102,6 +103,9 @@ FURI_NORETURN void __furi_crash() {
         __furi_check_message = "Fatal Error";
     }
 
+    // Pending log records usually explain the crash
+    furi_log_flush();
+
     furi_hal_console_puts("\r\n\033[0;31m[CRASH]");
     __furi_print_name(isr);
     furi_hal_console_puts(__furi_check_message);
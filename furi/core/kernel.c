@@ -98,6 +98,10 @@ uint32_t furi_kernel_get_tick_frequency() {
     return (configTICK_RATE_HZ_RAW);
 }
 
+uint64_t furi_kernel_get_run_time() {
+    return portGET_RUN_TIME_COUNTER_VALUE();
+}
+
 void furi_delay_tick(uint32_t ticks) {
     furi_assert(!furi_is_irq_context());
     if(ticks == 0U) {
@@ -36,6 +36,14 @@ int32_t furi_kernel_restore_lock(int32_t lock);
  */
 uint32_t furi_kernel_get_tick_frequency();
 
+/** Get kernel run time counter
+ *
+ * Time base for thread run time, includes time spent in sleep.
+ *
+ * @return     run time in microseconds
+ */
+uint64_t furi_kernel_get_run_time();
+
 /** Delay execution
  * 
  * Also keep in mind delay is aliased to scheduler timer intervals.
@@ -1,85 +1,551 @@
 #include "log.h"
 #include "check.h"
-#include "mutex.h"
+#include "thread.h"
+#include "kernel.h"
+#include "common_defines.h"
 #include <furi_hal.h>
+#include <string.h>
+#include CMSIS_device_header
 
 #define FURI_LOG_LEVEL_DEFAULT FuriLogLevelInfo
 
+#define FURI_LOG_RING_SIZE 4096 // must be power of 2
+#define FURI_LOG_RING_MASK (FURI_LOG_RING_SIZE - 1)
+#define FURI_LOG_PAYLOAD_SIZE 192
+#define FURI_LOG_TAG_SIZE 24
+#define FURI_LOG_LINE_SIZE 320
+#define FURI_LOG_SPEC_SIZE 32
+
+#define FURI_LOG_THREAD_STACK_SIZE 2048
+#define FURI_LOG_THREAD_FLAG_PENDING (1UL << 0)
+
+typedef enum {
+    FuriLogRecordStateReserved,
+    FuriLogRecordStateReady,
+    FuriLogRecordStatePad,
+} FuriLogRecordState;
+
+/* Record in ring: header followed by packed arguments.
+ * Tag and format are referenced by pointer only when they live in firmware flash,
+ * otherwise they are copied in front of arguments (NULL pointer in header). */
+typedef struct {
+    uint16_t size; // whole record, 4 bytes aligned
+    uint16_t length; // payload bytes
+    volatile uint8_t state;
+    uint8_t level;
+    uint32_t timestamp;
+    const char* tag;
+    const char* format;
+} FuriLogRecord;
+
+typedef enum {
+    FuriLogArgNone,
+    FuriLogArgInt,
+    FuriLogArgLongLong,
+    FuriLogArgDouble,
+    FuriLogArgPointer,
+    FuriLogArgString,
+    FuriLogArgSkip,
+} FuriLogArgType;
+
+typedef struct {
+    const char* start; // flags, width and precision, may contain '*'
+    const char* start_end;
+    const char* length; // length modifiers
+    const char* length_end;
+    char conversion;
+    FuriLogArgType type;
+} FuriLogSpec;
+
 typedef struct {
     FuriLogLevel log_level;
     FuriLogPuts puts;
     FuriLogTimestamp timestamp;
-    FuriMutex* mutex;
+    FuriThread* thread;
+
+    // Monotonic ring offsets: tail <= read <= write
+    volatile uint32_t write;
+    volatile uint32_t read; // everything before is printed
+    volatile uint32_t tail; // oldest record kept for dump
+    volatile uint32_t dropped;
+    uint32_t dropped_reported;
 } FuriLogParams;
 
 static FuriLogParams furi_log;
+static uint8_t furi_log_ring[FURI_LOG_RING_SIZE] __attribute__((aligned(4)));
+static char furi_log_flush_line[FURI_LOG_LINE_SIZE];
+
+static void furi_log_level_decorate(FuriLogLevel level, const char** color, const char** letter) {
+    *color = FURI_LOG_CLR_RESET;
+    *letter = " ";
+    switch(level) {
+    case FuriLogLevelError:
+        *color = FURI_LOG_CLR_E;
+        *letter = "E";
+        break;
+    case FuriLogLevelWarn:
+        *color = FURI_LOG_CLR_W;
+        *letter = "W";
+        break;
+    case FuriLogLevelInfo:
+        *color = FURI_LOG_CLR_I;
+        *letter = "I";
+        break;
+    case FuriLogLevelDebug:
+        *color = FURI_LOG_CLR_D;
+        *letter = "D";
+        break;
+    case FuriLogLevelTrace:
+        *color = FURI_LOG_CLR_T;
+        *letter = "T";
+        break;
+    default:
+        break;
+    }
+}
+
+static bool furi_log_is_static(const char* string) {
+    // Strings of external applications can be gone by the time record is printed
+    return (uintptr_t)string >= FLASH_BASE &&
+           (uintptr_t)string < (uintptr_t)furi_hal_flash_get_free_start_address();
+}
+
+/* Parse conversion specification, format must point right after '%' */
+static const char* furi_log_parse_spec(const char* format, FuriLogSpec* spec) {
+    spec->start = format;
+    while(*format && strchr("-+ #0", *format)) format++;
+    while(*format == '*' || (*format >= '0' && *format <= '9')) format++;
+    if(*format == '.') {
+        format++;
+        while(*format == '*' || (*format >= '0' && *format <= '9')) format++;
+    }
+    spec->start_end = format;
+
+    spec->length = format;
+    bool long_long = false;
+    while(*format && strchr("hlLqjzt", *format)) {
+        if((format[0] == 'l' && format[1] == 'l') || *format == 'q' || *format == 'j') {
+            long_long = true;
+        }
+        format++;
+    }
+    spec->length_end = format;
+
+    spec->conversion = *format;
+    switch(spec->conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+        spec->type = long_long ? FuriLogArgLongLong : FuriLogArgInt;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec->type = FuriLogArgDouble;
+        break;
+    case 'p':
+        spec->type = FuriLogArgPointer;
+        break;
+    case 's':
+        spec->type = FuriLogArgString;
+        break;
+    case 'n':
+        spec->type = FuriLogArgSkip;
+        break;
+    default:
+        // '%%', unknown or truncated specification
+        spec->type = FuriLogArgNone;
+        break;
+    }
+
+    return *format ? format + 1 : format;
+}
+
+static bool furi_log_pack(uint8_t* payload, size_t* length, const void* data, size_t size) {
+    if(*length + size > FURI_LOG_PAYLOAD_SIZE) return false;
+    memcpy(payload + *length, data, size);
+    *length += size;
+    return true;
+}
+
+static bool
+    furi_log_pack_string(uint8_t* payload, size_t* length, const char* string, size_t max) {
+    if(*length >= FURI_LOG_PAYLOAD_SIZE) return false;
+    size_t size = MIN(strlen(string), MIN(max, FURI_LOG_PAYLOAD_SIZE - *length) - 1);
+    memcpy(payload + *length, string, size);
+    payload[*length + size] = '\0';
+    *length += size + 1;
+    return true;
+}
+
+/* Pack arguments in binary form, stops on first argument that doesn't fit */
+static void
+    furi_log_pack_args(uint8_t* payload, size_t* length, const char* format, va_list args) {
+    FuriLogSpec spec;
+    bool fits = true;
+    while(fits && *format) {
+        if(*format++ != '%') continue;
+        format = furi_log_parse_spec(format, &spec);
+
+        for(const char* p = spec.start; fits && p < spec.start_end; p++) {
+            if(*p == '*') {
+                int value = va_arg(args, int);
+                fits = furi_log_pack(payload, length, &value, sizeof(value));
+            }
+        }
+        if(!fits) break;
+
+        if(spec.type == FuriLogArgInt) {
+            int32_t value = va_arg(args, int);
+            fits = furi_log_pack(payload, length, &value, sizeof(value));
+        } else if(spec.type == FuriLogArgLongLong) {
+            int64_t value = va_arg(args, int64_t);
+            fits = furi_log_pack(payload, length, &value, sizeof(value));
+        } else if(spec.type == FuriLogArgDouble) {
+            double value = va_arg(args, double);
+            fits = furi_log_pack(payload, length, &value, sizeof(value));
+        } else if(spec.type == FuriLogArgPointer) {
+            void* value = va_arg(args, void*);
+            fits = furi_log_pack(payload, length, &value, sizeof(value));
+        } else if(spec.type == FuriLogArgString) {
+            const char* value = va_arg(args, const char*);
+            fits = furi_log_pack_string(
+                payload, length, value ? value : "(null)", FURI_LOG_PAYLOAD_SIZE);
+        } else if(spec.type == FuriLogArgSkip) {
+            (void)va_arg(args, void*);
+        }
+    }
+}
+
+static bool
+    furi_log_unpack(const uint8_t** payload, const uint8_t* end, void* data, size_t size) {
+    if(*payload + size > end) return false;
+    memcpy(data, *payload, size);
+    *payload += size;
+    return true;
+}
+
+/* Format record message, arguments are consumed from payload */
+static size_t furi_log_format_message(
+    char* out,
+    size_t size,
+    const char* format,
+    const uint8_t* payload,
+    const uint8_t* end) {
+    size_t used = 0;
+    char spec_str[FURI_LOG_SPEC_SIZE];
+    FuriLogSpec spec;
+
+    while(*format && used + 1 < size) {
+        if(*format != '%') {
+            out[used++] = *format++;
+            continue;
+        }
+        format = furi_log_parse_spec(format + 1, &spec);
+        if(spec.conversion == '%') {
+            out[used++] = '%';
+            continue;
+        } else if(spec.type == FuriLogArgNone || spec.type == FuriLogArgSkip) {
+            continue;
+        }
+
+        // Rebuild specification with '*' replaced by packed values
+        bool complete = true;
+        size_t spec_len = 0;
+        spec_str[spec_len++] = '%';
+        for(const char* p = spec.start; p < spec.start_end; p++) {
+            bool precision = (p[0] == '.' && p[1] == '*');
+            if(*p == '*' || precision) {
+                int value;
+                complete = furi_log_unpack(&payload, end, &value, sizeof(value));
+                if(!complete) break;
+                if(precision) {
+                    p++;
+                    if(value < 0) continue;
+                    spec_str[spec_len++] = '.';
+                }
+                if(spec_len < FURI_LOG_SPEC_SIZE - 16) {
+                    spec_len += snprintf(spec_str + spec_len, 12, "%d", value);
+                }
+            } else if(spec_len < FURI_LOG_SPEC_SIZE - 16) {
+                spec_str[spec_len++] = *p;
+            }
+        }
+        if(!complete) goto truncated;
+
+        if(spec.type == FuriLogArgInt) {
+            // long and size_t are 32 bit wide, keep only char and short modifiers
+            for(const char* p = spec.length; p < spec.length_end; p++) {
+                if(*p == 'h' && spec_len < FURI_LOG_SPEC_SIZE - 4) {
+                    spec_str[spec_len++] = 'h';
+                }
+            }
+        } else if(spec.type == FuriLogArgLongLong) {
+            spec_str[spec_len++] = 'l';
+            spec_str[spec_len++] = 'l';
+        }
+        spec_str[spec_len++] = spec.conversion;
+        spec_str[spec_len] = '\0';
+
+        int ret = 0;
+        if(spec.type == FuriLogArgInt) {
+            int32_t value;
+            if(!furi_log_unpack(&payload, end, &value, sizeof(value))) goto truncated;
+            ret = snprintf(out + used, size - used, spec_str, value);
+        } else if(spec.type == FuriLogArgLongLong) {
+            int64_t value;
+            if(!furi_log_unpack(&payload, end, &value, sizeof(value))) goto truncated;
+            ret = snprintf(out + used, size - used, spec_str, value);
+        } else if(spec.type == FuriLogArgDouble) {
+            double value;
+            if(!furi_log_unpack(&payload, end, &value, sizeof(value))) goto truncated;
+            ret = snprintf(out + used, size - used, spec_str, value);
+        } else if(spec.type == FuriLogArgPointer) {
+            void* value;
+            if(!furi_log_unpack(&payload, end, &value, sizeof(value))) goto truncated;
+            ret = snprintf(out + used, size - used, spec_str, value);
+        } else if(spec.type == FuriLogArgString) {
+            if(payload >= end) goto truncated;
+            const char* value = (const char*)payload;
+            payload += strnlen(value, end - payload) + 1;
+            ret = snprintf(out + used, size - used, spec_str, value);
+        }
+        if(ret > 0) used = MIN(used + ret, size - 1);
+    }
+    out[used] = '\0';
+    return used;
+
+truncated:
+    // Record was cut by payload size, mark the spot
+    used += snprintf(out + used, size - used, "...");
+    return MIN(used, size - 1);
+}
+
+static void furi_log_format_record(const FuriLogRecord* record, char* out, size_t size) {
+    const uint8_t* payload = (const uint8_t*)(record + 1);
+    const uint8_t* end = payload + record->length;
+
+    const char* tag = record->tag;
+    if(!tag) {
+        tag = (const char*)payload;
+        payload += strnlen(tag, end - payload) + 1;
+    }
+    const char* format = record->format;
+    if(!format) {
+        format = (const char*)payload;
+        payload += strnlen(format, end - payload) + 1;
+    }
+
+    const char* color;
+    const char* log_letter;
+    furi_log_level_decorate(record->level, &color, &log_letter);
+
+    int used = snprintf(
+        out,
+        size,
+        "%lu %s[%s][%s] " FURI_LOG_CLR_RESET,
+        record->timestamp,
+        color,
+        log_letter,
+        tag);
+    used = MIN((size_t)MAX(used, 0), size - 3);
+    used += furi_log_format_message(out + used, size - used - 2, format, payload, end);
+    out[used++] = '\r';
+    out[used++] = '\n';
+    out[used] = '\0';
+}
+
+/* Get record at ring offset, skips tail of ring that can't fit header */
+static FuriLogRecord* furi_log_ring_record(const uint8_t* ring, uint32_t* offset) {
+    uint32_t remain = FURI_LOG_RING_SIZE - (*offset & FURI_LOG_RING_MASK);
+    if(remain < sizeof(FuriLogRecord)) {
+        *offset += remain;
+    }
+    return (FuriLogRecord*)(ring + (*offset & FURI_LOG_RING_MASK));
+}
+
+static FuriLogRecord* furi_log_reserve(size_t size, bool* was_empty) {
+    FuriLogRecord* record = NULL;
+
+    FURI_CRITICAL_ENTER();
+    uint32_t write = furi_log.write;
+    uint32_t remain = FURI_LOG_RING_SIZE - (write & FURI_LOG_RING_MASK);
+    uint32_t skip = (remain < size) ? remain : 0;
+
+    // Reclaim printed records
+    while(write + skip + size - furi_log.tail > FURI_LOG_RING_SIZE &&
+          furi_log.tail != furi_log.read) {
+        uint32_t tail = furi_log.tail;
+        FuriLogRecord* oldest = furi_log_ring_record(furi_log_ring, &tail);
+        furi_log.tail = tail + oldest->size;
+    }
+
+    if(write + skip + size - furi_log.tail > FURI_LOG_RING_SIZE) {
+        furi_log.dropped++;
+    } else {
+        *was_empty = (furi_log.read == write);
+        if(skip >= sizeof(FuriLogRecord)) {
+            record = (FuriLogRecord*)(furi_log_ring + (write & FURI_LOG_RING_MASK));
+            record->size = skip;
+            record->state = FuriLogRecordStatePad;
+        }
+        write += skip;
+        record = (FuriLogRecord*)(furi_log_ring + (write & FURI_LOG_RING_MASK));
+        record->size = size;
+        record->state = FuriLogRecordStateReserved;
+        furi_log.write = write + size;
+    }
+    FURI_CRITICAL_EXIT();
+
+    return record;
+}
+
+/* Print ready records, returns false if head record is not committed yet */
+static bool furi_log_drain(char* line, size_t size) {
+    while(furi_log.read != furi_log.write) {
+        uint32_t read = furi_log.read;
+        FuriLogRecord* record = furi_log_ring_record(furi_log_ring, &read);
+        if(read == furi_log.write) {
+            furi_log.read = read;
+            break;
+        }
+        if(record->state == FuriLogRecordStateReserved) return false;
+        if(record->state == FuriLogRecordStateReady) {
+            furi_log_format_record(record, line, size);
+            furi_log.puts(line);
+        }
+        furi_log.read = read + record->size;
+    }
+
+    uint32_t dropped = furi_log.dropped;
+    if(dropped != furi_log.dropped_reported) {
+        snprintf(
+            line,
+            size,
+            "%lu " FURI_LOG_CLR_W "[W][Log] " FURI_LOG_CLR_RESET "%lu records dropped\r\n",
+            furi_log.timestamp(),
+            dropped - furi_log.dropped_reported);
+        furi_log.dropped_reported = dropped;
+        furi_log.puts(line);
+    }
+
+    return true;
+}
+
+static int32_t furi_log_thread(void* context) {
+    UNUSED(context);
+    char line[FURI_LOG_LINE_SIZE];
+
+    while(true) {
+        if(furi_log_drain(line, sizeof(line))) {
+            furi_thread_flags_wait(FURI_LOG_THREAD_FLAG_PENDING, FuriFlagWaitAny, FuriWaitForever);
+        } else {
+            // Writer was preempted between reserve and commit
+            furi_delay_tick(1);
+        }
+    }
+
+    return 0;
+}
 
 void furi_log_init() {
     // Set default logging parameters
     furi_log.log_level = FURI_LOG_LEVEL_DEFAULT;
     furi_log.puts = furi_hal_console_puts;
     furi_log.timestamp = furi_get_tick;
-    furi_log.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+}
+
+void furi_log_start() {
+    furi_assert(!furi_log.thread);
+    FuriThread* thread =
+        furi_thread_alloc_ex("LogDrain", FURI_LOG_THREAD_STACK_SIZE, furi_log_thread, NULL);
+    furi_thread_mark_as_service(thread);
+    furi_thread_set_priority(thread, FuriThreadPriorityLowest);
+    furi_thread_start(thread);
+    furi_log.thread = thread;
 }
 
 void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
-    if(level <= furi_log.log_level &&
-       furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk) {
-        FuriString* string;
-        string = furi_string_alloc();
-
-        const char* color = FURI_LOG_CLR_RESET;
-        const char* log_letter = " ";
-        switch(level) {
-        case FuriLogLevelError:
-            color = FURI_LOG_CLR_E;
-            log_letter = "E";
-            break;
-        case FuriLogLevelWarn:
-            color = FURI_LOG_CLR_W;
-            log_letter = "W";
-            break;
-        case FuriLogLevelInfo:
-            color = FURI_LOG_CLR_I;
-            log_letter = "I";
-            break;
-        case FuriLogLevelDebug:
-            color = FURI_LOG_CLR_D;
-            log_letter = "D";
-            break;
-        case FuriLogLevelTrace:
-            color = FURI_LOG_CLR_T;
-            log_letter = "T";
-            break;
-        default:
-            break;
-        }
+    if(level > furi_log.log_level) return;
 
-        // Timestamp
-        furi_string_printf(
-            string,
-            "%lu %s[%s][%s] " FURI_LOG_CLR_RESET,
-            furi_log.timestamp(),
-            color,
-            log_letter,
-            tag);
-        furi_log.puts(furi_string_get_cstr(string));
-        furi_string_reset(string);
+    uint32_t timestamp = furi_log.timestamp();
 
-        va_list args;
-        va_start(args, format);
-        furi_string_vprintf(string, format, args);
-        va_end(args);
+    uint8_t payload[FURI_LOG_PAYLOAD_SIZE];
+    size_t length = 0;
+    if(!furi_log_is_static(tag)) {
+        furi_log_pack_string(payload, &length, tag, FURI_LOG_TAG_SIZE);
+    }
+    if(!furi_log_is_static(format)) {
+        furi_log_pack_string(payload, &length, format, FURI_LOG_PAYLOAD_SIZE);
+    }
+    va_list args;
+    va_start(args, format);
+    furi_log_pack_args(payload, &length, format, args);
+    va_end(args);
 
-        furi_log.puts(furi_string_get_cstr(string));
-        furi_string_free(string);
+    size_t size = (sizeof(FuriLogRecord) + length + 3) & ~3UL;
+    bool was_empty = false;
+    FuriLogRecord* record = furi_log_reserve(size, &was_empty);
+    if(!record) return;
 
-        furi_log.puts("\r\n");
+    record->length = length;
+    record->level = level;
+    record->timestamp = timestamp;
+    record->tag = furi_log_is_static(tag) ? tag : NULL;
+    record->format = furi_log_is_static(format) ? format : NULL;
+    memcpy(record + 1, payload, length);
+    __DMB();
+    record->state = FuriLogRecordStateReady;
 
-        furi_mutex_release(furi_log.mutex);
+    // Drain thread goes through all records before sleeping, wake it only once
+    if(was_empty && furi_log.thread) {
+        furi_thread_flags_set(furi_thread_get_id(furi_log.thread), FURI_LOG_THREAD_FLAG_PENDING);
     }
 }
 
+void furi_log_flush() {
+    furi_log_drain(furi_log_flush_line, sizeof(furi_log_flush_line));
+}
+
+void furi_log_dump(FuriLogPuts puts) {
+    furi_assert(puts);
+    uint8_t* ring = malloc(FURI_LOG_RING_SIZE);
+    char* line = malloc(FURI_LOG_LINE_SIZE);
+    uint32_t offset, write, dropped;
+
+    FURI_CRITICAL_ENTER();
+    memcpy(ring, furi_log_ring, FURI_LOG_RING_SIZE);
+    offset = furi_log.tail;
+    write = furi_log.write;
+    dropped = furi_log.dropped;
+    FURI_CRITICAL_EXIT();
+
+    while(offset != write) {
+        FuriLogRecord* record = furi_log_ring_record(ring, &offset);
+        if(offset == write) break;
+        if(record->state == FuriLogRecordStateReady) {
+            furi_log_format_record(record, line, FURI_LOG_LINE_SIZE);
+            puts(line);
+        }
+        offset += record->size;
+    }
+
+    snprintf(line, FURI_LOG_LINE_SIZE, "Records dropped: %lu\r\n", dropped);
+    puts(line);
+
+    free(line);
+    free(ring);
+}
+
 void furi_log_set_level(FuriLogLevel level) {
     if(level == FuriLogLevelDefault) {
         level = FURI_LOG_LEVEL_DEFAULT;
@@ -44,6 +44,13 @@ typedef uint32_t (*FuriLogTimestamp)(void);
 /** Initialize logging */
 void furi_log_init();
 
+/** Start log drain thread
+ *
+ * Records are kept in ring buffer and printed by low priority thread, so
+ * logging doesn't block caller on output. Call before kernel start.
+ */
+void furi_log_start();
+
 /** Print log record
  * 
  * @param level 
@@ -54,6 +61,18 @@ void furi_log_init();
 void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...)
     _ATTRIBUTE((__format__(__printf__, 3, 4)));
 
+/** Print records that are not printed yet
+ *
+ * Output is done in caller context, intended for crash handler.
+ */
+void furi_log_flush();
+
+/** Print all records still kept in ring buffer, including printed ones
+ *
+ * @param[in]  puts  The puts callback
+ */
+void furi_log_dump(FuriLogPuts puts);
+
 /** Set log level
  *
  * @param[in]  level  The level
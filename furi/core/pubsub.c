@@ -2,28 +2,133 @@
 #include "memmgr.h"
 #include "check.h"
 #include "mutex.h"
+#include "kernel.h"
+#include "thread.h"
+#include "common_defines.h"
 
-#include <m-list.h>
+#include <string.h>
+#include <furi_hal_cortex.h>
+#include CMSIS_device_header
 
 struct FuriPubSubSubscription {
     FuriPubSubCallback callback;
     void* callback_context;
+    FuriMessageQueue* queue;
 };
 
-LIST_DEF(FuriPubSubSubscriptionList, FuriPubSubSubscription, M_POD_OPLIST);
+/* Immutable list of subscribers, replaced as a whole on subscribe/unsubscribe */
+typedef struct {
+    size_t count;
+    FuriPubSubSubscription* items[];
+} FuriPubSubSnapshot;
+
+/* Publish in progress, lives on publisher stack */
+typedef struct FuriPubSubReader {
+    FuriPubSubSnapshot* snapshot;
+    FuriThreadId thread; // NULL when published from ISR
+    struct FuriPubSubReader* next;
+} FuriPubSubReader;
 
 struct FuriPubSub {
-    FuriPubSubSubscriptionList_t items;
-    FuriMutex* mutex;
+    FuriPubSubSnapshot* snapshot;
+    FuriPubSubReader* readers;
+    FuriMutex* mutex; // serializes subscribe and unsubscribe
+
+    uint32_t published;
+    uint32_t dropped;
+    uint64_t latency_total;
+    uint32_t latency_max;
 };
 
+static FuriPubSubSnapshot* furi_pubsub_snapshot_alloc(size_t count) {
+    FuriPubSubSnapshot* snapshot =
+        malloc(sizeof(FuriPubSubSnapshot) + sizeof(FuriPubSubSubscription*) * count);
+    snapshot->count = count;
+    return snapshot;
+}
+
+static FuriPubSubSnapshot*
+    furi_pubsub_snapshot_acquire(FuriPubSub* pubsub, FuriPubSubReader* reader) {
+    reader->thread = FURI_IS_ISR() ? NULL : furi_thread_get_current_id();
+    FURI_CRITICAL_ENTER();
+    reader->snapshot = pubsub->snapshot;
+    reader->next = pubsub->readers;
+    pubsub->readers = reader;
+    FURI_CRITICAL_EXIT();
+    return reader->snapshot;
+}
+
+static void furi_pubsub_snapshot_release(FuriPubSub* pubsub, FuriPubSubReader* reader) {
+    FURI_CRITICAL_ENTER();
+    FuriPubSubReader** link = &pubsub->readers;
+    while(*link != reader) {
+        link = &(*link)->next;
+    }
+    *link = reader->next;
+    FURI_CRITICAL_EXIT();
+}
+
+static bool furi_pubsub_snapshot_is_read(FuriPubSub* pubsub, FuriPubSubSnapshot* snapshot) {
+    bool is_read = false;
+    FURI_CRITICAL_ENTER();
+    for(FuriPubSubReader* reader = pubsub->readers; reader; reader = reader->next) {
+        if(reader->snapshot == snapshot) {
+            is_read = true;
+            break;
+        }
+    }
+    FURI_CRITICAL_EXIT();
+    return is_read;
+}
+
+/* Subscription change from callback would wait for its own publish to end */
+static void furi_pubsub_check_not_publishing(FuriPubSub* pubsub) {
+    FuriThreadId thread = furi_thread_get_current_id();
+    bool is_publishing = false;
+    FURI_CRITICAL_ENTER();
+    for(FuriPubSubReader* reader = pubsub->readers; reader; reader = reader->next) {
+        if(thread && reader->thread == thread) {
+            is_publishing = true;
+            break;
+        }
+    }
+    FURI_CRITICAL_EXIT();
+    furi_check(!is_publishing);
+}
+
+static void furi_pubsub_snapshot_replace(FuriPubSub* pubsub, FuriPubSubSnapshot* snapshot) {
+    FuriPubSubSnapshot* old_snapshot;
+    FURI_CRITICAL_ENTER();
+    old_snapshot = pubsub->snapshot;
+    pubsub->snapshot = snapshot;
+    FURI_CRITICAL_EXIT();
+
+    // Wait for publishers in other threads still walking old snapshot,
+    // new ones already use the new one
+    while(furi_pubsub_snapshot_is_read(pubsub, old_snapshot)) {
+        furi_delay_tick(1);
+    }
+    free(old_snapshot);
+}
+
+static void furi_pubsub_account(FuriPubSub* pubsub, uint32_t cycles, uint32_t dropped) {
+    FURI_CRITICAL_ENTER();
+    pubsub->published++;
+    pubsub->dropped += dropped;
+    pubsub->latency_total += cycles;
+    if(cycles > pubsub->latency_max) {
+        pubsub->latency_max = cycles;
+    }
+    FURI_CRITICAL_EXIT();
+}
+
 FuriPubSub* furi_pubsub_alloc() {
     FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
 
     pubsub->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     furi_assert(pubsub->mutex);
 
-    FuriPubSubSubscriptionList_init(pubsub->items);
+    pubsub->snapshot = furi_pubsub_snapshot_alloc(0);
 
     return pubsub;
 }
@@ -31,65 +136,131 @@ FuriPubSub* furi_pubsub_alloc() {
 void furi_pubsub_free(FuriPubSub* pubsub) {
     furi_assert(pubsub);
 
-    furi_check(FuriPubSubSubscriptionList_size(pubsub->items) == 0);
+    furi_check(pubsub->snapshot->count == 0);
+    furi_check(pubsub->readers == NULL);
 
-    FuriPubSubSubscriptionList_clear(pubsub->items);
+    free(pubsub->snapshot);
 
     furi_mutex_free(pubsub->mutex);
 
     free(pubsub);
 }
 
+static FuriPubSubSubscription*
+    furi_pubsub_subscribe_item(FuriPubSub* pubsub, FuriPubSubSubscription* item) {
+    furi_pubsub_check_not_publishing(pubsub);
+    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
+
+    FuriPubSubSnapshot* old_snapshot = pubsub->snapshot;
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(old_snapshot->count + 1);
+    memcpy(
+        snapshot->items,
+        old_snapshot->items,
+        sizeof(FuriPubSubSubscription*) * old_snapshot->count);
+    snapshot->items[old_snapshot->count] = item;
+    furi_pubsub_snapshot_replace(pubsub, snapshot);
+
+    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+
+    return item;
+}
+
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context) {
-    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
-    // put uninitialized item to the list
-    FuriPubSubSubscription* item = FuriPubSubSubscriptionList_push_raw(pubsub->items);
+    furi_assert(pubsub);
+    furi_assert(callback);
 
-    // initialize item
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
     item->callback = callback;
     item->callback_context = callback_context;
 
-    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+    return furi_pubsub_subscribe_item(pubsub, item);
+}
 
-    return item;
+FuriPubSubSubscription* furi_pubsub_subscribe_queue(FuriPubSub* pubsub, FuriMessageQueue* queue) {
+    furi_assert(pubsub);
+    furi_assert(queue);
+
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
+    item->queue = queue;
+
+    return furi_pubsub_subscribe_item(pubsub, item);
 }
 
 void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_subscription) {
     furi_assert(pubsub);
     furi_assert(pubsub_subscription);
 
+    furi_pubsub_check_not_publishing(pubsub);
     furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
-    bool result = false;
 
-    // iterate over items
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
+    FuriPubSubSnapshot* old_snapshot = pubsub->snapshot;
+    furi_check(old_snapshot->count > 0);
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(old_snapshot->count - 1);
 
-        // if the iterator is equal to our element
-        if(item == pubsub_subscription) {
-            FuriPubSubSubscriptionList_remove(pubsub->items, it);
+    // copy all items except our element
+    bool result = false;
+    size_t count = 0;
+    for(size_t i = 0; i < old_snapshot->count; i++) {
+        if(old_snapshot->items[i] == pubsub_subscription) {
             result = true;
-            break;
+        } else if(count < snapshot->count) {
+            snapshot->items[count++] = old_snapshot->items[i];
         }
     }
+    furi_check(result);
+
+    // After replace no publisher can see the subscription anymore
+    furi_pubsub_snapshot_replace(pubsub, snapshot);
+    free(pubsub_subscription);
 
     furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
-    furi_check(result);
 }
 
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
-    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
+    uint32_t start = DWT->CYCCNT;
+    uint32_t dropped = 0;
+
+    FuriPubSubReader reader;
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_acquire(pubsub, &reader);
 
     // iterate over subscribers
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-        item->callback(message, item->callback_context);
+    for(size_t i = 0; i < snapshot->count; i++) {
+        const FuriPubSubSubscription* item = snapshot->items[i];
+        if(item->queue) {
+            if(furi_message_queue_put(item->queue, message, 0) != FuriStatusOk) {
+                dropped++;
+            }
+        } else {
+            item->callback(message, item->callback_context);
+        }
     }
 
-    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+    furi_pubsub_snapshot_release(pubsub, &reader);
+
+    furi_pubsub_account(pubsub, DWT->CYCCNT - start, dropped);
+}
+
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats) {
+    furi_assert(pubsub);
+    furi_assert(stats);
+
+    uint32_t published, dropped, latency_max;
+    uint64_t latency_total;
+    size_t subscribers;
+
+    FURI_CRITICAL_ENTER();
+    subscribers = pubsub->snapshot->count;
+    published = pubsub->published;
+    dropped = pubsub->dropped;
+    latency_total = pubsub->latency_total;
+    latency_max = pubsub->latency_max;
+    FURI_CRITICAL_EXIT();
+
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    stats->subscribers = subscribers;
+    stats->published = published;
+    stats->dropped = dropped;
+    stats->latency_avg_us = published ? (latency_total / published / cycles_per_us) : 0;
+    stats->latency_max_us = latency_max / cycles_per_us;
 }
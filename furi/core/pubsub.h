@@ -4,6 +4,10 @@
  */
 #pragma once
 
+#include "message_queue.h"
+
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +21,15 @@ typedef struct FuriPubSub FuriPubSub;
 /** FuriPubSubSubscription type */
 typedef struct FuriPubSubSubscription FuriPubSubSubscription;
 
+/** FuriPubSub statistics */
+typedef struct {
+    uint32_t subscribers; /**< current amount of subscribers */
+    uint32_t published; /**< amount of published messages */
+    uint32_t dropped; /**< messages not delivered to full subscriber queues */
+    uint32_t latency_avg_us; /**< average publish call duration */
+    uint32_t latency_max_us; /**< longest publish call duration */
+} FuriPubSubStats;
+
 /** Allocate FuriPubSub
  *
  * Reentrable, Not threadsafe, one owner
@@ -33,6 +46,8 @@ void furi_pubsub_free(FuriPubSub* pubsub);
 
 /** Subscribe to FuriPubSub
  * 
+ * Must not be called from subscription callback of the same FuriPubSub,
+ * it crashes instead of waiting for its own publish forever.
  * Threadsafe, Reentrable
  * 
  * @param      pubsub            pointer to FuriPubSub instance
@@ -44,9 +59,28 @@ void furi_pubsub_free(FuriPubSub* pubsub);
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context);
 
+/** Subscribe to FuriPubSub with deferred delivery
+ *
+ * Published messages are copied into the queue instead of calling back in
+ * publisher context, publisher never waits: message is dropped and counted if
+ * queue is full. Queue message size must be equal to published message size.
+ *
+ * Must not be called from subscription callback of the same FuriPubSub.
+ * Threadsafe, Reentrable
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ * @param      queue   FuriMessageQueue instance, owned by subscriber
+ *
+ * @return     pointer to FuriPubSubSubscription instance
+ */
+FuriPubSubSubscription* furi_pubsub_subscribe_queue(FuriPubSub* pubsub, FuriMessageQueue* queue);
+
 /** Unsubscribe from FuriPubSub
  * 
  * No use of `pubsub_subscription` allowed after call of this method
+ * Waits for publishers in progress, callback is not called after return.
+ * Must not be called from subscription callback of the same FuriPubSub,
+ * it crashes instead of waiting for its own publish forever.
  * Threadsafe, Reentrable.
  *
  * @param      pubsub               pointer to FuriPubSub instance
@@ -56,13 +90,21 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
 
 /** Publish message to FuriPubSub
  *
- * Threadsafe, Reentrable.
+ * Threadsafe, Reentrable. Never blocks on other publishers or on
+ * subscribe/unsubscribe, callbacks are called in publisher context.
  * 
  * @param      pubsub   pointer to FuriPubSub instance
  * @param      message  message pointer to publish
  */
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message);
 
+/** Get FuriPubSub statistics
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ * @param      stats   pointer to FuriPubSubStats to fill
+ */
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
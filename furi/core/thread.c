@@ -16,11 +16,14 @@
 
 #define THREAD_NOTIFY_INDEX 1 // Index 0 is used for stream buffers
 
+#define THREAD_STDOUT_BUFFER_SIZE 128
+
 typedef struct FuriThreadStdout FuriThreadStdout;
 
 struct FuriThreadStdout {
     FuriThreadStdoutWriteCallback write_callback;
-    FuriString* buffer;
+    size_t size;
+    char buffer[THREAD_STDOUT_BUFFER_SIZE];
 };
 
 struct FuriThread {
@@ -45,6 +48,30 @@ struct FuriThread {
     FuriThreadStdout output;
 };
 
+uint64_t furi_thread_get_run_time(FuriThreadId thread_id) {
+    TaskHandle_t hTask = (TaskHandle_t)thread_id;
+    uint64_t run_time = 0;
+
+    if(!FURI_IS_IRQ_MODE() && (hTask != NULL)) {
+        TaskStatus_t status;
+        // 64-bit counter is updated on context switch
+        FURI_CRITICAL_ENTER();
+        // Known state skips the task list lookup, it is not used here
+        vTaskGetInfo(hTask, &status, pdFALSE, eRunning);
+        run_time = status.ulRunTimeCounter;
+        FURI_CRITICAL_EXIT();
+    }
+
+    return run_time;
+}
+
+FuriThreadId furi_thread_get_idle_id() {
+    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return NULL;
+    }
+    return (FuriThreadId)xTaskGetIdleTaskHandle();
+}
+
 static size_t __furi_thread_stdout_write(FuriThread* thread, const char* data, size_t size);
 static int32_t __furi_thread_stdout_flush(FuriThread* thread);
 
@@ -119,7 +146,6 @@ static void furi_thread_body(void* context) {
 
 FuriThread* furi_thread_alloc() {
     FuriThread* thread = malloc(sizeof(FuriThread));
-    thread->output.buffer = furi_string_alloc();
     thread->is_service = false;
 
     FuriHalRtcHeapTrackMode mode = furi_hal_rtc_get_heap_track_mode();
@@ -153,7 +179,6 @@ void furi_thread_free(FuriThread* thread) {
     furi_assert(thread->state == FuriThreadStateStopped);
 
     if(thread->name) free((void*)thread->name);
-    furi_string_free(thread->output.buffer);
 
     free(thread);
 }
@@ -512,11 +537,10 @@ static size_t __furi_thread_stdout_write(FuriThread* thread, const char* data, s
 }
 
 static int32_t __furi_thread_stdout_flush(FuriThread* thread) {
-    FuriString* buffer = thread->output.buffer;
-    size_t size = furi_string_size(buffer);
-    if(size > 0) {
-        __furi_thread_stdout_write(thread, furi_string_get_cstr(buffer), size);
-        furi_string_reset(buffer);
+    FuriThreadStdout* output = &thread->output;
+    if(output->size > 0) {
+        __furi_thread_stdout_write(thread, output->buffer, output->size);
+        output->size = 0;
     }
     return 0;
 }
@@ -532,22 +556,25 @@ bool furi_thread_set_stdout_callback(FuriThreadStdoutWriteCallback callback) {
 
 size_t furi_thread_stdout_write(const char* data, size_t size) {
     FuriThread* thread = furi_thread_get_current();
+    FuriThreadStdout* output = &thread->output;
 
     if(size == 0 || data == NULL) {
         return __furi_thread_stdout_flush(thread);
+    }
+
+    if(output->size + size > THREAD_STDOUT_BUFFER_SIZE) {
+        __furi_thread_stdout_flush(thread);
+    }
+
+    if(size >= THREAD_STDOUT_BUFFER_SIZE) {
+        // buffer is empty at this point, no reason to copy big chunks
+        __furi_thread_stdout_write(thread, data, size);
     } else {
-        if(data[size - 1] == '\n') {
-            // if the last character is a newline, we can flush buffer and write data as is, wo buffers
+        memcpy(output->buffer + output->size, data, size);
+        output->size += size;
+        // line buffered: complete lines go out right away
+        if(output->size == THREAD_STDOUT_BUFFER_SIZE || memchr(data, '\n', size)) {
             __furi_thread_stdout_flush(thread);
-            __furi_thread_stdout_write(thread, data, size);
-        } else {
-            // string_cat doesn't work here because we need to write the exact size data
-            for(size_t i = 0; i < size; i++) {
-                furi_string_push_back(thread->output.buffer, data[i]);
-                if(data[i] == '\n') {
-                    __furi_thread_stdout_flush(thread);
-                }
-            }
         }
     }
 
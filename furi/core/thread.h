@@ -227,6 +227,20 @@ const char* furi_thread_get_name(FuriThreadId thread_id);
 
 uint32_t furi_thread_get_stack_space(FuriThreadId thread_id);
 
+/** Get time thread was running
+ *
+ * @param      thread_id  thread id
+ *
+ * @return     run time in microseconds, same time base as furi_kernel_get_run_time()
+ */
+uint64_t furi_thread_get_run_time(FuriThreadId thread_id);
+
+/** Get kernel idle thread id
+ *
+ * @return     idle thread id, NULL if kernel is not started
+ */
+FuriThreadId furi_thread_get_idle_id();
+
 /** Set STDOUT callback for thread
  * 
  * @param      callback  callback or NULL to clear
@@ -2,6 +2,7 @@
 
 #include <elf.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #define ELF_INVALID_ADDRESS 0xFFFFFFFF
 
@@ -9,4 +10,13 @@ typedef struct {
     uint16_t api_version_major;
     uint16_t api_version_minor;
     bool (*resolver_callback)(const char* name, Elf32_Addr* address);
+    /* Optional, resolves all names at once. Missing symbols get ELF_INVALID_ADDRESS.
+     * Returns number of resolved symbols. */
+    size_t (*resolver_batch_callback)(
+        const char* const* names,
+        Elf32_Addr* addresses,
+        size_t count);
+    /* Optional, hash of all symbol names and addresses. Imports are only cached
+     * when it is provided, cached addresses are valid for the same hash only. */
+    uint32_t (*table_hash_callback)(void);
 } ElfApiInterface;
@@ -2,13 +2,16 @@
 #include "elf_file.h"
 #include "elf_file_i.h"
 #include "elf_api_interface.h"
+#include "elf_import_cache.h"
 
 #define TAG "elf"
 
 #define ELF_NAME_BUFFER_LEN 32
 #define SECTION_OFFSET(e, n) ((e)->section_table + (n) * sizeof(Elf32_Shdr))
 #define IS_FLAGS_SET(v, m) (((v) & (m)) == (m))
-#define RESOLVER_THREAD_YIELD_STEP 30
+#define RELOCATION_BATCH_SIZE 64
+/* Free heap left untouched when deciding whether symbol table fits in RAM */
+#define SYMBOL_TABLE_HEAP_RESERVE (16 * 1024)
 
 // #define ELF_DEBUG_LOG 1
 
@@ -134,7 +137,30 @@ static bool elf_read_section(
     return true;
 }
 
+static bool elf_read_symbol_from_memory(ELFFile* elf, int n, Elf32_Sym* sym, FuriString* name) {
+    if((size_t)n >= elf->symbol_count) {
+        return false;
+    }
+
+    *sym = elf->symbols[n];
+    if(sym->st_name) {
+        if(sym->st_name >= elf->symbol_table_strings_size) {
+            return false;
+        }
+        furi_string_set(name, elf->symbol_strings + sym->st_name);
+        return true;
+    } else {
+        Elf32_Shdr shdr;
+        return elf_read_section(elf, sym->st_shndx, &shdr, name);
+    }
+}
+
 static bool elf_read_symbol(ELFFile* elf, int n, Elf32_Sym* sym, FuriString* name) {
+    elf->load_stats.symbol_lookup_count++;
+    if(elf->symbols) {
+        return elf_read_symbol_from_memory(elf, n, sym, name);
+    }
+
     bool success = false;
     off_t old = storage_file_tell(elf->fd);
     off_t pos = elf->symbol_table + n * sizeof(Elf32_Sym);
@@ -152,6 +178,10 @@ static bool elf_read_symbol(ELFFile* elf, int n, Elf32_Sym* sym, FuriString* nam
 }
 
 static ELFSection* elf_section_of(ELFFile* elf, int index) {
+    if(elf->section_by_index) {
+        return ((size_t)index < elf->sections_count) ? elf->section_by_index[index] : NULL;
+    }
+
     ELFSectionDict_it_t it;
     for(ELFSectionDict_it(it, elf->sections); !ELFSectionDict_end_p(it); ELFSectionDict_next(it)) {
         ELFSectionDict_itref_t* itref = ELFSectionDict_ref(it);
@@ -338,39 +368,52 @@ static bool elf_relocate_symbol(ELFFile* elf, Elf32_Addr relAddr, int type, Elf3
 
 static bool elf_relocate(ELFFile* elf, ELFSection* s) {
     if(s->data) {
-        Elf32_Rel rel;
         size_t relEntries = s->rel_count;
         size_t relCount;
-        (void)storage_file_seek(elf->fd, s->rel_offset, true);
         FURI_LOG_D(TAG, " Offset   Info     Type             Name");
 
         int relocate_result = true;
         FuriString* symbol_name;
         symbol_name = furi_string_alloc();
 
+        Elf32_Rel* rel_batch = malloc(sizeof(Elf32_Rel) * MIN(relEntries, RELOCATION_BATCH_SIZE));
+        size_t rel_batch_size = 0;
+        size_t rel_batch_pos = 0;
+
         for(relCount = 0; relCount < relEntries; relCount++) {
-            if(relCount % RESOLVER_THREAD_YIELD_STEP == 0) {
+            if(rel_batch_pos == rel_batch_size) {
                 FURI_LOG_D(TAG, "  reloc YIELD");
                 furi_delay_tick(1);
-            }
 
-            if(storage_file_read(elf->fd, &rel, sizeof(Elf32_Rel)) != sizeof(Elf32_Rel)) {
-                FURI_LOG_E(TAG, "  reloc read fail");
-                furi_string_free(symbol_name);
-                return false;
+                /* Symbol lookups may move file position, so always seek explicitly */
+                rel_batch_size = MIN(relEntries - relCount, RELOCATION_BATCH_SIZE);
+                rel_batch_pos = 0;
+                size_t rel_batch_bytes = sizeof(Elf32_Rel) * rel_batch_size;
+                if(!storage_file_seek(
+                       elf->fd, s->rel_offset + relCount * sizeof(Elf32_Rel), true) ||
+                   storage_file_read(elf->fd, rel_batch, rel_batch_bytes) != rel_batch_bytes) {
+                    FURI_LOG_E(TAG, "  reloc read fail");
+                    free(rel_batch);
+                    furi_string_free(symbol_name);
+                    return false;
+                }
             }
 
+            Elf32_Rel* rel = &rel_batch[rel_batch_pos++];
             Elf32_Addr symAddr;
 
-            int symEntry = ELF32_R_SYM(rel.r_info);
-            int relType = ELF32_R_TYPE(rel.r_info);
-            Elf32_Addr relAddr = ((Elf32_Addr)s->data) + rel.r_offset;
+            int symEntry = ELF32_R_SYM(rel->r_info);
+            int relType = ELF32_R_TYPE(rel->r_info);
+            Elf32_Addr relAddr = ((Elf32_Addr)s->data) + rel->r_offset;
+            bool symbol_resolved = false;
 
             if(!address_cache_get(elf->relocation_cache, symEntry, &symAddr)) {
+                symbol_resolved = true;
                 Elf32_Sym sym;
                 furi_string_reset(symbol_name);
                 if(!elf_read_symbol(elf, symEntry, &sym, symbol_name)) {
                     FURI_LOG_E(TAG, "  symbol read fail");
+                    free(rel_batch);
                     furi_string_free(symbol_name);
                     return false;
                 }
@@ -378,13 +421,17 @@ static bool elf_relocate(ELFFile* elf, ELFSection* s) {
                 FURI_LOG_D(
                     TAG,
                     " %08X %08X %-16s %s",
-                    (unsigned int)rel.r_offset,
-                    (unsigned int)rel.r_info,
+                    (unsigned int)rel->r_offset,
+                    (unsigned int)rel->r_info,
                     elf_reloc_type_to_str(relType),
                     furi_string_get_cstr(symbol_name));
 
                 symAddr = elf_address_of(elf, &sym, furi_string_get_cstr(symbol_name));
                 address_cache_put(elf->relocation_cache, symEntry, symAddr);
+                if(elf->import_cache_dir && sym.st_shndx == SHN_UNDEF &&
+                   symAddr != ELF_INVALID_ADDRESS) {
+                    address_cache_put(elf->import_cache, symEntry, symAddr);
+                }
             }
 
             if(symAddr != ELF_INVALID_ADDRESS) {
@@ -397,10 +444,16 @@ static bool elf_relocate(ELFFile* elf, ELFSection* s) {
                     relocate_result = false;
                 }
             } else {
-                FURI_LOG_E(TAG, "  No symbol address of %s", furi_string_get_cstr(symbol_name));
+                /* Cached misses were already reported */
+                if(symbol_resolved) {
+                    FURI_LOG_E(
+                        TAG, "  No symbol address of %s", furi_string_get_cstr(symbol_name));
+                }
                 relocate_result = false;
             }
         }
+        elf->load_stats.relocation_count += relEntries;
+        free(rel_batch);
         furi_string_free(symbol_name);
 
         return relocate_result;
@@ -411,6 +464,114 @@ static bool elf_relocate(ELFFile* elf, ELFSection* s) {
     return false;
 }
 
+static void elf_load_symbol_table(ELFFile* elf) {
+    size_t symbols_size = elf->symbol_count * sizeof(Elf32_Sym);
+    size_t required_size = symbols_size + elf->symbol_table_strings_size;
+
+    if(!symbols_size || !elf->symbol_table_strings_size ||
+       (required_size + SYMBOL_TABLE_HEAP_RESERVE > memmgr_heap_get_max_free_block())) {
+        FURI_LOG_W(TAG, "Symbol table is not cached, %u bytes required", required_size);
+        return;
+    }
+
+    elf->symbols = malloc(symbols_size);
+    /* Extra byte keeps the last string terminated even in malformed file */
+    elf->symbol_strings = malloc(elf->symbol_table_strings_size + 1);
+
+    if(!storage_file_seek(elf->fd, elf->symbol_table, true) ||
+       storage_file_read(elf->fd, elf->symbols, symbols_size) != symbols_size ||
+       !storage_file_seek(elf->fd, elf->symbol_table_strings, true) ||
+       storage_file_read(elf->fd, elf->symbol_strings, elf->symbol_table_strings_size) !=
+           elf->symbol_table_strings_size) {
+        FURI_LOG_W(TAG, "Symbol table read failed, falling back to per-symbol reads");
+        free(elf->symbols);
+        free(elf->symbol_strings);
+        elf->symbols = NULL;
+        elf->symbol_strings = NULL;
+    }
+}
+
+static void elf_free_symbol_table(ELFFile* elf) {
+    if(elf->symbols) {
+        free(elf->symbols);
+        elf->symbols = NULL;
+    }
+
+    if(elf->symbol_strings) {
+        free(elf->symbol_strings);
+        elf->symbol_strings = NULL;
+    }
+}
+
+static bool elf_symbol_is_import(ELFFile* elf, size_t index) {
+    const Elf32_Sym* sym = &elf->symbols[index];
+    return sym->st_shndx == SHN_UNDEF && sym->st_name &&
+           sym->st_name < elf->symbol_table_strings_size;
+}
+
+/* Resolve all API imports in one call, results go to relocation cache */
+static void elf_resolve_imports(ELFFile* elf) {
+    if(!elf->symbols || !elf->api_interface->resolver_batch_callback) {
+        return;
+    }
+
+    size_t import_count = 0;
+    for(size_t i = 0; i < elf->symbol_count; i++) {
+        if(elf_symbol_is_import(elf, i)) import_count++;
+    }
+
+    if(!import_count) {
+        return;
+    }
+
+    const char** names = malloc(sizeof(const char*) * import_count);
+    Elf32_Addr* addresses = malloc(sizeof(Elf32_Addr) * import_count);
+
+    for(size_t i = 0, import_idx = 0; i < elf->symbol_count; i++) {
+        if(elf_symbol_is_import(elf, i)) {
+            names[import_idx++] = elf->symbol_strings + elf->symbols[i].st_name;
+        }
+    }
+
+    size_t resolved =
+        elf->api_interface->resolver_batch_callback(names, addresses, import_count);
+    FURI_LOG_D(TAG, "Resolved %u of %u imports", resolved, import_count);
+    UNUSED(resolved);
+
+    /* Unresolved imports are left to relocation pass, which reports them */
+    for(size_t i = 0, import_idx = 0; i < elf->symbol_count; i++) {
+        if(!elf_symbol_is_import(elf, i)) continue;
+
+        Elf32_Addr address = addresses[import_idx++];
+        if(address != ELF_INVALID_ADDRESS) {
+            address_cache_put(elf->relocation_cache, i, address);
+            if(elf->import_cache_dir) {
+                address_cache_put(elf->import_cache, i, address);
+            }
+        }
+    }
+
+    free(names);
+    free(addresses);
+}
+
+static void elf_build_section_index(ELFFile* elf) {
+    elf->section_by_index = malloc(sizeof(ELFSection*) * elf->sections_count);
+
+    ELFSectionDict_it_t it;
+    for(ELFSectionDict_it(it, elf->sections); !ELFSectionDict_end_p(it); ELFSectionDict_next(it)) {
+        ELFSectionDict_itref_t* itref = ELFSectionDict_ref(it);
+        if(itref->value.sec_idx && itref->value.sec_idx < elf->sections_count) {
+            elf->section_by_index[itref->value.sec_idx] = &itref->value;
+        }
+    }
+}
+
+static void elf_free_section_index(ELFFile* elf) {
+    free(elf->section_by_index);
+    elf->section_by_index = NULL;
+}
+
 /**************************************************************************************************/
 /************************************ Internal FAP interfaces *************************************/
 /**************************************************************************************************/
@@ -569,6 +730,7 @@ static SectionType elf_preload_section(
     if(strcmp(name, ".strtab") == 0) {
         FURI_LOG_D(TAG, "Found .strtab section");
         elf->symbol_table_strings = section_header->sh_offset;
+        elf->symbol_table_strings_size = section_header->sh_size;
         return SectionTypeStrTab;
     }
 
@@ -631,9 +793,11 @@ static void elf_file_call_section_list(ELFSection* section, bool reverse_order)
 ELFFile* elf_file_alloc(Storage* storage, const ElfApiInterface* api_interface) {
     ELFFile* elf = malloc(sizeof(ELFFile));
     elf->fd = storage_file_alloc(storage);
+    elf->storage = storage;
     elf->api_interface = api_interface;
     ELFSectionDict_init(elf->sections);
     AddressCache_init(elf->trampoline_cache);
+    AddressCache_init(elf->import_cache);
     return elf;
 }
 
@@ -669,10 +833,27 @@ void elf_file_free(ELFFile* elf) {
         free(elf->debug_link_info.debug_link);
     }
 
+    AddressCache_clear(elf->import_cache);
+    if(elf->import_cache_dir) {
+        furi_string_free(elf->import_cache_dir);
+    }
+
     storage_file_free(elf->fd);
     free(elf);
 }
 
+void elf_file_set_import_cache_dir(ELFFile* elf, const char* cache_dir) {
+    if(cache_dir) {
+        if(!elf->import_cache_dir) {
+            elf->import_cache_dir = furi_string_alloc();
+        }
+        furi_string_set(elf->import_cache_dir, cache_dir);
+    } else if(elf->import_cache_dir) {
+        furi_string_free(elf->import_cache_dir);
+        elf->import_cache_dir = NULL;
+    }
+}
+
 bool elf_file_open(ELFFile* elf, const char* path) {
     Elf32_Ehdr h;
     Elf32_Shdr sH;
@@ -725,6 +906,7 @@ bool elf_file_load_section_table(ELFFile* elf, FlipperApplicationManifest* manif
     SectionType loaded_sections = SectionTypeERROR;
     FuriString* name;
     name = furi_string_alloc();
+    uint32_t start = furi_get_tick();
 
     FURI_LOG_D(TAG, "Scan ELF indexs...");
     for(size_t section_idx = 1; section_idx < elf->sections_count; section_idx++) {
@@ -749,6 +931,7 @@ bool elf_file_load_section_table(ELFFile* elf, FlipperApplicationManifest* manif
     }
 
     furi_string_free(name);
+    elf->load_stats.section_table_time = furi_get_tick() - start;
 
     return IS_FLAGS_SET(loaded_sections, SectionTypeValid);
 }
@@ -759,6 +942,16 @@ ELFFileLoadStatus elf_file_load_sections(ELFFile* elf) {
 
     AddressCache_init(elf->relocation_cache);
 
+    uint32_t start = furi_get_tick();
+    elf_load_symbol_table(elf);
+    elf_build_section_index(elf);
+    bool import_cache_hit = elf_import_cache_load(elf);
+    if(!import_cache_hit) {
+        elf_resolve_imports(elf);
+    }
+    elf->load_stats.symbol_table_time = furi_get_tick() - start;
+
+    start = furi_get_tick();
     for(ELFSectionDict_it(it, elf->sections); !ELFSectionDict_end_p(it);
         ELFSectionDict_next(it)) {
         ELFSectionDict_itref_t* itref = ELFSectionDict_ref(it);
@@ -768,6 +961,14 @@ ELFFileLoadStatus elf_file_load_sections(ELFFile* elf) {
             status = ELFFileLoadStatusMissingImports;
         }
     }
+    elf->load_stats.relocation_time = furi_get_tick() - start;
+
+    if(status == ELFFileLoadStatusSuccess && !import_cache_hit) {
+        elf_import_cache_save(elf);
+    }
+
+    elf_free_section_index(elf);
+    elf_free_symbol_table(elf);
 
     /* Fixing up entry point */
     if(status == ELFFileLoadStatusSuccess) {
@@ -795,6 +996,15 @@ ELFFileLoadStatus elf_file_load_sections(ELFFile* elf) {
         FURI_LOG_I(TAG, "Total size of loaded sections: %u", total_size); //-V576
     }
 
+    FURI_LOG_I(
+        TAG,
+        "Sections %lums, symbols %lums, relocation %lums: %u relocs, %u lookups",
+        elf->load_stats.section_table_time,
+        elf->load_stats.symbol_table_time,
+        elf->load_stats.relocation_time,
+        elf->load_stats.relocation_count,
+        elf->load_stats.symbol_lookup_count);
+
     return status;
 }
 
@@ -817,6 +1027,10 @@ const ElfApiInterface* elf_file_get_api_interface(ELFFile* elf_file) {
     return elf_file->api_interface;
 }
 
+const ELFLoadStats* elf_file_get_load_stats(ELFFile* elf_file) {
+    return &elf_file->load_stats;
+}
+
 void elf_file_init_debug_info(ELFFile* elf, ELFDebugInfo* debug_info) {
     // set entry
     debug_info->entry = elf->entry;
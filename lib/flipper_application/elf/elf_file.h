@@ -30,6 +30,17 @@ typedef struct {
     off_t entry;
 } ELFDebugInfo;
 
+/**
+ * Load stage measurements, in milliseconds
+ */
+typedef struct {
+    uint32_t section_table_time;
+    uint32_t symbol_table_time;
+    uint32_t relocation_time;
+    size_t relocation_count;
+    size_t symbol_lookup_count;
+} ELFLoadStats;
+
 typedef enum {
     ELFFileLoadStatusSuccess = 0,
     ELFFileLoadStatusUnspecifiedError,
@@ -51,6 +62,15 @@ ELFFile* elf_file_alloc(Storage* storage, const ElfApiInterface* api_interface);
  */
 void elf_file_free(ELFFile* elf_file);
 
+/**
+ * @brief Enable cache of resolved API imports. Imports resolved on first load
+ * are stored in cache_dir and reused by next loads of the same file,
+ * cache is invalidated when firmware build changes.
+ * @param elf_file 
+ * @param cache_dir directory for cache files, NULL to disable
+ */
+void elf_file_set_import_cache_dir(ELFFile* elf_file, const char* cache_dir);
+
 /**
  * @brief Open ELF file
  * @param elf_file 
@@ -109,6 +129,13 @@ void elf_file_post_run(ELFFile* elf);
  */
 const ElfApiInterface* elf_file_get_api_interface(ELFFile* elf_file);
 
+/**
+ * @brief Get ELF file load stage measurements
+ * @param elf_file 
+ * @return const ELFLoadStats* 
+ */
+const ELFLoadStats* elf_file_get_load_stats(ELFFile* elf_file);
+
 /**
  * @brief Get ELF file debug info
  * @param elf_file 
@@ -32,9 +32,24 @@ struct ELFFile {
     size_t symbol_count;
     off_t symbol_table;
     off_t symbol_table_strings;
+    size_t symbol_table_strings_size;
     off_t entry;
     ELFSectionDict_t sections;
 
+    /* In-RAM copies of .symtab and .strtab, only present during relocation */
+    Elf32_Sym* symbols;
+    char* symbol_strings;
+    /* Section index to loaded section lookup, only present during relocation */
+    ELFSection** section_by_index;
+
+    ELFLoadStats load_stats;
+
+    Storage* storage;
+    FuriString* import_cache_dir;
+    /* Resolved API imports, symbol index to address */
+    AddressCache_t import_cache;
+    uint32_t import_cache_key;
+
     AddressCache_t relocation_cache;
     AddressCache_t trampoline_cache;
 
@@ -0,0 +1,200 @@
+#include "elf_import_cache.h"
+#include <toolbox/crc32_calc.h>
+
+#define TAG "elf_cache"
+
+#define ELF_IMPORT_CACHE_MAGIC 0x46414943 // "FAIC"
+#define ELF_IMPORT_CACHE_VERSION 2
+#define ELF_IMPORT_CACHE_KEY_FILE "api.key"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint16_t api_version_major;
+    uint16_t api_version_minor;
+    uint32_t table_hash;
+    uint32_t symbol_count;
+    uint32_t entry_count;
+} __attribute__((packed)) ELFImportCacheHeader;
+
+typedef struct {
+    uint32_t symbol_index;
+    Elf32_Addr address;
+} __attribute__((packed)) ELFImportCacheEntry;
+
+/* Addresses of API symbols are only valid for exact API table */
+static bool elf_import_cache_enabled(ELFFile* elf) {
+    return elf->import_cache_dir && elf->symbols && elf->api_interface->table_hash_callback;
+}
+
+/* Key file holds table hash of the firmware that created cache files */
+static void elf_import_cache_get_key_path(ELFFile* elf, FuriString* path) {
+    furi_string_printf(
+        path, "%s/%s", furi_string_get_cstr(elf->import_cache_dir), ELF_IMPORT_CACHE_KEY_FILE);
+}
+
+/* Cache files of other firmware will never be valid again, drop them all */
+static void elf_import_cache_check_key(ELFFile* elf) {
+    uint32_t table_hash = elf->api_interface->table_hash_callback();
+    uint32_t stored_hash = 0;
+    const char* cache_dir = furi_string_get_cstr(elf->import_cache_dir);
+    FuriString* path = furi_string_alloc();
+    File* file = storage_file_alloc(elf->storage);
+    elf_import_cache_get_key_path(elf, path);
+
+    bool key_valid = storage_file_open(
+                         file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+                     storage_file_read(file, &stored_hash, sizeof(stored_hash)) ==
+                         sizeof(stored_hash) &&
+                     stored_hash == table_hash;
+    storage_file_close(file);
+
+    if(!key_valid) {
+        FURI_LOG_I(TAG, "API table changed, clearing %s", cache_dir);
+        storage_simply_remove_recursive(elf->storage, cache_dir);
+        storage_simply_mkdir(elf->storage, cache_dir);
+        if(storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            storage_file_write(file, &table_hash, sizeof(table_hash));
+        }
+    }
+
+    storage_file_free(file);
+    furi_string_free(path);
+}
+
+/* Cache file is named after symbol and string tables, which define the set of imports */
+static void elf_import_cache_get_path(ELFFile* elf, FuriString* path) {
+    elf->import_cache_key =
+        crc32_calc_buffer(0, elf->symbols, elf->symbol_count * sizeof(Elf32_Sym));
+    elf->import_cache_key = crc32_calc_buffer(
+        elf->import_cache_key, elf->symbol_strings, elf->symbol_table_strings_size);
+
+    furi_string_printf(
+        path,
+        "%s/%08lX.bin",
+        furi_string_get_cstr(elf->import_cache_dir),
+        elf->import_cache_key);
+}
+
+static void elf_import_cache_fill_header(ELFFile* elf, ELFImportCacheHeader* header) {
+    header->magic = ELF_IMPORT_CACHE_MAGIC;
+    header->version = ELF_IMPORT_CACHE_VERSION;
+    header->api_version_major = elf->api_interface->api_version_major;
+    header->api_version_minor = elf->api_interface->api_version_minor;
+    header->table_hash = elf->api_interface->table_hash_callback();
+    header->symbol_count = elf->symbol_count;
+    header->entry_count = 0;
+}
+
+bool elf_import_cache_load(ELFFile* elf) {
+    if(!elf_import_cache_enabled(elf)) {
+        return false;
+    }
+
+    bool result = false;
+    FuriString* path = furi_string_alloc();
+    File* file = storage_file_alloc(elf->storage);
+    ELFImportCacheEntry* entries = NULL;
+    elf_import_cache_get_path(elf, path);
+
+    do {
+        if(!storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_D(TAG, "No cache for %08lX", elf->import_cache_key);
+            break;
+        }
+
+        ELFImportCacheHeader header;
+        ELFImportCacheHeader expected;
+        elf_import_cache_fill_header(elf, &expected);
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+
+        expected.entry_count = header.entry_count;
+        if(memcmp(&header, &expected, sizeof(header)) != 0) {
+            FURI_LOG_I(TAG, "Cache %08lX is outdated", elf->import_cache_key);
+            storage_file_close(file);
+            storage_common_remove(elf->storage, furi_string_get_cstr(path));
+            break;
+        }
+
+        size_t entries_size = header.entry_count * sizeof(ELFImportCacheEntry);
+        if(header.entry_count > elf->symbol_count) break;
+        if(header.entry_count) {
+            entries = malloc(entries_size);
+            if(storage_file_read(file, entries, entries_size) != entries_size) break;
+        }
+
+        bool entries_valid = true;
+        for(size_t i = 0; i < header.entry_count; i++) {
+            uint32_t symbol_index = entries[i].symbol_index;
+            if(symbol_index >= elf->symbol_count ||
+               elf->symbols[symbol_index].st_shndx != SHN_UNDEF) {
+                entries_valid = false;
+                break;
+            }
+        }
+        if(!entries_valid) break;
+
+        for(size_t i = 0; i < header.entry_count; i++) {
+            AddressCache_set_at(
+                elf->relocation_cache, entries[i].symbol_index, entries[i].address);
+        }
+
+        FURI_LOG_I(TAG, "Using %lu cached imports", header.entry_count);
+        result = true;
+    } while(false);
+
+    if(entries) free(entries);
+    storage_file_free(file);
+    furi_string_free(path);
+    return result;
+}
+
+void elf_import_cache_save(ELFFile* elf) {
+    size_t entry_count = AddressCache_size(elf->import_cache);
+    if(!elf_import_cache_enabled(elf) || !entry_count) {
+        return;
+    }
+
+    elf_import_cache_check_key(elf);
+
+    FuriString* path = furi_string_alloc();
+    File* file = storage_file_alloc(elf->storage);
+    elf_import_cache_get_path(elf, path);
+
+    size_t entries_size = entry_count * sizeof(ELFImportCacheEntry);
+    ELFImportCacheEntry* entries = malloc(entries_size);
+
+    ELFImportCacheHeader header;
+    elf_import_cache_fill_header(elf, &header);
+    header.entry_count = entry_count;
+
+    size_t i = 0;
+    AddressCache_it_t it;
+    for(AddressCache_it(it, elf->import_cache); !AddressCache_end_p(it); AddressCache_next(it)) {
+        const AddressCache_itref_t* itref = AddressCache_cref(it);
+        entries[i].symbol_index = itref->key;
+        entries[i].address = itref->value;
+        i++;
+    }
+
+    bool success = false;
+    do {
+        if(!storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, entries, entries_size) != entries_size) break;
+        success = true;
+    } while(false);
+
+    if(success) {
+        FURI_LOG_I(TAG, "Stored %u imports", entry_count);
+    } else {
+        FURI_LOG_W(TAG, "Failed to store imports");
+        storage_file_close(file);
+        storage_common_remove(elf->storage, furi_string_get_cstr(path));
+    }
+
+    free(entries);
+    storage_file_free(file);
+    furi_string_free(path);
+}
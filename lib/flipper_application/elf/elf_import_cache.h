@@ -0,0 +1,25 @@
+#pragma once
+#include "elf_file_i.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fill relocation cache with API imports stored on previous load
+ * Requires symbol table to be loaded into RAM
+ * @param elf 
+ * @return true if cache was valid and applied
+ */
+bool elf_import_cache_load(ELFFile* elf);
+
+/**
+ * @brief Store API imports collected during relocation
+ * Requires symbol table to be loaded into RAM
+ * @param elf 
+ */
+void elf_import_cache_save(ELFFile* elf);
+
+#ifdef __cplusplus
+}
+#endif
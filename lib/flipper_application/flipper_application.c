@@ -8,6 +8,8 @@ struct FlipperApplication {
     FlipperApplicationManifest manifest;
     ELFFile* elf;
     FuriThread* thread;
+    uint32_t open_time;
+    uint32_t constructor_time;
 };
 
 /* For debugger access to app state */
@@ -36,6 +38,11 @@ void flipper_application_free(FlipperApplication* app) {
     free(app);
 }
 
+void flipper_application_enable_import_cache(FlipperApplication* app, const char* cache_dir) {
+    furi_assert(app);
+    elf_file_set_import_cache_dir(app->elf, cache_dir);
+}
+
 static FlipperApplicationPreloadStatus
     flipper_application_validate_manifest(FlipperApplication* app) {
     if(!flipper_application_manifest_is_valid(&app->manifest)) {
@@ -53,7 +60,21 @@ static FlipperApplicationPreloadStatus
 /* Parse headers, load manifest */
 FlipperApplicationPreloadStatus
     flipper_application_preload_manifest(FlipperApplication* app, const char* path) {
-    if(!elf_file_open(app->elf, path) || !elf_file_load_manifest(app->elf, &app->manifest)) {
+    uint32_t start = furi_get_tick();
+    bool result = elf_file_open(app->elf, path) &&
+                  elf_file_load_manifest(app->elf, &app->manifest);
+    app->open_time = furi_get_tick() - start;
+
+    if(!result) {
+        return FlipperApplicationPreloadStatusInvalidFile;
+    }
+
+    return flipper_application_validate_manifest(app);
+}
+
+/* Load full file, headers are already parsed */
+FlipperApplicationPreloadStatus flipper_application_preload_sections(FlipperApplication* app) {
+    if(!elf_file_load_section_table(app->elf, &app->manifest)) {
         return FlipperApplicationPreloadStatusInvalidFile;
     }
 
@@ -63,17 +84,38 @@ FlipperApplicationPreloadStatus
 /* Parse headers, load full file */
 FlipperApplicationPreloadStatus
     flipper_application_preload(FlipperApplication* app, const char* path) {
-    if(!elf_file_open(app->elf, path) || !elf_file_load_section_table(app->elf, &app->manifest)) {
+    uint32_t start = furi_get_tick();
+    bool result = elf_file_open(app->elf, path);
+    app->open_time = furi_get_tick() - start;
+
+    if(!result) {
         return FlipperApplicationPreloadStatusInvalidFile;
     }
 
-    return flipper_application_validate_manifest(app);
+    return flipper_application_preload_sections(app);
 }
 
 const FlipperApplicationManifest* flipper_application_get_manifest(FlipperApplication* app) {
     return &app->manifest;
 }
 
+/* Load address is needed to symbolize profiler samples offline */
+static void flipper_application_log_memory_map(FlipperApplication* app) {
+    const ELFDebugLinkInfo* debug_link = &app->state.debug_link_info;
+
+    for(size_t i = 0; i < app->state.mmap_entry_count; i++) {
+        const ELFMemoryMapEntry* entry = &app->state.mmap_entries[i];
+        if(entry->name && strcmp(entry->name, ".text") == 0) {
+            FURI_LOG_I(
+                TAG,
+                "%s: .text at 0x%08lX, debug info %s",
+                app->manifest.name,
+                entry->address,
+                debug_link->debug_link_size ? (const char*)debug_link->debug_link : "none");
+        }
+    }
+}
+
 FlipperApplicationLoadStatus flipper_application_map_to_memory(FlipperApplication* app) {
     last_loaded_app = app;
     ELFFileLoadStatus status = elf_file_load_sections(app->elf);
@@ -81,6 +123,7 @@ FlipperApplicationLoadStatus flipper_application_map_to_memory(FlipperApplicatio
     switch(status) {
     case ELFFileLoadStatusSuccess:
         elf_file_init_debug_info(app->elf, &app->state);
+        flipper_application_log_memory_map(app);
         return FlipperApplicationLoadStatusSuccess;
     case ELFFileLoadStatusNoFreeMemory:
         return FlipperApplicationLoadStatusNoFreeMemory;
@@ -91,8 +134,24 @@ FlipperApplicationLoadStatus flipper_application_map_to_memory(FlipperApplicatio
     }
 }
 
+void flipper_application_get_load_stats(
+    FlipperApplication* app,
+    FlipperApplicationLoadStats* stats) {
+    furi_assert(app);
+    furi_assert(stats);
+
+    const ELFLoadStats* elf_stats = elf_file_get_load_stats(app->elf);
+    stats->open_time = app->open_time;
+    stats->section_time = elf_stats->section_table_time;
+    stats->symbol_time = elf_stats->symbol_table_time;
+    stats->relocation_time = elf_stats->relocation_time;
+    stats->constructor_time = app->constructor_time;
+}
+
 static int32_t flipper_application_thread(void* context) {
+    uint32_t start = furi_get_tick();
     elf_file_pre_run(last_loaded_app->elf);
+    last_loaded_app->constructor_time = furi_get_tick() - start;
     int32_t result = elf_file_run(last_loaded_app->elf, context);
     elf_file_post_run(last_loaded_app->elf);
     return result;
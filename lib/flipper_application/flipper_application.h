@@ -53,6 +53,15 @@ typedef struct {
     uint32_t address;
 } FlipperApplicationMemoryMapEntry;
 
+/** Load stage durations, in milliseconds */
+typedef struct {
+    uint32_t open_time; /**< file open, ELF headers and manifest */
+    uint32_t section_time; /**< section table and section data load */
+    uint32_t symbol_time; /**< symbol table load and import resolution */
+    uint32_t relocation_time; /**< relocation */
+    uint32_t constructor_time; /**< static constructors */
+} FlipperApplicationLoadStats;
+
 typedef struct {
     uint32_t mmap_entry_count;
     FlipperApplicationMemoryMapEntry* mmap_entries;
@@ -75,6 +84,13 @@ FlipperApplication*
  */
 void flipper_application_free(FlipperApplication* app);
 
+/**
+ * @brief Enable cache of resolved API imports, speeds up repeated loads of the same application
+ * @param app Application pointer
+ * @param cache_dir Directory to store cache files in
+ */
+void flipper_application_enable_import_cache(FlipperApplication* app, const char* cache_dir);
+
 /**
  * @brief Validate elf file and load application metadata 
  * @param app Application pointer
@@ -91,6 +107,14 @@ FlipperApplicationPreloadStatus
 FlipperApplicationPreloadStatus
     flipper_application_preload_manifest(FlipperApplication* app, const char* path);
 
+/**
+ * @brief Finish preload of application with preloaded manifest, without opening file again.
+ * Same result as flipper_application_preload for the same path.
+ * @param app Application pointer, after successful flipper_application_preload_manifest
+ * @return Preload result code
+ */
+FlipperApplicationPreloadStatus flipper_application_preload_sections(FlipperApplication* app);
+
 /**
  * @brief Get pointer to application manifest for preloaded application
  * @param app Application pointer
@@ -105,6 +129,15 @@ const FlipperApplicationManifest* flipper_application_get_manifest(FlipperApplic
  */
 FlipperApplicationLoadStatus flipper_application_map_to_memory(FlipperApplication* app);
 
+/**
+ * @brief Get load stage durations. Constructor time is known after application thread start.
+ * @param app Application pointer
+ * @param stats Stats output
+ */
+void flipper_application_get_load_stats(
+    FlipperApplication* app,
+    FlipperApplicationLoadStats* stats);
+
 /**
  * @brief Create application thread at entry point address, using app name and
  * stack size from metadata. Returned thread isn't started yet. 
@@ -904,6 +904,110 @@ static void EccPoint_mult(uECC_word_t * result,
     uECC_vli_set(result + num_words, Ry[0], num_words);
 }
 
+#if (uECC_FIXED_BASE_COMB && uECC_SUPPORTS_secp256r1)
+/* Fixed-base comb multiplication by the secp256r1 generator (Lim-Lee, 4 teeth, 64 columns).
+   Every column costs one doubling and one addition, and a table lookup reads every entry,
+   so the timing does not depend on the scalar. */
+#define COMB_COLUMNS 64
+
+/* Returns all ones if 'a' == 'b', 0 otherwise. */
+static uECC_word_t comb_mask_eq(uECC_word_t a, uECC_word_t b) {
+    uECC_word_t diff = a ^ b;
+    return ((diff | (0 - diff)) >> (uECC_WORD_BITS - 1)) - 1;
+}
+
+/* Copies 'src' to 'dest' if 'mask' is all ones, leaves 'dest' unchanged if it is 0. */
+static void comb_cmov(uECC_word_t *dest,
+                      const uECC_word_t *src,
+                      uECC_word_t mask,
+                      wordcount_t num_words) {
+    wordcount_t i;
+    for (i = 0; i < num_words; ++i) {
+        dest[i] ^= (dest[i] ^ src[i]) & mask;
+    }
+}
+
+/* Sets 'point' to comb entry 'index', or to all zeros for index 0. */
+static void comb_select(uECC_word_t *point, uECC_word_t index, uECC_Curve curve) {
+    wordcount_t num_words = curve->num_words * 2;
+    uECC_word_t i;
+
+    uECC_vli_clear(point, num_words);
+    for (i = 1; i < 16; ++i) {
+        comb_cmov(point, comb_secp256r1[i - 1], comb_mask_eq(i, index), num_words);
+    }
+}
+
+/* (X1, Y1, Z) += affine (X2, Y2). (X2, Y2) is overwritten with the sum,
+   'Z2' receives its Z; (X1, Y1) is overwritten with the input rescaled to Z2. */
+static void comb_add(uECC_word_t * X1,
+                     uECC_word_t * Y1,
+                     const uECC_word_t * const Z,
+                     uECC_word_t * X2,
+                     uECC_word_t * Y2,
+                     uECC_word_t * Z2,
+                     uECC_Curve curve) {
+    apply_z(X2, Y2, Z, curve);
+    uECC_vli_modSub(Z2, X2, X1, curve->p, curve->num_words); /* x2 - x1 */
+    uECC_vli_modMult_fast(Z2, Z2, Z, curve);                 /* Z3 = Z * (x2 - x1) */
+    XYcZ_add(X1, Y1, X2, Y2, curve);
+}
+
+/* result = scalar * G, 0 < scalar < n. 'initial_Z' may be 0. */
+static void EccPoint_mult_comb(uECC_word_t * result,
+                               const uECC_word_t * scalar,
+                               const uECC_word_t * initial_Z,
+                               uECC_Curve curve) {
+    uECC_word_t Rx[uECC_MAX_WORDS];
+    uECC_word_t Ry[uECC_MAX_WORDS];
+    uECC_word_t Rz[uECC_MAX_WORDS];
+    uECC_word_t Px[uECC_MAX_WORDS];
+    uECC_word_t Py[uECC_MAX_WORDS];
+    uECC_word_t T[uECC_MAX_WORDS * 2];
+    uECC_word_t Tz[uECC_MAX_WORDS];
+    uECC_word_t index;
+    bitcount_t i;
+    wordcount_t num_words = curve->num_words;
+
+    /* Start from the offset point S instead of infinity; 2^64 * S is subtracted at the end. */
+    uECC_vli_set(Rx, comb_offset_secp256r1[0], num_words);
+    uECC_vli_set(Ry, comb_offset_secp256r1[0] + num_words, num_words);
+    if (initial_Z) {
+        uECC_vli_set(Rz, initial_Z, num_words);
+        apply_z(Rx, Ry, Rz, curve);
+    } else {
+        uECC_vli_clear(Rz, num_words);
+        Rz[0] = 1;
+    }
+
+    for (i = COMB_COLUMNS - 1; i >= 0; --i) {
+        curve->double_jacobian(Rx, Ry, Rz, curve);
+
+        index = (!!uECC_vli_testBit(scalar, i)) |
+                ((!!uECC_vli_testBit(scalar, i + COMB_COLUMNS)) << 1) |
+                ((!!uECC_vli_testBit(scalar, i + 2 * COMB_COLUMNS)) << 2) |
+                ((!!uECC_vli_testBit(scalar, i + 3 * COMB_COLUMNS)) << 3);
+        comb_select(T, index, curve);
+
+        /* Always add, keep the sum only for a non-zero column */
+        uECC_vli_set(Px, Rx, num_words);
+        uECC_vli_set(Py, Ry, num_words);
+        comb_add(Px, Py, Rz, T, T + num_words, Tz, curve);
+        index = ~comb_mask_eq(index, 0);
+        comb_cmov(Rx, T, index, num_words);
+        comb_cmov(Ry, T + num_words, index, num_words);
+        comb_cmov(Rz, Tz, index, num_words);
+    }
+
+    uECC_vli_set(T, comb_offset_secp256r1[1], num_words * 2);
+    comb_add(Rx, Ry, Rz, T, T + num_words, Tz, curve);
+
+    uECC_vli_modInv(Tz, Tz, curve->p, num_words);
+    apply_z(T, T + num_words, Tz, curve);
+    uECC_vli_set(result, T, num_words * 2);
+}
+#endif /* (uECC_FIXED_BASE_COMB && uECC_SUPPORTS_secp256r1) */
+
 static uECC_word_t regularize_k(const uECC_word_t * const k,
                                 uECC_word_t *k0,
                                 uECC_word_t *k1,
@@ -952,6 +1056,19 @@ static uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
     uECC_word_t *initial_Z = 0;
     uECC_word_t carry;
 
+#if (uECC_FIXED_BASE_COMB && uECC_SUPPORTS_secp256r1)
+    if (curve == &curve_secp256r1) {
+        if (g_rng_function) {
+            if (!uECC_generate_random_int(tmp1, curve->p, curve->num_words)) {
+                return 0;
+            }
+            initial_Z = tmp1;
+        }
+        EccPoint_mult_comb(result, private_key, initial_Z, curve);
+        return !EccPoint_isZero(result, curve);
+    }
+#endif
+
     /* Regularize the bitcount for the private key so that attackers cannot use a side channel
        attack to learn the number of leading zeros. */
     carry = regularize_k(private_key, tmp1, tmp2, curve);
@@ -1269,16 +1386,29 @@ static int uECC_sign_with_k_internal(const uint8_t *private_key,
         return 0;
     }
 
-    carry = regularize_k(k, tmp, s, curve);
-    /* If an RNG function was specified, try to get a random initial Z value to improve
-       protection against side-channel attacks. */
-    if (g_rng_function) {
-        if (!uECC_generate_random_int(k2[carry], curve->p, num_words)) {
-            return 0;
+#if (uECC_FIXED_BASE_COMB && uECC_SUPPORTS_secp256r1)
+    if (curve == &curve_secp256r1) {
+        if (g_rng_function) {
+            if (!uECC_generate_random_int(tmp, curve->p, num_words)) {
+                return 0;
+            }
+            initial_Z = tmp;
+        }
+        EccPoint_mult_comb(p, k, initial_Z, curve);
+    } else
+#endif
+    {
+        carry = regularize_k(k, tmp, s, curve);
+        /* If an RNG function was specified, try to get a random initial Z value to improve
+           protection against side-channel attacks. */
+        if (g_rng_function) {
+            if (!uECC_generate_random_int(k2[carry], curve->p, num_words)) {
+                return 0;
+            }
+            initial_Z = k2[carry];
         }
-        initial_Z = k2[carry];
+        EccPoint_mult(p, curve->G, k2[!carry], initial_Z, num_n_bits + 1, curve);
     }
-    EccPoint_mult(p, curve->G, k2[!carry], initial_Z, num_n_bits + 1, curve);
     if (uECC_vli_isZero(p, num_words)) {
         return 0;
     }
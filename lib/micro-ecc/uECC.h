@@ -37,6 +37,14 @@ faster somewhat faster, but increases the code size. */
     #define uECC_SQUARE_FUNC 0
 #endif
 
+/* uECC_FIXED_BASE_COMB - If enabled (defined as nonzero), multiplications by the generator point
+of secp256r1 (key generation, public key computation and signing) use a precomputed comb table
+instead of the Montgomery ladder. This is about three times faster, but adds ~1 KB of constant
+data. */
+#ifndef uECC_FIXED_BASE_COMB
+    #define uECC_FIXED_BASE_COMB 0
+#endif
+
 /* uECC_VLI_NATIVE_LITTLE_ENDIAN - If enabled (defined as nonzero), this will switch to native
 little-endian format for *all* arrays passed in and out of the public API. This includes public
 and private keys, shared secrets, signatures and message hashes.
@@ -149,6 +149,9 @@ bool ibutton_worker_read_dallas(iButtonWorker* worker) {
     bool result = false;
     onewire_host_start(worker->host);
     furi_delay_ms(100);
+    bool key_valid = false;
+
+    // Only bus transactions here, slot transfers are polled while scheduler is masked
     FURI_CRITICAL_ENTER();
     if(onewire_host_search(worker->host, worker->key_data, NORMAL_SEARCH)) {
         onewire_host_reset_search(worker->host);
@@ -156,27 +159,30 @@ bool ibutton_worker_read_dallas(iButtonWorker* worker) {
         // key found, verify
         if(onewire_host_reset(worker->host)) {
             onewire_host_write(worker->host, DS1990_CMD_READ_ROM);
-            bool key_valid = true;
+            key_valid = true;
             for(uint8_t i = 0; i < ibutton_key_get_max_size(); i++) {
                 if(onewire_host_read(worker->host) != worker->key_data[i]) {
                     key_valid = false;
                     break;
                 }
             }
-
-            if(key_valid) {
-                result = true;
-
-                furi_check(worker->key_p != NULL);
-                ibutton_key_set_type(worker->key_p, iButtonKeyDS1990);
-                ibutton_key_set_data(worker->key_p, worker->key_data, ibutton_key_get_max_size());
-            }
         }
     } else {
         onewire_host_reset_search(worker->host);
     }
-    onewire_host_stop(worker->host);
     FURI_CRITICAL_EXIT();
+
+    // Releases slot timer, DMA ISR and memory, must not run in critical section
+    onewire_host_stop(worker->host);
+
+    if(key_valid) {
+        result = true;
+
+        furi_check(worker->key_p != NULL);
+        ibutton_key_set_type(worker->key_p, iButtonKeyDS1990);
+        ibutton_key_set_data(worker->key_p, worker->key_data, ibutton_key_get_max_size());
+    }
+
     return result;
 }
 
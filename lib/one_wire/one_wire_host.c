@@ -3,14 +3,43 @@
 #include "one_wire_host.h"
 #include "one_wire_host_timing.h"
 
+#define OWH_BYTES_PER_TRANSFER (FURI_HAL_IBUTTON_SLOTS_MAX / 8)
+
 struct OneWireHost {
     // global search state
     unsigned char saved_rom[8];
     uint8_t last_discrepancy;
     uint8_t last_family_discrepancy;
     bool last_device_flag;
+    // slot queue
+    uint16_t pulse[FURI_HAL_IBUTTON_SLOTS_MAX];
+    bool level[FURI_HAL_IBUTTON_SLOTS_MAX];
+    // simulated bus
+    OneWireHostTransferCallback transfer_callback;
+    void* transfer_context;
 };
 
+static void onewire_host_transfer_ex(
+    OneWireHost* host,
+    size_t count,
+    uint16_t period,
+    uint16_t sample) {
+    if(host->transfer_callback) {
+        host->transfer_callback(
+            host->pulse, host->level, count, period, sample, host->transfer_context);
+    } else {
+        furi_hal_ibutton_slots_transfer(host->pulse, host->level, count, period, sample);
+    }
+}
+
+static inline void onewire_host_transfer(OneWireHost* host, size_t count) {
+    onewire_host_transfer_ex(host, count, OWH_SLOT_PERIOD, OWH_SLOT_SAMPLE);
+}
+
+static inline uint16_t onewire_host_write_pulse(bool value) {
+    return value ? OWH_WRITE_1_DRIVE : OWH_WRITE_0_DRIVE;
+}
+
 OneWireHost* onewire_host_alloc() {
     OneWireHost* host = malloc(sizeof(OneWireHost));
     onewire_host_reset_search(host);
@@ -23,99 +52,66 @@ void onewire_host_free(OneWireHost* host) {
 }
 
 bool onewire_host_reset(OneWireHost* host) {
-    UNUSED(host);
-    uint8_t r;
     uint8_t retries = 125;
 
     // wait until the gpio is high
-    furi_hal_ibutton_pin_high();
-    do {
+    while(!host->transfer_callback && !furi_hal_ibutton_pin_get_level()) {
         if(--retries == 0) return 0;
         furi_delay_us(2);
-    } while(!furi_hal_ibutton_pin_get_level());
-
-    // pre delay
-    furi_delay_us(OWH_RESET_DELAY_PRE);
-
-    // drive low
-    furi_hal_ibutton_pin_low();
-    furi_delay_us(OWH_RESET_DRIVE);
-
-    // release
-    furi_hal_ibutton_pin_high();
-    furi_delay_us(OWH_RESET_RELEASE);
+    }
 
-    // read and post delay
-    r = !furi_hal_ibutton_pin_get_level();
-    furi_delay_us(OWH_RESET_DELAY_POST);
+    // drive low, release and look for presence pulse
+    host->pulse[0] = OWH_RESET_DRIVE;
+    onewire_host_transfer_ex(host, 1, OWH_RESET_PERIOD, OWH_RESET_SAMPLE);
 
-    return r;
+    return !host->level[0];
 }
 
 bool onewire_host_read_bit(OneWireHost* host) {
-    UNUSED(host);
-    bool result;
-
-    // drive low
-    furi_hal_ibutton_pin_low();
-    furi_delay_us(OWH_READ_DRIVE);
-
-    // release
-    furi_hal_ibutton_pin_high();
-    furi_delay_us(OWH_READ_RELEASE);
-
-    // read and post delay
-    result = furi_hal_ibutton_pin_get_level();
-    furi_delay_us(OWH_READ_DELAY_POST);
-
-    return result;
+    host->pulse[0] = OWH_READ_DRIVE;
+    onewire_host_transfer(host, 1);
+    return host->level[0];
 }
 
 uint8_t onewire_host_read(OneWireHost* host) {
-    uint8_t result = 0;
-
-    for(uint8_t bitMask = 0x01; bitMask; bitMask <<= 1) {
-        if(onewire_host_read_bit(host)) {
-            result |= bitMask;
-        }
-    }
-
+    uint8_t result;
+    onewire_host_read_bytes(host, &result, 1);
     return result;
 }
 
 void onewire_host_read_bytes(OneWireHost* host, uint8_t* buffer, uint16_t count) {
-    for(uint16_t i = 0; i < count; i++) {
-        buffer[i] = onewire_host_read(host);
+    while(count) {
+        uint16_t bytes = MIN(count, OWH_BYTES_PER_TRANSFER);
+        for(size_t i = 0; i < bytes * 8U; i++) {
+            host->pulse[i] = OWH_READ_DRIVE;
+        }
+        onewire_host_transfer(host, bytes * 8);
+
+        for(size_t i = 0; i < bytes; i++) {
+            uint8_t result = 0;
+            for(uint8_t bit = 0; bit < 8; bit++) {
+                if(host->level[i * 8 + bit]) {
+                    result |= 1 << bit;
+                }
+            }
+            buffer[i] = result;
+        }
+
+        buffer += bytes;
+        count -= bytes;
     }
 }
 
 void onewire_host_write_bit(OneWireHost* host, bool value) {
-    UNUSED(host);
-    if(value) {
-        // drive low
-        furi_hal_ibutton_pin_low();
-        furi_delay_us(OWH_WRITE_1_DRIVE);
-
-        // release
-        furi_hal_ibutton_pin_high();
-        furi_delay_us(OWH_WRITE_1_RELEASE);
-    } else {
-        // drive low
-        furi_hal_ibutton_pin_low();
-        furi_delay_us(OWH_WRITE_0_DRIVE);
-
-        // release
-        furi_hal_ibutton_pin_high();
-        furi_delay_us(OWH_WRITE_0_RELEASE);
-    }
+    host->pulse[0] = onewire_host_write_pulse(value);
+    onewire_host_transfer(host, 1);
 }
 
 void onewire_host_write(OneWireHost* host, uint8_t value) {
-    uint8_t bitMask;
-
-    for(bitMask = 0x01; bitMask; bitMask <<= 1) {
-        onewire_host_write_bit(host, (bitMask & value) ? 1 : 0);
+    for(uint8_t bit = 0; bit < 8; bit++) {
+        host->pulse[bit] = onewire_host_write_pulse(value & (1 << bit));
     }
+    onewire_host_transfer(host, 8);
 }
 
 void onewire_host_skip(OneWireHost* host) {
@@ -123,15 +119,25 @@ void onewire_host_skip(OneWireHost* host) {
 }
 
 void onewire_host_start(OneWireHost* host) {
-    UNUSED(host);
-    furi_hal_ibutton_start_drive();
+    if(host->transfer_callback) return;
+    furi_hal_ibutton_slots_start();
 }
 
 void onewire_host_stop(OneWireHost* host) {
-    UNUSED(host);
+    if(host->transfer_callback) return;
+    furi_hal_ibutton_slots_stop();
     furi_hal_ibutton_stop();
 }
 
+void onewire_host_set_transfer_callback(
+    OneWireHost* host,
+    OneWireHostTransferCallback callback,
+    void* context) {
+    furi_assert(host);
+    host->transfer_callback = callback;
+    host->transfer_context = context;
+}
+
 void onewire_host_reset_search(OneWireHost* host) {
     host->last_discrepancy = 0;
     host->last_device_flag = false;
@@ -150,10 +156,31 @@ void onewire_host_target_search(OneWireHost* host, uint8_t family_code) {
     host->last_device_flag = false;
 }
 
+// Search triplet: pending direction bit of the previous step is written
+// in the same transfer as the next bit and its complement are read
+static void onewire_host_search_triplet(
+    OneWireHost* host,
+    int8_t* direction,
+    uint8_t* id_bit,
+    uint8_t* cmp_id_bit) {
+    size_t count = 0;
+    if(*direction >= 0) {
+        host->pulse[count++] = onewire_host_write_pulse(*direction);
+        *direction = -1;
+    }
+    host->pulse[count] = OWH_READ_DRIVE;
+    host->pulse[count + 1] = OWH_READ_DRIVE;
+    onewire_host_transfer(host, count + 2);
+
+    *id_bit = host->level[count];
+    *cmp_id_bit = host->level[count + 1];
+}
+
 uint8_t onewire_host_search(OneWireHost* host, uint8_t* newAddr, OneWireHostSearchMode mode) {
     uint8_t id_bit_number;
     uint8_t last_zero, rom_byte_number, search_result;
     uint8_t id_bit, cmp_id_bit;
+    int8_t pending_direction = -1;
 
     unsigned char rom_byte_mask, search_direction;
 
@@ -188,8 +215,7 @@ uint8_t onewire_host_search(OneWireHost* host, uint8_t* newAddr, OneWireHostSear
         // loop to do the search
         do {
             // read a bit and its complement
-            id_bit = onewire_host_read_bit(host);
-            cmp_id_bit = onewire_host_read_bit(host);
+            onewire_host_search_triplet(host, &pending_direction, &id_bit, &cmp_id_bit);
 
             // check for no devices on 1-wire
             if((id_bit == 1) && (cmp_id_bit == 1))
@@ -224,8 +250,8 @@ uint8_t onewire_host_search(OneWireHost* host, uint8_t* newAddr, OneWireHostSear
                 else
                     host->saved_rom[rom_byte_number] &= ~rom_byte_mask;
 
-                // serial number search direction write bit
-                onewire_host_write_bit(host, search_direction);
+                // serial number search direction write bit, sent with the next read
+                pending_direction = search_direction;
 
                 // increment the byte counter id_bit_number
                 // and shift the mask rom_byte_mask
@@ -240,6 +266,10 @@ uint8_t onewire_host_search(OneWireHost* host, uint8_t* newAddr, OneWireHostSear
             }
         } while(rom_byte_number < 8); // loop until through all ROM bytes 0-7
 
+        if(pending_direction >= 0) {
+            onewire_host_write_bit(host, pending_direction);
+        }
+
         // if the search was successful then
         if(!(id_bit_number < 65)) {
             // search successful so set last_Discrepancy, last_device_flag, search_result
@@ -7,6 +7,7 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <furi_hal_gpio.h>
 
 #ifdef __cplusplus
@@ -20,6 +21,17 @@ typedef enum {
 
 typedef struct OneWireHost OneWireHost;
 
+/**
+ * Time slot transfer, same contract as furi_hal_ibutton_slots_transfer
+ */
+typedef void (*OneWireHostTransferCallback)(
+    const uint16_t* pulse,
+    bool* level,
+    size_t count,
+    uint16_t period,
+    uint16_t sample,
+    void* context);
+
 /**
  * Allocate onewire host bus
  * @param gpio 
@@ -94,6 +106,17 @@ void onewire_host_start(OneWireHost* host);
  */
 void onewire_host_stop(OneWireHost* host);
 
+/**
+ * Replace hardware slot generator, used to run host on simulated bus
+ * @param host 
+ * @param callback transfer callback, NULL to use hardware
+ * @param context 
+ */
+void onewire_host_set_transfer_callback(
+    OneWireHost* host,
+    OneWireHostTransferCallback callback,
+    void* context);
+
 /**
  * 
  * @param host 
@@ -28,3 +28,9 @@
 #define OWH_RESET_DRIVE OWH_TIMING_H
 #define OWH_RESET_RELEASE OWH_TIMING_I
 #define OWH_RESET_DELAY_POST OWH_TIMING_J
+
+// Hardware generated slots: every slot has the same length, pin is sampled at read point
+#define OWH_SLOT_PERIOD (OWH_WRITE_0_DRIVE + OWH_WRITE_0_RELEASE)
+#define OWH_SLOT_SAMPLE (OWH_READ_DRIVE + OWH_READ_RELEASE)
+#define OWH_RESET_PERIOD (OWH_RESET_DRIVE + OWH_RESET_RELEASE + OWH_RESET_DELAY_POST)
+#define OWH_RESET_SAMPLE (OWH_RESET_DRIVE + OWH_RESET_RELEASE)
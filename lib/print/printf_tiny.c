@@ -56,6 +56,13 @@
 #define PRINTF_FTOA_BUFFER_SIZE 32U
 #endif
 
+// output chunk buffer size, printf() collects output on stack and passes it
+// to _putchars() in chunks of this size (dynamically created on stack)
+// default: 64 byte
+#ifndef PRINTF_OUT_CHUNK_SIZE
+#define PRINTF_OUT_CHUNK_SIZE 64U
+#endif
+
 // support for the floating point type (%f)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_FLOAT
@@ -117,6 +124,12 @@
 // output function type
 typedef void (*out_fct_type)(char character, void* buffer, size_t idx, size_t maxlen);
 
+// chunk (used as buffer) for output to _putchars
+typedef struct {
+    size_t size;
+    char data[PRINTF_OUT_CHUNK_SIZE];
+} out_chunk_type;
+
 // wrapper (used as buffer) for output function type
 typedef struct {
     void (*fct)(char character, void* arg);
@@ -148,6 +161,20 @@ static inline void _out_char(char character, void* buffer, size_t idx, size_t ma
     }
 }
 
+// internal _putchars wrapper
+static inline void _out_chunk(char character, void* buffer, size_t idx, size_t maxlen) {
+    (void)idx;
+    (void)maxlen;
+    if(character) {
+        out_chunk_type* chunk = (out_chunk_type*)buffer;
+        chunk->data[chunk->size++] = character;
+        if(chunk->size == PRINTF_OUT_CHUNK_SIZE) {
+            _putchars(chunk->data, chunk->size);
+            chunk->size = 0;
+        }
+    }
+}
+
 // internal output function wrapper
 static inline void _out_fct(char character, void* buffer, size_t idx, size_t maxlen) {
     (void)idx;
@@ -996,8 +1023,7 @@ static int
 int printf_(const char* format, ...) {
     va_list va;
     va_start(va, format);
-    char buffer[1];
-    const int ret = _vsnprintf(_out_char, buffer, (size_t)-1, format, va);
+    const int ret = vprintf_(format, va);
     va_end(va);
     return ret;
 }
@@ -1019,8 +1045,13 @@ int snprintf_(char* buffer, size_t count, const char* format, ...) {
 }
 
 int vprintf_(const char* format, va_list va) {
-    char buffer[1];
-    return _vsnprintf(_out_char, buffer, (size_t)-1, format, va);
+    out_chunk_type chunk;
+    chunk.size = 0;
+    const int ret = _vsnprintf(_out_chunk, (char*)(uintptr_t)&chunk, (size_t)-1, format, va);
+    if(chunk.size) {
+        _putchars(chunk.data, chunk.size);
+    }
+    return ret;
 }
 
 int vsnprintf_(char* buffer, size_t count, const char* format, va_list va) {
@@ -47,9 +47,17 @@ extern "C" {
  */
 void _putchar(char character);
 
+/**
+ * Output a chunk of characters to a custom device, used by the printf() function
+ * This function is declared here only. You have to write your custom implementation somewhere
+ * \param data Characters to output, not null terminated
+ * \param size Amount of characters
+ */
+void _putchars(const char* data, size_t size);
+
 /**
  * Tiny printf implementation
- * You have to implement _putchar if you use printf()
+ * You have to implement _putchars if you use printf()
  * To avoid conflicts with the regular printf() API it is overridden by macro defines
  * and internal underscore-appended functions like printf_() are used
  * \param format A string that specifies the format of the output
@@ -11,6 +11,10 @@ void _putchar(char character) {
     furi_thread_stdout_write(&character, 1);
 }
 
+void _putchars(const char* data, size_t size) {
+    furi_thread_stdout_write(data, size);
+}
+
 int __wrap_printf(const char* format, ...) {
     va_list args;
     va_start(args, format);
@@ -7,6 +7,7 @@ extern "C" {
 #endif
 
 void _putchar(char character);
+void _putchars(const char* data, size_t size);
 int __wrap_printf(const char* format, ...);
 int __wrap_vsnprintf(char* str, size_t size, const char* format, va_list args);
 int __wrap_puts(const char* str);
@@ -0,0 +1,599 @@
+#include "subghz_history_store.h"
+
+#include <string.h>
+#include <furi.h>
+#include <m-array.h>
+#include <storage/storage.h>
+#include <toolbox/stream/stream.h>
+#include <toolbox/stream/file_stream.h>
+#include <flipper_format/flipper_format_i.h>
+
+#define TAG "SubGhzHistoryStore"
+
+#define SUBGHZ_HISTORY_STORE_NONE 0xFF
+#define SUBGHZ_HISTORY_STORE_HASH_SIZE 32
+#define SUBGHZ_HISTORY_STORE_CACHE_SIZE 8
+
+/* Records live in RAM ring of ram_records slots, record idx is in slot
+ * idx % ram_records. When ring is full, oldest record is appended to the
+ * log: fixed size entry to ".idx" file at idx * sizeof(entry) and key
+ * data to ".dat" file. Log is created on first spill only.
+ *
+ * Log I/O is done under io_mutex only: receiver thread adding records and
+ * GUI reading them are not blocked by SD-card writes. Spilled records are
+ * immutable, recently read ones are cached, so menu redraws don't hit SD-card.
+ * Lock order is io_mutex, then mutex.
+ */
+typedef struct {
+    SubGhzHistoryRecord record;
+    FlipperFormat* data;
+    uint32_t generation;
+    uint8_t hash_next;
+} SubGhzHistoryStoreSlot;
+
+typedef struct {
+    SubGhzHistoryRecord record;
+    uint16_t idx;
+    bool valid;
+} SubGhzHistoryStoreCacheEntry;
+
+typedef struct {
+    SubGhzHistoryRecord record;
+    uint32_t data_offset;
+    uint32_t data_size;
+} SubGhzHistoryStoreLogEntry;
+
+ARRAY_DEF(SubGhzHistoryStorePresetArray, SubGhzRadioPreset, M_POD_OPLIST)
+
+struct SubGhzHistoryStore {
+    FuriMutex* mutex;
+    FuriMutex* io_mutex;
+    FlipperFormat* spill_data;
+    uint32_t epoch;
+    Storage* storage;
+    FuriString* index_path;
+    FuriString* data_path;
+    Stream* index_stream;
+    Stream* data_stream;
+    bool spill_enabled;
+    bool spill_opened;
+    uint16_t count;
+    uint16_t max_records;
+    uint8_t ram_records;
+    uint8_t ram_count;
+    uint8_t hash[SUBGHZ_HISTORY_STORE_HASH_SIZE];
+    SubGhzHistoryStoreSlot* slots;
+    SubGhzHistoryStoreCacheEntry cache[SUBGHZ_HISTORY_STORE_CACHE_SIZE];
+    SubGhzHistoryStorePresetArray_t presets;
+};
+
+static inline uint8_t subghz_history_store_bucket(uint32_t hash) {
+    return hash % SUBGHZ_HISTORY_STORE_HASH_SIZE;
+}
+
+static void subghz_history_store_hash_insert(SubGhzHistoryStore* instance, uint8_t slot) {
+    uint8_t* bucket =
+        &instance->hash[subghz_history_store_bucket(instance->slots[slot].record.hash)];
+    instance->slots[slot].hash_next = *bucket;
+    *bucket = slot;
+}
+
+static void subghz_history_store_hash_remove(SubGhzHistoryStore* instance, uint8_t slot) {
+    uint8_t* link =
+        &instance->hash[subghz_history_store_bucket(instance->slots[slot].record.hash)];
+    while(*link != SUBGHZ_HISTORY_STORE_NONE) {
+        if(*link == slot) {
+            *link = instance->slots[slot].hash_next;
+            break;
+        }
+        link = &instance->slots[*link].hash_next;
+    }
+}
+
+static SubGhzHistoryStoreSlot*
+    subghz_history_store_get_slot(SubGhzHistoryStore* instance, uint16_t idx) {
+    if((idx >= instance->count) || (idx < instance->count - instance->ram_count)) {
+        return NULL;
+    }
+    return &instance->slots[idx % instance->ram_records];
+}
+
+static void subghz_history_store_copy_data(FlipperFormat* from, FlipperFormat* to) {
+    Stream* stream_to = flipper_format_get_raw_stream(to);
+    stream_clean(stream_to);
+    stream_copy_full(flipper_format_get_raw_stream(from), stream_to);
+    flipper_format_rewind(to);
+}
+
+static uint8_t
+    subghz_history_store_get_preset_index(SubGhzHistoryStore* instance, SubGhzRadioPreset* preset) {
+    size_t index = 0;
+    for
+        M_EACH(item, instance->presets, SubGhzHistoryStorePresetArray_t) {
+            if((item->data == preset->data) && (item->data_size == preset->data_size) &&
+               furi_string_equal(item->name, preset->name)) {
+                return index;
+            }
+            index++;
+        }
+
+    furi_check(index < UINT8_MAX);
+    SubGhzRadioPreset* item = SubGhzHistoryStorePresetArray_push_raw(instance->presets);
+    item->name = furi_string_alloc_set(preset->name);
+    item->frequency = 0;
+    item->data = preset->data;
+    item->data_size = preset->data_size;
+    return index;
+}
+
+static void subghz_history_store_spill_close(SubGhzHistoryStore* instance) {
+    if(instance->spill_opened) {
+        file_stream_close(instance->index_stream);
+        file_stream_close(instance->data_stream);
+        storage_common_remove(instance->storage, furi_string_get_cstr(instance->index_path));
+        storage_common_remove(instance->storage, furi_string_get_cstr(instance->data_path));
+        instance->spill_opened = false;
+    }
+}
+
+static bool subghz_history_store_spill_open(SubGhzHistoryStore* instance) {
+    if(instance->spill_opened) return true;
+
+    bool result = false;
+    do {
+        if(!file_stream_open(
+               instance->index_stream,
+               furi_string_get_cstr(instance->index_path),
+               FSAM_READ_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            file_stream_close(instance->index_stream);
+            break;
+        }
+        if(!file_stream_open(
+               instance->data_stream,
+               furi_string_get_cstr(instance->data_path),
+               FSAM_READ_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            file_stream_close(instance->index_stream);
+            file_stream_close(instance->data_stream);
+            storage_common_remove(instance->storage, furi_string_get_cstr(instance->index_path));
+            break;
+        }
+        instance->spill_opened = true;
+        result = true;
+    } while(false);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to open log");
+    }
+    return result;
+}
+
+static bool subghz_history_store_write_entry(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzHistoryStoreLogEntry* entry) {
+    bool result = false;
+    do {
+        Stream* data_stream = flipper_format_get_raw_stream(instance->spill_data);
+        if(!stream_seek(instance->data_stream, 0, StreamOffsetFromEnd)) break;
+        entry->data_offset = stream_tell(instance->data_stream);
+        entry->data_size = stream_size(data_stream);
+        if(!stream_rewind(data_stream)) break;
+        if(stream_copy(data_stream, instance->data_stream, entry->data_size) != entry->data_size)
+            break;
+
+        if(!stream_seek(instance->index_stream, idx * sizeof(*entry), StreamOffsetFromStart))
+            break;
+        if(stream_write(instance->index_stream, (uint8_t*)entry, sizeof(*entry)) !=
+           sizeof(*entry))
+            break;
+        result = true;
+    } while(false);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to spill record %u", idx);
+    }
+    return result;
+}
+
+/* Move oldest RAM record to the log. Record is copied under mutex and written
+ * without it. If record was updated meanwhile it stays in RAM, log entry of
+ * the same idx is rewritten on the next attempt.
+ */
+static bool subghz_history_store_spill_oldest(SubGhzHistoryStore* instance) {
+    furi_check(furi_mutex_acquire(instance->io_mutex, FuriWaitForever) == FuriStatusOk);
+
+    bool spill = false;
+    uint16_t idx = 0;
+    uint32_t generation = 0;
+    SubGhzHistoryStoreLogEntry entry;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->spill_enabled && instance->ram_count) {
+        idx = instance->count - instance->ram_count;
+        SubGhzHistoryStoreSlot* slot = &instance->slots[idx % instance->ram_records];
+        entry.record = slot->record;
+        generation = slot->generation;
+        subghz_history_store_copy_data(slot->data, instance->spill_data);
+        spill = true;
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    bool result = false;
+    if(spill) {
+        result = subghz_history_store_spill_open(instance) &&
+                 subghz_history_store_write_entry(instance, idx, &entry);
+
+        furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+        uint8_t slot_index = idx % instance->ram_records;
+        if(!result) {
+            /* no way to keep log consistent, stop growing */
+            instance->spill_enabled = false;
+        } else if(instance->slots[slot_index].generation == generation) {
+            /* only spill removes records from RAM and reset waits for io_mutex */
+            subghz_history_store_hash_remove(instance, slot_index);
+            instance->ram_count--;
+        } else {
+            result = false;
+        }
+        furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+    }
+
+    furi_check(furi_mutex_release(instance->io_mutex) == FuriStatusOk);
+    return result;
+}
+
+static bool subghz_history_store_read_entry(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzHistoryStoreLogEntry* entry) {
+    if(!instance->spill_opened) return false;
+
+    bool result = false;
+    do {
+        if(!stream_seek(instance->index_stream, idx * sizeof(*entry), StreamOffsetFromStart))
+            break;
+        if(stream_read(instance->index_stream, (uint8_t*)entry, sizeof(*entry)) != sizeof(*entry))
+            break;
+        result = true;
+    } while(false);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to read record %u", idx);
+    }
+    return result;
+}
+
+static bool subghz_history_store_cache_get(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzHistoryRecord* record) {
+    SubGhzHistoryStoreCacheEntry* entry =
+        &instance->cache[idx % SUBGHZ_HISTORY_STORE_CACHE_SIZE];
+    if(entry->valid && entry->idx == idx) {
+        *record = entry->record;
+        return true;
+    }
+    return false;
+}
+
+static void subghz_history_store_cache_set(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    const SubGhzHistoryRecord* record) {
+    SubGhzHistoryStoreCacheEntry* entry =
+        &instance->cache[idx % SUBGHZ_HISTORY_STORE_CACHE_SIZE];
+    entry->record = *record;
+    entry->idx = idx;
+    entry->valid = true;
+}
+
+static void subghz_history_store_clear(SubGhzHistoryStore* instance) {
+    for(uint8_t i = 0; i < instance->ram_records; i++) {
+        if(instance->slots[i].data) {
+            flipper_format_free(instance->slots[i].data);
+            instance->slots[i].data = NULL;
+        }
+        instance->slots[i].hash_next = SUBGHZ_HISTORY_STORE_NONE;
+    }
+    memset(instance->hash, SUBGHZ_HISTORY_STORE_NONE, sizeof(instance->hash));
+    memset(instance->cache, 0, sizeof(instance->cache));
+    instance->epoch++;
+
+    for
+        M_EACH(item, instance->presets, SubGhzHistoryStorePresetArray_t) {
+            furi_string_free(item->name);
+        }
+    SubGhzHistoryStorePresetArray_reset(instance->presets);
+
+    subghz_history_store_spill_close(instance);
+    instance->count = 0;
+    instance->ram_count = 0;
+}
+
+SubGhzHistoryStore*
+    subghz_history_store_alloc(const char* spill_path, uint8_t ram_records, uint16_t max_records) {
+    furi_assert(spill_path);
+    furi_assert(ram_records && (ram_records < SUBGHZ_HISTORY_STORE_NONE));
+    furi_assert(max_records >= ram_records);
+
+    SubGhzHistoryStore* instance = malloc(sizeof(SubGhzHistoryStore));
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->io_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->spill_data = flipper_format_string_alloc();
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    instance->index_path = furi_string_alloc_printf("%s.idx", spill_path);
+    instance->data_path = furi_string_alloc_printf("%s.dat", spill_path);
+    instance->index_stream = file_stream_alloc(instance->storage);
+    instance->data_stream = file_stream_alloc(instance->storage);
+    instance->ram_records = ram_records;
+    instance->max_records = max_records;
+    instance->slots = malloc(sizeof(SubGhzHistoryStoreSlot) * ram_records);
+    SubGhzHistoryStorePresetArray_init(instance->presets);
+
+    subghz_history_store_clear(instance);
+    instance->spill_enabled = (storage_sd_status(instance->storage) == FSE_OK);
+
+    return instance;
+}
+
+void subghz_history_store_free(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+
+    subghz_history_store_clear(instance);
+    SubGhzHistoryStorePresetArray_clear(instance->presets);
+    free(instance->slots);
+    stream_free(instance->index_stream);
+    stream_free(instance->data_stream);
+    furi_string_free(instance->index_path);
+    furi_string_free(instance->data_path);
+    furi_record_close(RECORD_STORAGE);
+    flipper_format_free(instance->spill_data);
+    furi_mutex_free(instance->io_mutex);
+    furi_mutex_free(instance->mutex);
+    free(instance);
+}
+
+void subghz_history_store_reset(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+    furi_check(furi_mutex_acquire(instance->io_mutex, FuriWaitForever) == FuriStatusOk);
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    subghz_history_store_clear(instance);
+    instance->spill_enabled = (storage_sd_status(instance->storage) == FSE_OK);
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+    furi_check(furi_mutex_release(instance->io_mutex) == FuriStatusOk);
+}
+
+void subghz_history_store_flush(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+
+    /* keep a quarter of the ring free, bounded amount of writes per call */
+    uint8_t reserve = MAX(instance->ram_records / 4, 1);
+    for(uint8_t i = 0; i < reserve; i++) {
+        furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+        bool spill = instance->spill_enabled &&
+                     (instance->ram_count > instance->ram_records - reserve);
+        furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+        if(!spill || !subghz_history_store_spill_oldest(instance)) break;
+    }
+}
+
+uint16_t subghz_history_store_get_count(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+    return instance->count;
+}
+
+uint16_t subghz_history_store_get_capacity(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+    uint16_t capacity;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->spill_enabled) {
+        capacity = instance->max_records;
+    } else {
+        /* records already spilled stay readable, only RAM ring is left */
+        capacity = instance->count - instance->ram_count + instance->ram_records;
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+    return capacity;
+}
+
+bool subghz_history_store_is_spill_enabled(SubGhzHistoryStore* instance) {
+    furi_assert(instance);
+    return instance->spill_enabled;
+}
+
+bool subghz_history_store_find(SubGhzHistoryStore* instance, uint32_t hash, uint16_t* idx) {
+    furi_assert(instance);
+    furi_assert(idx);
+
+    bool result = false;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    uint8_t slot = instance->hash[subghz_history_store_bucket(hash)];
+    uint16_t first = instance->count - instance->ram_count;
+    while(slot != SUBGHZ_HISTORY_STORE_NONE) {
+        if(instance->slots[slot].record.hash == hash) {
+            /* newest record is at chain head, map slot back to index */
+            uint16_t found = first + (slot + instance->ram_records -
+                                      (first % instance->ram_records)) %
+                                         instance->ram_records;
+            *idx = found;
+            result = true;
+            break;
+        }
+        slot = instance->slots[slot].hash_next;
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+    return result;
+}
+
+bool subghz_history_store_add(
+    SubGhzHistoryStore* instance,
+    const SubGhzHistoryRecord* record,
+    SubGhzRadioPreset* preset,
+    FlipperFormat* data) {
+    furi_assert(instance);
+    furi_assert(record);
+    furi_assert(preset);
+    furi_assert(data);
+
+    /* ring is full: subghz_history_store_flush was not called often enough */
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    bool full = (instance->ram_count == instance->ram_records);
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+    if(full) {
+        FURI_LOG_D(TAG, "Ring is full, spilling from add");
+        subghz_history_store_spill_oldest(instance);
+    }
+
+    bool result = false;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    do {
+        if(instance->count >= instance->max_records) break;
+        if(instance->ram_count == instance->ram_records) break;
+
+        uint8_t slot_index = instance->count % instance->ram_records;
+        SubGhzHistoryStoreSlot* slot = &instance->slots[slot_index];
+        slot->record = *record;
+        slot->generation++;
+        slot->record.preset = subghz_history_store_get_preset_index(instance, preset);
+        if(!slot->data) slot->data = flipper_format_string_alloc();
+        subghz_history_store_copy_data(data, slot->data);
+        subghz_history_store_hash_insert(instance, slot_index);
+
+        instance->ram_count++;
+        instance->count++;
+        result = true;
+    } while(false);
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    return result;
+}
+
+bool subghz_history_store_update(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    const SubGhzHistoryRecord* record,
+    FlipperFormat* data) {
+    furi_assert(instance);
+    furi_assert(record);
+
+    bool result = false;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    SubGhzHistoryStoreSlot* slot = subghz_history_store_get_slot(instance, idx);
+    if(slot) {
+        uint8_t slot_index = slot - instance->slots;
+        uint8_t preset = slot->record.preset;
+        if(slot->record.hash != record->hash) {
+            subghz_history_store_hash_remove(instance, slot_index);
+            slot->record = *record;
+            subghz_history_store_hash_insert(instance, slot_index);
+        } else {
+            slot->record = *record;
+        }
+        slot->record.preset = preset;
+        slot->generation++;
+        if(data) subghz_history_store_copy_data(data, slot->data);
+        result = true;
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    return result;
+}
+
+bool subghz_history_store_get_record(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzHistoryRecord* record) {
+    furi_assert(instance);
+    furi_assert(record);
+
+    bool result = false;
+    bool spilled = false;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    SubGhzHistoryStoreSlot* slot = subghz_history_store_get_slot(instance, idx);
+    uint32_t epoch = instance->epoch;
+    if(slot) {
+        *record = slot->record;
+        result = true;
+    } else if(idx < instance->count) {
+        result = subghz_history_store_cache_get(instance, idx, record);
+        spilled = !result;
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    if(spilled) {
+        SubGhzHistoryStoreLogEntry entry;
+        furi_check(furi_mutex_acquire(instance->io_mutex, FuriWaitForever) == FuriStatusOk);
+        result = subghz_history_store_read_entry(instance, idx, &entry);
+        furi_check(furi_mutex_release(instance->io_mutex) == FuriStatusOk);
+
+        if(result) {
+            *record = entry.record;
+            furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+            if(instance->epoch == epoch) {
+                subghz_history_store_cache_set(instance, idx, record);
+            }
+            furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+        }
+    }
+
+    return result;
+}
+
+bool subghz_history_store_get_data(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    FlipperFormat* data) {
+    furi_assert(instance);
+    furi_assert(data);
+
+    bool result = false;
+    bool spilled = false;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    SubGhzHistoryStoreSlot* slot = subghz_history_store_get_slot(instance, idx);
+    if(slot) {
+        subghz_history_store_copy_data(slot->data, data);
+        result = true;
+    } else {
+        spilled = (idx < instance->count);
+    }
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    if(spilled) {
+        SubGhzHistoryStoreLogEntry entry;
+        Stream* stream = flipper_format_get_raw_stream(data);
+        stream_clean(stream);
+        furi_check(furi_mutex_acquire(instance->io_mutex, FuriWaitForever) == FuriStatusOk);
+        if(subghz_history_store_read_entry(instance, idx, &entry) &&
+           stream_seek(instance->data_stream, entry.data_offset, StreamOffsetFromStart) &&
+           (stream_copy(instance->data_stream, stream, entry.data_size) == entry.data_size)) {
+            result = true;
+        }
+        furi_check(furi_mutex_release(instance->io_mutex) == FuriStatusOk);
+        flipper_format_rewind(data);
+    }
+
+    return result;
+}
+
+bool subghz_history_store_get_preset(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(preset);
+
+    SubGhzHistoryRecord record;
+    if(!subghz_history_store_get_record(instance, idx, &record)) return false;
+
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    SubGhzRadioPreset* item = SubGhzHistoryStorePresetArray_get(instance->presets, record.preset);
+    furi_string_set(preset->name, item->name);
+    preset->frequency = record.frequency;
+    preset->data = item->data;
+    preset->data_size = item->data_size;
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+
+    return true;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUBGHZ_HISTORY_STORE_TEXT_SIZE 32
+
+/** History store: compact records of received keys.
+ * Newest records are kept in RAM together with serialized key data,
+ * older ones are spilled to append-only log on SD-card and read back
+ * on demand. Without SD-card history is limited to RAM records.
+ */
+typedef struct SubGhzHistoryStore SubGhzHistoryStore;
+
+/** Compact history record */
+typedef struct {
+    uint64_t key; /**< key data */
+    uint32_t hash; /**< de-duplication key */
+    uint32_t frequency; /**< frequency Hz */
+    uint32_t timestamp; /**< tick of last reception */
+    uint8_t bits; /**< key length in bits */
+    uint8_t type; /**< SubGhzProtocolType */
+    uint8_t preset; /**< preset index, assigned by store */
+    char text[SUBGHZ_HISTORY_STORE_TEXT_SIZE]; /**< menu text */
+} SubGhzHistoryRecord;
+
+/** Allocate SubGhzHistoryStore
+ *
+ * @param spill_path    - base path of SD-card log, ".idx" and ".dat" files are created
+ * @param ram_records   - amount of newest records kept in RAM, 1..254
+ * @param max_records   - max amount of records when log is available
+ * @return SubGhzHistoryStore*
+ */
+SubGhzHistoryStore*
+    subghz_history_store_alloc(const char* spill_path, uint8_t ram_records, uint16_t max_records);
+
+/** Free SubGhzHistoryStore, log files are removed
+ *
+ * @param instance - SubGhzHistoryStore instance
+ */
+void subghz_history_store_free(SubGhzHistoryStore* instance);
+
+/** Remove all records
+ *
+ * @param instance - SubGhzHistoryStore instance
+ */
+void subghz_history_store_reset(SubGhzHistoryStore* instance);
+
+/** Spill oldest records to SD-card log, so RAM ring has room for new ones.
+ * Call periodically from application thread: add falls back to spilling
+ * from the receiver thread only when the ring is full.
+ *
+ * @param instance - SubGhzHistoryStore instance
+ */
+void subghz_history_store_flush(SubGhzHistoryStore* instance);
+
+/** Get amount of records
+ *
+ * @param instance - SubGhzHistoryStore instance
+ * @return amount of records
+ */
+uint16_t subghz_history_store_get_count(SubGhzHistoryStore* instance);
+
+/** Get max amount of records, depends on SD-card log availability
+ *
+ * @param instance - SubGhzHistoryStore instance
+ * @return max amount of records
+ */
+uint16_t subghz_history_store_get_capacity(SubGhzHistoryStore* instance);
+
+/** Check if older records are spilled to SD-card
+ *
+ * @param instance - SubGhzHistoryStore instance
+ * @return true if SD-card log is used
+ */
+bool subghz_history_store_is_spill_enabled(SubGhzHistoryStore* instance);
+
+/** Find newest record with given hash. Only records kept in RAM are indexed:
+ * key received again after its record was spilled is not found and
+ * is added as a new record.
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param hash      - de-duplication key
+ * @param idx       - found record index
+ * @return true if found
+ */
+bool subghz_history_store_find(SubGhzHistoryStore* instance, uint32_t hash, uint16_t* idx);
+
+/** Add record
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param record    - record to add, preset field is ignored
+ * @param preset    - SubGhzRadioPreset of record
+ * @param data      - serialized key, copied into store
+ * @return true on success, false if store is full
+ */
+bool subghz_history_store_add(
+    SubGhzHistoryStore* instance,
+    const SubGhzHistoryRecord* record,
+    SubGhzRadioPreset* preset,
+    FlipperFormat* data);
+
+/** Update record kept in RAM
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param idx       - record index
+ * @param record    - new record, preset field is ignored
+ * @param data      - new serialized key, NULL to keep current
+ * @return true on success, false if record is already spilled
+ */
+bool subghz_history_store_update(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    const SubGhzHistoryRecord* record,
+    FlipperFormat* data);
+
+/** Get record
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param idx       - record index
+ * @param record    - output record
+ * @return true on success
+ */
+bool subghz_history_store_get_record(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzHistoryRecord* record);
+
+/** Get serialized key of record
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param idx       - record index
+ * @param data      - string FlipperFormat, content is replaced
+ * @return true on success
+ */
+bool subghz_history_store_get_data(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    FlipperFormat* data);
+
+/** Get SubGhzRadioPreset of record
+ *
+ * @param instance  - SubGhzHistoryStore instance
+ * @param idx       - record index
+ * @param preset    - output preset, name must be allocated
+ * @return true on success
+ */
+bool subghz_history_store_get_preset(
+    SubGhzHistoryStore* instance,
+    uint16_t idx,
+    SubGhzRadioPreset* preset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,180 @@
+#include "subghz_hopper.h"
+
+#include <string.h>
+#include <furi.h>
+
+#define TAG "SubGhzHopper"
+
+#define SUBGHZ_HOPPER_RSSI_THRESHOLD (-90.0f)
+#define SUBGHZ_HOPPER_DWELL_TICKS 10
+#define SUBGHZ_HOPPER_WEIGHT_BASE 4
+#define SUBGHZ_HOPPER_WEIGHT_PRIORITY 8
+#define SUBGHZ_HOPPER_ACTIVITY_MAX 255
+
+typedef struct {
+    uint32_t frequency;
+    int32_t credit;
+    uint8_t activity;
+    bool priority;
+    SubGhzHopperStats stats;
+} SubGhzHopperChannel;
+
+struct SubGhzHopper {
+    SubGhzSetting* setting;
+    SubGhzHopperChannel* channels;
+    size_t channel_count;
+    size_t current;
+    SubGhzHopperStats stats;
+};
+
+static inline int32_t subghz_hopper_get_weight(SubGhzHopperChannel* channel) {
+    return SUBGHZ_HOPPER_WEIGHT_BASE + (channel->priority ? SUBGHZ_HOPPER_WEIGHT_PRIORITY : 0) +
+           channel->activity / 16;
+}
+
+static void subghz_hopper_log_stats(SubGhzHopper* instance) {
+    if(!instance->stats.hops) return;
+
+    FURI_LOG_I(
+        TAG,
+        "Hops %lu, dwell %lu, detections %lu, keys %lu",
+        instance->stats.hops,
+        instance->stats.dwell_ticks,
+        instance->stats.detections,
+        instance->stats.keys);
+    for(size_t i = 0; i < instance->channel_count; i++) {
+        SubGhzHopperChannel* channel = &instance->channels[i];
+        FURI_LOG_D(
+            TAG,
+            "%lu%s: visits %lu, dwell %lu, detections %lu, keys %lu, activity %u",
+            channel->frequency,
+            channel->priority ? "*" : "",
+            channel->stats.hops,
+            channel->stats.dwell_ticks,
+            channel->stats.detections,
+            channel->stats.keys,
+            channel->activity);
+    }
+}
+
+SubGhzHopper* subghz_hopper_alloc(SubGhzSetting* setting) {
+    furi_assert(setting);
+    SubGhzHopper* instance = malloc(sizeof(SubGhzHopper));
+    instance->setting = setting;
+    subghz_hopper_reset(instance);
+    return instance;
+}
+
+void subghz_hopper_free(SubGhzHopper* instance) {
+    furi_assert(instance);
+    subghz_hopper_log_stats(instance);
+    free(instance->channels);
+    free(instance);
+}
+
+void subghz_hopper_reset(SubGhzHopper* instance) {
+    furi_assert(instance);
+    subghz_hopper_log_stats(instance);
+
+    size_t count = subghz_setting_get_hopper_frequency_count(instance->setting);
+    if(count != instance->channel_count) {
+        free(instance->channels);
+        instance->channels = malloc(sizeof(SubGhzHopperChannel) * count);
+        instance->channel_count = count;
+    }
+    memset(instance->channels, 0, sizeof(SubGhzHopperChannel) * count);
+    for(size_t i = 0; i < count; i++) {
+        instance->channels[i].frequency =
+            subghz_setting_get_hopper_frequency(instance->setting, i);
+        instance->channels[i].priority =
+            subghz_setting_get_hopper_frequency_priority(instance->setting, i);
+    }
+    memset(&instance->stats, 0, sizeof(SubGhzHopperStats));
+    instance->current = 0;
+}
+
+uint32_t subghz_hopper_next(SubGhzHopper* instance) {
+    furi_assert(instance);
+    furi_check(instance->channel_count);
+
+    // Smooth weighted round robin: every channel gains its weight,
+    // richest one is selected and pays total weight
+    int32_t total = 0;
+    size_t selected = 0;
+    for(size_t i = 0; i < instance->channel_count; i++) {
+        SubGhzHopperChannel* channel = &instance->channels[i];
+        int32_t weight = subghz_hopper_get_weight(channel);
+        channel->credit += weight;
+        total += weight;
+        if(channel->credit > instance->channels[selected].credit) {
+            selected = i;
+        }
+    }
+    instance->channels[selected].credit -= total;
+
+    instance->current = selected;
+    instance->channels[selected].stats.hops++;
+    instance->stats.hops++;
+
+    return instance->channels[selected].frequency;
+}
+
+uint8_t subghz_hopper_rssi(SubGhzHopper* instance, float rssi) {
+    furi_assert(instance);
+    if(!instance->channel_count) return 0;
+    SubGhzHopperChannel* channel = &instance->channels[instance->current];
+
+    if(rssi > SUBGHZ_HOPPER_RSSI_THRESHOLD) {
+        channel->activity += (SUBGHZ_HOPPER_ACTIVITY_MAX - channel->activity) / 4;
+        channel->stats.detections++;
+        instance->stats.detections++;
+        // Busy channels are worth longer listening
+        return SUBGHZ_HOPPER_DWELL_TICKS + channel->activity / 16;
+    }
+
+    channel->activity -= channel->activity / 8;
+    return 0;
+}
+
+void subghz_hopper_dwell_tick(SubGhzHopper* instance) {
+    furi_assert(instance);
+    if(!instance->channel_count) return;
+    instance->channels[instance->current].stats.dwell_ticks++;
+    instance->stats.dwell_ticks++;
+}
+
+void subghz_hopper_key_received(SubGhzHopper* instance) {
+    furi_assert(instance);
+    if(!instance->channel_count) return;
+    SubGhzHopperChannel* channel = &instance->channels[instance->current];
+    channel->activity += (SUBGHZ_HOPPER_ACTIVITY_MAX - channel->activity) / 2;
+    channel->stats.keys++;
+    instance->stats.keys++;
+}
+
+void subghz_hopper_get_stats(SubGhzHopper* instance, SubGhzHopperStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    *stats = instance->stats;
+}
+
+size_t subghz_hopper_get_channel_count(SubGhzHopper* instance) {
+    furi_assert(instance);
+    return instance->channel_count;
+}
+
+bool subghz_hopper_get_channel_stats(
+    SubGhzHopper* instance,
+    size_t idx,
+    SubGhzHopperChannelStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    if(idx >= instance->channel_count) return false;
+
+    SubGhzHopperChannel* channel = &instance->channels[idx];
+    stats->frequency = channel->frequency;
+    stats->priority = channel->priority;
+    stats->activity = channel->activity;
+    stats->stats = channel->stats;
+    return true;
+}
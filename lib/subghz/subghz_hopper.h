@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "subghz_setting.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Adaptive frequency hopper.
+ * Keeps activity score for every hopper frequency and picks next one with
+ * smooth weighted round robin: active and priority frequencies are visited
+ * more often, silent ones are still visited regularly. Dwell time after
+ * RSSI hit grows with frequency activity.
+ */
+typedef struct SubGhzHopper SubGhzHopper;
+
+typedef struct {
+    uint32_t hops; /**< frequency switches */
+    uint32_t dwell_ticks; /**< ticks spent dwelling after RSSI hit */
+    uint32_t detections; /**< RSSI hits */
+    uint32_t keys; /**< decoded keys */
+} SubGhzHopperStats;
+
+typedef struct {
+    uint32_t frequency;
+    bool priority;
+    uint8_t activity; /**< decaying activity score, 0..255 */
+    SubGhzHopperStats stats; /**< hops counts visits of this frequency */
+} SubGhzHopperChannelStats;
+
+/** Allocate SubGhzHopper
+ *
+ * @param setting   SubGhzSetting with hopper frequencies
+ * @return SubGhzHopper*
+ */
+SubGhzHopper* subghz_hopper_alloc(SubGhzSetting* setting);
+
+/** Free SubGhzHopper
+ *
+ * @param instance  SubGhzHopper instance
+ */
+void subghz_hopper_free(SubGhzHopper* instance);
+
+/** Reload frequencies from setting, clear activity and counters
+ *
+ * @param instance  SubGhzHopper instance
+ */
+void subghz_hopper_reset(SubGhzHopper* instance);
+
+/** Select next frequency
+ *
+ * @param instance  SubGhzHopper instance
+ * @return frequency Hz
+ */
+uint32_t subghz_hopper_next(SubGhzHopper* instance);
+
+/** Report RSSI measured on current frequency
+ *
+ * @param instance  SubGhzHopper instance
+ * @param rssi      RSSI dBm
+ * @return amount of ticks to stay on frequency, 0 to move on
+ */
+uint8_t subghz_hopper_rssi(SubGhzHopper* instance, float rssi);
+
+/** Account one tick of dwelling on current frequency
+ *
+ * @param instance  SubGhzHopper instance
+ */
+void subghz_hopper_dwell_tick(SubGhzHopper* instance);
+
+/** Report decoded key on current frequency
+ *
+ * @param instance  SubGhzHopper instance
+ */
+void subghz_hopper_key_received(SubGhzHopper* instance);
+
+/** Get total counters
+ *
+ * @param instance  SubGhzHopper instance
+ * @param stats     output counters
+ */
+void subghz_hopper_get_stats(SubGhzHopper* instance, SubGhzHopperStats* stats);
+
+/** Get amount of hopper frequencies
+ *
+ * @param instance  SubGhzHopper instance
+ * @return amount of frequencies
+ */
+size_t subghz_hopper_get_channel_count(SubGhzHopper* instance);
+
+/** Get statistics of hopper frequency
+ *
+ * @param instance  SubGhzHopper instance
+ * @param idx       frequency index
+ * @param stats     output statistics
+ * @return true if idx is valid
+ */
+bool subghz_hopper_get_channel_stats(
+    SubGhzHopper* instance,
+    size_t idx,
+    SubGhzHopperChannelStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,7 +12,8 @@
 #define SUBGHZ_SETTING_FILE_VERSION 1
 
 #define FREQUENCY_FLAG_DEFAULT (1 << 31)
-#define FREQUENCY_MASK (0xFFFFFFFF ^ FREQUENCY_FLAG_DEFAULT)
+#define FREQUENCY_FLAG_PRIORITY (1 << 30)
+#define FREQUENCY_MASK (0xFFFFFFFF ^ (FREQUENCY_FLAG_DEFAULT | FREQUENCY_FLAG_PRIORITY))
 
 /* Default */
 static const uint32_t subghz_frequency_list[] = {
@@ -382,6 +383,28 @@ void subghz_setting_load(SubGhzSetting* instance, const char* file_path) {
                 }
             }
 
+            // Hopper priority frequencies (optional)
+            if(!flipper_format_rewind(fff_data_file)) {
+                FURI_LOG_E(TAG, "Rewind error");
+                break;
+            }
+            while(flipper_format_read_uint32(
+                fff_data_file, "Hopper_priority", (uint32_t*)&temp_data32, 1)) {
+                bool found = false;
+                for
+                    M_EACH(frequency, instance->hopper_frequencies, FrequencyList_t) {
+                        if((*frequency & FREQUENCY_MASK) == temp_data32) {
+                            *frequency |= FREQUENCY_FLAG_PRIORITY;
+                            found = true;
+                        }
+                    }
+                if(found) {
+                    FURI_LOG_I(TAG, "Hopper priority loaded %lu", temp_data32);
+                } else {
+                    FURI_LOG_E(TAG, "Hopper priority not in hopper list %lu", temp_data32);
+                }
+            }
+
             // Default frequency (optional)
             if(!flipper_format_rewind(fff_data_file)) {
                 FURI_LOG_E(TAG, "Rewind error");
@@ -541,13 +564,22 @@ uint32_t subghz_setting_get_frequency(SubGhzSetting* instance, size_t idx) {
 
 uint32_t subghz_setting_get_hopper_frequency(SubGhzSetting* instance, size_t idx) {
     furi_assert(instance);
-    if(idx < FrequencyList_size(instance->frequencies)) {
-        return *FrequencyList_get(instance->hopper_frequencies, idx);
+    if(idx < FrequencyList_size(instance->hopper_frequencies)) {
+        return (*FrequencyList_get(instance->hopper_frequencies, idx)) & FREQUENCY_MASK;
     } else {
         return 0;
     }
 }
 
+bool subghz_setting_get_hopper_frequency_priority(SubGhzSetting* instance, size_t idx) {
+    furi_assert(instance);
+    if(idx < FrequencyList_size(instance->hopper_frequencies)) {
+        return (*FrequencyList_get(instance->hopper_frequencies, idx)) & FREQUENCY_FLAG_PRIORITY;
+    } else {
+        return false;
+    }
+}
+
 uint32_t subghz_setting_get_frequency_default_index(SubGhzSetting* instance) {
     furi_assert(instance);
     for(size_t i = 0; i < FrequencyList_size(instance->frequencies); i++) {
@@ -0,0 +1,131 @@
+#include "cpu_load.h"
+#include <stdlib.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal_interrupt.h>
+
+#define CPU_LOAD_THREADS_MAX 32
+
+typedef struct {
+    CpuLoadThread threads[CPU_LOAD_THREADS_MAX];
+    size_t thread_count;
+    uint64_t time;
+    uint64_t idle_time;
+    uint64_t isr_time;
+} CpuLoadSnapshot;
+
+struct CpuLoad {
+    CpuLoadSnapshot snapshots[2];
+    CpuLoadSnapshot* current;
+    CpuLoadSnapshot* previous;
+    uint64_t interval;
+    uint64_t idle_delta;
+    uint64_t isr_delta;
+};
+
+CpuLoad* cpu_load_alloc() {
+    CpuLoad* cpu_load = malloc(sizeof(CpuLoad));
+    cpu_load->current = &cpu_load->snapshots[0];
+    cpu_load->previous = &cpu_load->snapshots[1];
+    return cpu_load;
+}
+
+void cpu_load_free(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+    free(cpu_load);
+}
+
+/* Thread id may be reused by new thread, then counter starts over */
+static uint64_t cpu_load_thread_delta(const CpuLoadSnapshot* previous, CpuLoadThread* thread) {
+    for(size_t i = 0; i < previous->thread_count; i++) {
+        if(previous->threads[i].id == thread->id &&
+           previous->threads[i].run_time <= thread->run_time) {
+            return thread->run_time - previous->threads[i].run_time;
+        }
+    }
+    return thread->run_time;
+}
+
+/* Counters are read one by one, so delta may slightly exceed interval */
+static uint64_t cpu_load_delta(uint64_t previous, uint64_t current, const CpuLoad* cpu_load) {
+    if(current < previous) return 0;
+    return MIN(current - previous, cpu_load->interval);
+}
+
+static int cpu_load_thread_cmp(const void* a, const void* b) {
+    const CpuLoadThread* thread_a = a;
+    const CpuLoadThread* thread_b = b;
+
+    if(thread_a->delta != thread_b->delta) {
+        return thread_a->delta > thread_b->delta ? -1 : 1;
+    }
+    return 0;
+}
+
+void cpu_load_update(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+
+    CpuLoadSnapshot* snapshot = cpu_load->previous;
+    cpu_load->previous = cpu_load->current;
+    cpu_load->current = snapshot;
+
+    FuriThreadId ids[CPU_LOAD_THREADS_MAX];
+    size_t count = furi_thread_enumerate(ids, CPU_LOAD_THREADS_MAX);
+    FuriThreadId idle_id = furi_thread_get_idle_id();
+
+    snapshot->time = furi_kernel_get_run_time();
+    snapshot->isr_time = furi_hal_interrupt_get_time_total();
+    // Idle may be missing from enumeration when there are too many threads
+    snapshot->idle_time = idle_id ? furi_thread_get_run_time(idle_id) : 0;
+    snapshot->thread_count = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(ids[i] == idle_id) continue;
+
+        uint64_t run_time = furi_thread_get_run_time(ids[i]);
+        CpuLoadThread* thread = &snapshot->threads[snapshot->thread_count++];
+        thread->id = ids[i];
+        thread->run_time = run_time;
+        const char* name = furi_thread_get_name(ids[i]);
+        strlcpy(thread->name, name ? name : "", CPU_LOAD_THREAD_NAME_SIZE);
+        thread->delta = cpu_load_thread_delta(cpu_load->previous, thread);
+    }
+
+    qsort(snapshot->threads, snapshot->thread_count, sizeof(CpuLoadThread), cpu_load_thread_cmp);
+
+    const CpuLoadSnapshot* previous = cpu_load->previous;
+    cpu_load->interval = snapshot->time - previous->time;
+    cpu_load->idle_delta = cpu_load_delta(previous->idle_time, snapshot->idle_time, cpu_load);
+    cpu_load->isr_delta = cpu_load_delta(previous->isr_time, snapshot->isr_time, cpu_load);
+}
+
+uint64_t cpu_load_get_interval(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+    return cpu_load->interval;
+}
+
+uint64_t cpu_load_get_idle_time(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+    return cpu_load->idle_delta;
+}
+
+uint64_t cpu_load_get_isr_time(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+    return cpu_load->isr_delta;
+}
+
+size_t cpu_load_get_thread_count(CpuLoad* cpu_load) {
+    furi_assert(cpu_load);
+    return cpu_load->current->thread_count;
+}
+
+const CpuLoadThread* cpu_load_get_thread(CpuLoad* cpu_load, size_t index) {
+    furi_assert(cpu_load);
+    furi_check(index < cpu_load->current->thread_count);
+    return &cpu_load->current->threads[index];
+}
+
+float cpu_load_get_percent(CpuLoad* cpu_load, uint64_t time) {
+    furi_assert(cpu_load);
+    if(!cpu_load->interval) return 0.0f;
+    return (float)time * 100.0f / (float)cpu_load->interval;
+}
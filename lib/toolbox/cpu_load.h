@@ -0,0 +1,92 @@
+/**
+ * @file cpu_load.h
+ * Per thread CPU load over interval between updates
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <core/thread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CPU_LOAD_THREAD_NAME_SIZE 16
+
+typedef struct CpuLoad CpuLoad;
+
+typedef struct {
+    FuriThreadId id;
+    char name[CPU_LOAD_THREAD_NAME_SIZE];
+    uint64_t run_time; /**< total run time, microseconds */
+    uint64_t delta; /**< run time since previous update, microseconds */
+} CpuLoadThread;
+
+CpuLoad* cpu_load_alloc();
+
+void cpu_load_free(CpuLoad* cpu_load);
+
+/** Take new snapshot and calculate deltas against previous one
+ *
+ * First update after alloc covers whole uptime.
+ * Thread time includes interrupts that preempted it.
+ *
+ * @param      cpu_load  CpuLoad instance
+ */
+void cpu_load_update(CpuLoad* cpu_load);
+
+/** Get interval between last two updates
+ *
+ * @param      cpu_load  CpuLoad instance
+ *
+ * @return     interval in microseconds
+ */
+uint64_t cpu_load_get_interval(CpuLoad* cpu_load);
+
+/** Get idle thread run time over last interval
+ *
+ * @param      cpu_load  CpuLoad instance
+ *
+ * @return     time in microseconds
+ */
+uint64_t cpu_load_get_idle_time(CpuLoad* cpu_load);
+
+/** Get time spent in interrupts over last interval
+ *
+ * @param      cpu_load  CpuLoad instance
+ *
+ * @return     time in microseconds
+ */
+uint64_t cpu_load_get_isr_time(CpuLoad* cpu_load);
+
+/** Get number of threads in last snapshot, idle thread excluded
+ *
+ * @param      cpu_load  CpuLoad instance
+ *
+ * @return     thread count
+ */
+size_t cpu_load_get_thread_count(CpuLoad* cpu_load);
+
+/** Get thread from last snapshot, threads are sorted by delta, busiest first
+ *
+ * @param      cpu_load  CpuLoad instance
+ * @param      index     thread index
+ *
+ * @return     thread, valid until next update
+ */
+const CpuLoadThread* cpu_load_get_thread(CpuLoad* cpu_load, size_t index);
+
+/** Get load percentage
+ *
+ * @param      cpu_load  CpuLoad instance
+ * @param      time      time over last interval, microseconds
+ *
+ * @return     percent of last interval
+ */
+float cpu_load_get_percent(CpuLoad* cpu_load, uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,7 +3,13 @@
 
 LIST_DEF(DirIndexList, uint32_t);
 
+/* Directories up to this depth stay open while their children are walked,
+ * deeper ones share last handle and are rewound by rescan on step out */
+#define DIR_WALK_MAX_OPEN_DIRS 4
+
 struct DirWalk {
+    Storage* storage;
+    File* files[DIR_WALK_MAX_OPEN_DIRS];
     File* file;
     FuriString* path;
     DirIndexList_t index_list;
@@ -15,8 +21,10 @@ struct DirWalk {
 
 DirWalk* dir_walk_alloc(Storage* storage) {
     DirWalk* dir_walk = malloc(sizeof(DirWalk));
+    dir_walk->storage = storage;
     dir_walk->path = furi_string_alloc();
-    dir_walk->file = storage_file_alloc(storage);
+    dir_walk->files[0] = storage_file_alloc(storage);
+    dir_walk->file = dir_walk->files[0];
     DirIndexList_init(dir_walk->index_list);
     dir_walk->recursive = true;
     dir_walk->filter_cb = NULL;
@@ -24,7 +32,11 @@ DirWalk* dir_walk_alloc(Storage* storage) {
 }
 
 void dir_walk_free(DirWalk* dir_walk) {
-    storage_file_free(dir_walk->file);
+    for(size_t i = 0; i < DIR_WALK_MAX_OPEN_DIRS; i++) {
+        if(dir_walk->files[i]) {
+            storage_file_free(dir_walk->files[i]);
+        }
+    }
     furi_string_free(dir_walk->path);
     DirIndexList_clear(dir_walk->index_list);
     free(dir_walk);
@@ -42,6 +54,7 @@ void dir_walk_set_filter_cb(DirWalk* dir_walk, DirWalkFilterCb cb, void* context
 bool dir_walk_open(DirWalk* dir_walk, const char* path) {
     furi_string_set(dir_walk->path, path);
     dir_walk->current_index = 0;
+    dir_walk->file = dir_walk->files[0];
     return storage_dir_open(dir_walk->file, path);
 }
 
@@ -87,7 +100,17 @@ static DirWalkResult
                 // step into
                 DirIndexList_push_back(dir_walk->index_list, dir_walk->current_index);
                 dir_walk->current_index = 0;
-                storage_dir_close(dir_walk->file);
+
+                size_t depth = DirIndexList_size(dir_walk->index_list);
+                if(depth < DIR_WALK_MAX_OPEN_DIRS) {
+                    // keep parent open, it will be continued from the same position
+                    if(!dir_walk->files[depth]) {
+                        dir_walk->files[depth] = storage_file_alloc(dir_walk->storage);
+                    }
+                    dir_walk->file = dir_walk->files[depth];
+                } else {
+                    storage_dir_close(dir_walk->file);
+                }
 
                 furi_string_cat_printf(dir_walk->path, "/%s", name);
                 storage_dir_open(dir_walk->file, furi_string_get_cstr(dir_walk->path));
@@ -110,6 +133,15 @@ static DirWalkResult
                     furi_string_left(dir_walk->path, last_char);
                 }
 
+                size_t depth = DirIndexList_size(dir_walk->index_list);
+                if(depth < DIR_WALK_MAX_OPEN_DIRS - 1) {
+                    // parent is still open at the right position
+                    dir_walk->file = dir_walk->files[depth];
+                    dir_walk->current_index = index;
+                    result = DirWalkOK;
+                    continue;
+                }
+
                 storage_dir_open(dir_walk->file, furi_string_get_cstr(dir_walk->path));
 
                 // rewind
@@ -147,9 +179,12 @@ DirWalkResult dir_walk_read(DirWalk* dir_walk, FuriString* return_path, FileInfo
 }
 
 void dir_walk_close(DirWalk* dir_walk) {
-    if(storage_file_is_open(dir_walk->file)) {
-        storage_dir_close(dir_walk->file);
+    for(size_t i = 0; i < DIR_WALK_MAX_OPEN_DIRS; i++) {
+        if(dir_walk->files[i] && storage_file_is_open(dir_walk->files[i])) {
+            storage_dir_close(dir_walk->files[i]);
+        }
     }
+    dir_walk->file = dir_walk->files[0];
 
     DirIndexList_reset(dir_walk->index_list);
     furi_string_reset(dir_walk->path);
@@ -0,0 +1,208 @@
+#include "hash.h"
+#include "md5.h"
+#include "sha1.h"
+#include "sha256.h"
+#include "crc32_calc.h"
+
+#include <furi.h>
+#include <furi_hal_crc.h>
+
+#define HASH_FILE_BUFFER_MAX_LEN 4096
+#define HASH_FILE_BUFFER_MIN_LEN 512
+
+/* Below this size locking CRC unit costs more than table lookup */
+#define HASH_CRC32_HW_MIN_LEN 64
+
+struct Hash {
+    HashType type;
+    union {
+        md5_context md5;
+        sha1_context sha1;
+        sha256_context sha256;
+        uint32_t crc32;
+    };
+};
+
+typedef struct {
+    const char* name;
+    size_t digest_size;
+} HashTypeInfo;
+
+static const HashTypeInfo hash_type_info[HashTypeCount] = {
+    [HashTypeMd5] = {.name = "md5", .digest_size = 16},
+    [HashTypeSha1] = {.name = "sha1", .digest_size = SHA1_DIGEST_SIZE},
+    [HashTypeSha256] = {.name = "sha256", .digest_size = SHA256_DIGEST_SIZE},
+    [HashTypeCrc32] = {.name = "crc32", .digest_size = sizeof(uint32_t)},
+};
+
+Hash* hash_alloc(HashType type) {
+    furi_check(type < HashTypeCount);
+    Hash* hash = malloc(sizeof(Hash));
+    hash->type = type;
+    hash_reset(hash);
+    return hash;
+}
+
+void hash_free(Hash* hash) {
+    furi_assert(hash);
+    free(hash);
+}
+
+HashType hash_get_type(const Hash* hash) {
+    furi_assert(hash);
+    return hash->type;
+}
+
+void hash_reset(Hash* hash) {
+    furi_assert(hash);
+
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_starts(&hash->md5);
+        break;
+    case HashTypeSha1:
+        sha1_start(&hash->sha1);
+        break;
+    case HashTypeSha256:
+        sha256_start(&hash->sha256);
+        break;
+    case HashTypeCrc32:
+        hash->crc32 = 0;
+        break;
+    default:
+        furi_crash(NULL);
+    }
+}
+
+void hash_update(Hash* hash, const void* data, size_t size) {
+    furi_assert(hash);
+    furi_assert(data || !size);
+
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_update(&hash->md5, data, size);
+        break;
+    case HashTypeSha1:
+        sha1_update(&hash->sha1, data, size);
+        break;
+    case HashTypeSha256:
+        sha256_update(&hash->sha256, data, size);
+        break;
+    case HashTypeCrc32:
+        if(size >= HASH_CRC32_HW_MIN_LEN && !FURI_IS_ISR()) {
+            hash->crc32 = furi_hal_crc32(hash->crc32, data, size);
+        } else {
+            hash->crc32 = crc32_calc_buffer(hash->crc32, data, size);
+        }
+        break;
+    default:
+        furi_crash(NULL);
+    }
+}
+
+bool hash_update_file(
+    Hash* hash,
+    File* file,
+    HashFileProgressCallback progress_cb,
+    void* context) {
+    furi_assert(hash);
+    furi_assert(file);
+
+    size_t buffer_len = HASH_FILE_BUFFER_MAX_LEN;
+    if(memmgr_heap_get_max_free_block() < HASH_FILE_BUFFER_MAX_LEN * 2) {
+        buffer_len = HASH_FILE_BUFFER_MIN_LEN;
+    }
+    uint8_t* buffer = malloc(buffer_len);
+
+    uint64_t size = storage_file_size(file);
+    uint64_t position = storage_file_tell(file);
+    uint8_t last_progress = 0;
+    bool result = true;
+
+    while(position < size) {
+        size_t read_size = storage_file_read(file, buffer, buffer_len);
+        if(storage_file_get_error(file) != FSE_OK) {
+            result = false;
+            break;
+        }
+        if(read_size == 0) break;
+
+        hash_update(hash, buffer, read_size);
+        position += read_size;
+
+        if(progress_cb) {
+            uint8_t progress = position * 100 / size;
+            if(progress != last_progress) {
+                last_progress = progress;
+                progress_cb(progress, context);
+            }
+        }
+    }
+
+    free(buffer);
+    return result;
+}
+
+size_t hash_finish(Hash* hash, uint8_t* digest) {
+    furi_assert(hash);
+    furi_assert(digest);
+
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_finish(&hash->md5, digest);
+        break;
+    case HashTypeSha1:
+        sha1_finish(&hash->sha1, digest);
+        break;
+    case HashTypeSha256:
+        sha256_finish(&hash->sha256, digest);
+        break;
+    case HashTypeCrc32:
+        digest[0] = hash->crc32 >> 24;
+        digest[1] = hash->crc32 >> 16;
+        digest[2] = hash->crc32 >> 8;
+        digest[3] = hash->crc32;
+        break;
+    default:
+        furi_crash(NULL);
+    }
+
+    hash_reset(hash);
+    return hash_type_info[hash->type].digest_size;
+}
+
+void hash_finish_hex(Hash* hash, FuriString* output) {
+    furi_assert(output);
+
+    uint8_t digest[HASH_DIGEST_SIZE_MAX];
+    size_t digest_size = hash_finish(hash, digest);
+
+    furi_string_reset(output);
+    for(size_t i = 0; i < digest_size; i++) {
+        furi_string_cat_printf(output, "%02x", digest[i]);
+    }
+}
+
+size_t hash_type_get_digest_size(HashType type) {
+    furi_check(type < HashTypeCount);
+    return hash_type_info[type].digest_size;
+}
+
+const char* hash_type_get_name(HashType type) {
+    furi_check(type < HashTypeCount);
+    return hash_type_info[type].name;
+}
+
+bool hash_type_from_name(const char* name, HashType* type) {
+    furi_assert(name);
+    furi_assert(type);
+
+    for(size_t i = 0; i < HashTypeCount; i++) {
+        if(strcmp(name, hash_type_info[i].name) == 0) {
+            *type = i;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file hash.h
+ * Streaming message digest interface
+ *
+ * One API for all hashes used in firmware. CRC32 goes through the MCU CRC
+ * unit when called from a thread, other hashes are software only.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HashTypeMd5,
+    HashTypeSha1,
+    HashTypeSha256,
+    HashTypeCrc32,
+
+    HashTypeCount,
+} HashType;
+
+/** Biggest digest size of all hash types */
+#define HASH_DIGEST_SIZE_MAX 32
+
+typedef struct Hash Hash;
+
+typedef void (*HashFileProgressCallback)(uint8_t progress, void* context);
+
+/** Allocate hash context and start digest
+ *
+ * @param      type  hash type
+ *
+ * @return     Hash instance
+ */
+Hash* hash_alloc(HashType type);
+
+/** Free hash context
+ *
+ * @param      hash  Hash instance
+ */
+void hash_free(Hash* hash);
+
+/** Get hash type
+ *
+ * @param      hash  Hash instance
+ *
+ * @return     hash type
+ */
+HashType hash_get_type(const Hash* hash);
+
+/** Drop everything fed so far and start new digest
+ *
+ * @param      hash  Hash instance
+ */
+void hash_reset(Hash* hash);
+
+/** Feed data
+ *
+ * @param      hash  Hash instance
+ * @param      data  data pointer, any alignment
+ * @param      size  data size
+ */
+void hash_update(Hash* hash, const void* data, size_t size);
+
+/** Feed file contents from current position to the end
+ *
+ * Reads are done in big blocks to keep storage round trips low.
+ *
+ * @param      hash         Hash instance
+ * @param      file         opened file
+ * @param      progress_cb  optional progress callback, 0-100
+ * @param      context      callback context
+ *
+ * @return     true if whole file was read
+ */
+bool hash_update_file(
+    Hash* hash,
+    File* file,
+    HashFileProgressCallback progress_cb,
+    void* context);
+
+/** Finish digest and start new one
+ *
+ * CRC32 digest is big endian, as it is usually printed.
+ *
+ * @param      hash    Hash instance
+ * @param      digest  output, at least hash_type_get_digest_size() bytes
+ *
+ * @return     digest size
+ */
+size_t hash_finish(Hash* hash, uint8_t* digest);
+
+/** Finish digest as lowercase hex string and start new one
+ *
+ * @param      hash    Hash instance
+ * @param      output  output string
+ */
+void hash_finish_hex(Hash* hash, FuriString* output);
+
+/** Get digest size
+ *
+ * @param      type  hash type
+ *
+ * @return     digest size in bytes
+ */
+size_t hash_type_get_digest_size(HashType type);
+
+/** Get hash name
+ *
+ * @param      type  hash type
+ *
+ * @return     name, as in hash_type_from_name()
+ */
+const char* hash_type_get_name(HashType type);
+
+/** Get hash type by name
+ *
+ * @param      name  "md5", "sha1", "sha256" or "crc32"
+ * @param      type  output hash type
+ *
+ * @return     true if name is known
+ */
+bool hash_type_from_name(const char* name, HashType* type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -98,6 +98,12 @@ void md5_starts(md5_context* ctx) {
 void md5_process(md5_context* ctx, const unsigned char data[64]) {
     uint32_t X[16], A, B, C, D;
 
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    /* Word loads instead of assembling bytes, Cortex-M4 handles unaligned access */
+    for(size_t i = 0; i < 16; i++) {
+        memcpy(&X[i], data + i * 4, sizeof(uint32_t));
+    }
+#else
     GET_UINT32_LE(X[0], data, 0);
     GET_UINT32_LE(X[1], data, 4);
     GET_UINT32_LE(X[2], data, 8);
@@ -114,6 +120,7 @@ void md5_process(md5_context* ctx, const unsigned char data[64]) {
     GET_UINT32_LE(X[13], data, 52);
     GET_UINT32_LE(X[14], data, 56);
     GET_UINT32_LE(X[15], data, 60);
+#endif
 
 #define S(x, n) (((x) << (n)) | (((x)&0xFFFFFFFF) >> (32 - (n))))
 
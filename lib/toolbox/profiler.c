@@ -2,12 +2,16 @@
 #include <stdlib.h>
 #include <m-dict.h>
 #include <furi.h>
-#include <furi_hal_gpio.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_sampler.h>
 
 typedef struct {
     uint32_t start;
     uint32_t length;
     uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    bool active;
 } ProfilerRecord;
 
 DICT_DEF2(ProfilerRecordDict, const char*, M_CSTR_OPLIST, ProfilerRecord, M_POD_OPLIST)
@@ -33,6 +37,9 @@ void profiler_prealloc(Profiler* profiler, const char* key) {
         .start = 0,
         .length = 0,
         .count = 0,
+        .min = UINT32_MAX,
+        .max = 0,
+        .active = false,
     };
 
     ProfilerRecordDict_set_at(profiler->records, key, record);
@@ -45,20 +52,28 @@ void profiler_start(Profiler* profiler, const char* key) {
         record = ProfilerRecordDict_get(profiler->records, key);
     }
 
-    furi_check(record->start == 0);
+    furi_check(!record->active);
+    record->active = true;
     record->start = DWT->CYCCNT;
 }
 
 void profiler_stop(Profiler* profiler, const char* key) {
     ProfilerRecord* record = ProfilerRecordDict_get(profiler->records, key);
+    uint32_t length = DWT->CYCCNT;
     furi_check(record != NULL);
+    furi_check(record->active);
 
-    record->length += DWT->CYCCNT - record->start;
-    record->start = 0;
+    length -= record->start;
+    record->length += length;
+    record->min = MIN(record->min, length);
+    record->max = MAX(record->max, length);
+    record->active = false;
     record->count++;
 }
 
 void profiler_dump(Profiler* profiler) {
+    const double clocks_per_us = furi_hal_cortex_instructions_per_microsecond();
+
     printf("Profiler:\r\n");
 
     ProfilerRecordDict_it_t it;
@@ -69,9 +84,9 @@ void profiler_dump(Profiler* profiler) {
         uint32_t count = itref->value.count;
 
         uint32_t clocks = itref->value.length;
-        double us = (double)clocks / (double)64.0;
-        double ms = (double)clocks / (double)64000.0;
-        double s = (double)clocks / (double)64000000.0;
+        double us = (double)clocks / clocks_per_us;
+        double ms = us / (double)1000.0;
+        double s = us / (double)1000000.0;
 
         printf("\t%s[%lu]: %f s, %f ms, %f us, %lu clk\r\n", itref->key, count, s, ms, us, clocks);
 
@@ -82,6 +97,86 @@ void profiler_dump(Profiler* profiler) {
             clocks /= count;
 
             printf("\t%s[1]: %f s, %f ms, %f us, %lu clk\r\n", itref->key, s, ms, us, clocks);
+            printf(
+                "\t%s min/max: %f/%f us\r\n",
+                itref->key,
+                (double)itref->value.min / clocks_per_us,
+                (double)itref->value.max / clocks_per_us);
         }
     }
 }
+
+ProfilerScope profiler_scope_enter(Profiler* profiler, const char* key) {
+    profiler_start(profiler, key);
+    return (ProfilerScope){.profiler = profiler, .key = key};
+}
+
+void profiler_scope_exit(ProfilerScope* scope) {
+    profiler_stop(scope->profiler, scope->key);
+}
+
+typedef struct {
+    ProfilerSample* samples;
+    size_t size;
+    volatile size_t count;
+    volatile size_t dropped;
+} ProfilerSampling;
+
+static ProfilerSampling profiler_sampling = {0};
+
+static void profiler_sampling_callback(uint32_t pc, void* context) {
+    ProfilerSampling* sampling = context;
+
+    if(sampling->count < sampling->size) {
+        ProfilerSample* sample = &sampling->samples[sampling->count];
+        sample->pc = pc;
+        sample->thread = furi_thread_get_current_id();
+        sampling->count++;
+    } else {
+        sampling->dropped++;
+    }
+}
+
+void profiler_sampling_start(uint32_t frequency, size_t sample_count) {
+    furi_check(!furi_hal_sampler_is_running());
+    furi_check(sample_count);
+
+    if(profiler_sampling.size != sample_count) {
+        profiler_sampling_free();
+        profiler_sampling.samples = malloc(sample_count * sizeof(ProfilerSample));
+        profiler_sampling.size = sample_count;
+    }
+
+    profiler_sampling.count = 0;
+    profiler_sampling.dropped = 0;
+
+    furi_hal_sampler_start(frequency, profiler_sampling_callback, &profiler_sampling);
+}
+
+void profiler_sampling_stop() {
+    furi_hal_sampler_stop();
+}
+
+bool profiler_sampling_is_running() {
+    return furi_hal_sampler_is_running();
+}
+
+ProfilerSample* profiler_sampling_get_samples(size_t* count, size_t* dropped) {
+    furi_check(!furi_hal_sampler_is_running());
+    furi_assert(count);
+
+    *count = profiler_sampling.count;
+    if(dropped) *dropped = profiler_sampling.dropped;
+
+    return profiler_sampling.count ? profiler_sampling.samples : NULL;
+}
+
+void profiler_sampling_free() {
+    furi_check(!furi_hal_sampler_is_running());
+
+    free(profiler_sampling.samples);
+    profiler_sampling.samples = NULL;
+    profiler_sampling.size = 0;
+    profiler_sampling.count = 0;
+    profiler_sampling.dropped = 0;
+}
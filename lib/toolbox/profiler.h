@@ -1,5 +1,10 @@
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <core/thread.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -18,6 +23,69 @@ void profiler_stop(Profiler* profiler, const char* key);
 
 void profiler_dump(Profiler* profiler);
 
+typedef struct {
+    Profiler* profiler;
+    const char* key;
+} ProfilerScope;
+
+ProfilerScope profiler_scope_enter(Profiler* profiler, const char* key);
+
+void profiler_scope_exit(ProfilerScope* scope);
+
+#define PROFILER_SCOPE_NAME_(line) profiler_scope_##line
+#define PROFILER_SCOPE_NAME(line) PROFILER_SCOPE_NAME_(line)
+
+/** Measure time from this point to the end of enclosing block
+ *
+ * @param      profiler  Profiler instance
+ * @param      key       record name
+ */
+#define PROFILER_SCOPE(profiler, key)                                                          \
+    ProfilerScope PROFILER_SCOPE_NAME(__LINE__) __attribute__((cleanup(profiler_scope_exit))) = \
+        profiler_scope_enter(profiler, key)
+
+/** Program counter sample */
+typedef struct {
+    uint32_t pc; /**< program counter, 0 if interrupt handler was running */
+    FuriThreadId thread; /**< thread that was running */
+} ProfilerSample;
+
+/** Start sampling running code
+ *
+ * Samples are collected until buffer is full or sampling is stopped.
+ * Samples due inside critical sections are delayed to their exit, see
+ * furi_hal_sampler_start.
+ * Previously collected samples are discarded.
+ *
+ * @param      frequency     sample rate, 10 to 10000 Hz
+ * @param      sample_count  buffer size, in samples
+ */
+void profiler_sampling_start(uint32_t frequency, size_t sample_count);
+
+/** Stop sampling */
+void profiler_sampling_stop();
+
+/** Check if sampling is running
+ *
+ * @return     true if running
+ */
+bool profiler_sampling_is_running();
+
+/** Get collected samples, sampling must be stopped
+ *
+ * Buffer stays valid until next start or profiler_sampling_free() and can
+ * be reordered by caller.
+ *
+ * @param[out] count    collected sample count
+ * @param[out] dropped  samples dropped because buffer was full, can be NULL
+ *
+ * @return     samples buffer, NULL if nothing was collected
+ */
+ProfilerSample* profiler_sampling_get_samples(size_t* count, size_t* dropped);
+
+/** Free samples buffer, sampling must be stopped */
+void profiler_sampling_free();
+
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,164 @@
+/*
+ * sha1.c -- Compute SHA-1 hash (FIPS 180-4)
+ *
+ * API follows sha256.c. Message words are loaded as whole (possibly
+ * unaligned) words and byte swapped, message schedule is kept in a
+ * rolling 16 word window.
+ */
+
+#include <string.h>
+#include "sha1.h"
+
+#define SHA1_MASK (SHA1_BLOCK_SIZE - 1)
+
+#define rotl32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define ch(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define parity(x, y, z) ((x) ^ (y) ^ (z))
+#define maj(x, y, z) (((x) & (y)) | ((z) & ((x) ^ (y))))
+
+/* w[i & 15] for i >= 16 */
+#define w_next(i)                                                                 \
+    (w[(i)&15] = rotl32(                                                          \
+         w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i)&15], \
+         1))
+
+#define sha1_round(a, b, c, d, e, f, k, x)           \
+    {                                               \
+        e += rotl32(a, 5) + f(b, c, d) + (k) + (x); \
+        b = rotl32(b, 30);                          \
+    }
+
+void sha1_process(sha1_context* ctx, const unsigned char data[64]) {
+    uint32_t w[16];
+    uint32_t a, b, c, d, e;
+    uint32_t i;
+
+    for(i = 0; i < 16; i++) {
+        /* Compiles to single load, Cortex-M4 handles unaligned access */
+        memcpy(&w[i], data + i * 4, sizeof(uint32_t));
+        w[i] = __builtin_bswap32(w[i]);
+    }
+
+    a = ctx->state[0];
+    b = ctx->state[1];
+    c = ctx->state[2];
+    d = ctx->state[3];
+    e = ctx->state[4];
+
+    /* Five rounds per step rotate variables back to their places */
+    for(i = 0; i < 15; i += 5) {
+        sha1_round(a, b, c, d, e, ch, 0x5A827999, w[i]);
+        sha1_round(e, a, b, c, d, ch, 0x5A827999, w[i + 1]);
+        sha1_round(d, e, a, b, c, ch, 0x5A827999, w[i + 2]);
+        sha1_round(c, d, e, a, b, ch, 0x5A827999, w[i + 3]);
+        sha1_round(b, c, d, e, a, ch, 0x5A827999, w[i + 4]);
+    }
+    sha1_round(a, b, c, d, e, ch, 0x5A827999, w[15]);
+    sha1_round(e, a, b, c, d, ch, 0x5A827999, w_next(16));
+    sha1_round(d, e, a, b, c, ch, 0x5A827999, w_next(17));
+    sha1_round(c, d, e, a, b, ch, 0x5A827999, w_next(18));
+    sha1_round(b, c, d, e, a, ch, 0x5A827999, w_next(19));
+
+    for(i = 20; i < 40; i += 5) {
+        sha1_round(a, b, c, d, e, parity, 0x6ED9EBA1, w_next(i));
+        sha1_round(e, a, b, c, d, parity, 0x6ED9EBA1, w_next(i + 1));
+        sha1_round(d, e, a, b, c, parity, 0x6ED9EBA1, w_next(i + 2));
+        sha1_round(c, d, e, a, b, parity, 0x6ED9EBA1, w_next(i + 3));
+        sha1_round(b, c, d, e, a, parity, 0x6ED9EBA1, w_next(i + 4));
+    }
+
+    for(i = 40; i < 60; i += 5) {
+        sha1_round(a, b, c, d, e, maj, 0x8F1BBCDC, w_next(i));
+        sha1_round(e, a, b, c, d, maj, 0x8F1BBCDC, w_next(i + 1));
+        sha1_round(d, e, a, b, c, maj, 0x8F1BBCDC, w_next(i + 2));
+        sha1_round(c, d, e, a, b, maj, 0x8F1BBCDC, w_next(i + 3));
+        sha1_round(b, c, d, e, a, maj, 0x8F1BBCDC, w_next(i + 4));
+    }
+
+    for(i = 60; i < 80; i += 5) {
+        sha1_round(a, b, c, d, e, parity, 0xCA62C1D6, w_next(i));
+        sha1_round(e, a, b, c, d, parity, 0xCA62C1D6, w_next(i + 1));
+        sha1_round(d, e, a, b, c, parity, 0xCA62C1D6, w_next(i + 2));
+        sha1_round(c, d, e, a, b, parity, 0xCA62C1D6, w_next(i + 3));
+        sha1_round(b, c, d, e, a, parity, 0xCA62C1D6, w_next(i + 4));
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+}
+
+void sha1_start(sha1_context* ctx) {
+    ctx->total[0] = 0;
+    ctx->total[1] = 0;
+
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xEFCDAB89;
+    ctx->state[2] = 0x98BADCFE;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xC3D2E1F0;
+}
+
+void sha1_update(sha1_context* ctx, const unsigned char* input, size_t ilen) {
+    uint32_t left = ctx->total[0] & SHA1_MASK;
+    uint32_t fill = SHA1_BLOCK_SIZE - left;
+
+    ctx->total[0] += (uint32_t)ilen;
+    if(ctx->total[0] < (uint32_t)ilen) ctx->total[1]++;
+
+    if(left && ilen >= fill) {
+        memcpy(ctx->buffer + left, input, fill);
+        sha1_process(ctx, ctx->buffer);
+        input += fill;
+        ilen -= fill;
+        left = 0;
+    }
+
+    /* Full blocks are hashed straight from input */
+    while(ilen >= SHA1_BLOCK_SIZE) {
+        sha1_process(ctx, input);
+        input += SHA1_BLOCK_SIZE;
+        ilen -= SHA1_BLOCK_SIZE;
+    }
+
+    if(ilen > 0) {
+        memcpy(ctx->buffer + left, input, ilen);
+    }
+}
+
+void sha1_finish(sha1_context* ctx, unsigned char output[20]) {
+    uint32_t last = ctx->total[0] & SHA1_MASK;
+    uint32_t high = (ctx->total[0] >> 29) | (ctx->total[1] << 3);
+    uint32_t low = ctx->total[0] << 3;
+
+    ctx->buffer[last++] = 0x80;
+    if(last > SHA1_BLOCK_SIZE - 8) {
+        memset(ctx->buffer + last, 0, SHA1_BLOCK_SIZE - last);
+        sha1_process(ctx, ctx->buffer);
+        last = 0;
+    }
+    memset(ctx->buffer + last, 0, SHA1_BLOCK_SIZE - 8 - last);
+
+    high = __builtin_bswap32(high);
+    low = __builtin_bswap32(low);
+    memcpy(ctx->buffer + SHA1_BLOCK_SIZE - 8, &high, sizeof(uint32_t));
+    memcpy(ctx->buffer + SHA1_BLOCK_SIZE - 4, &low, sizeof(uint32_t));
+    sha1_process(ctx, ctx->buffer);
+
+    for(uint32_t i = 0; i < 5; i++) {
+        uint32_t word = __builtin_bswap32(ctx->state[i]);
+        memcpy(output + i * 4, &word, sizeof(uint32_t));
+    }
+    memset(ctx, 0, sizeof(sha1_context));
+}
+
+void sha1(const unsigned char* input, size_t ilen, unsigned char output[20]) {
+    sha1_context ctx;
+
+    sha1_start(&ctx);
+    sha1_update(&ctx, input, ilen);
+    sha1_finish(&ctx, output);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA1_DIGEST_SIZE 20
+#define SHA1_BLOCK_SIZE 64
+
+typedef struct {
+    uint32_t total[2];
+    uint32_t state[5];
+    uint8_t buffer[SHA1_BLOCK_SIZE];
+} sha1_context;
+
+void sha1(const unsigned char* input, size_t ilen, unsigned char output[20]);
+void sha1_start(sha1_context* ctx);
+void sha1_update(sha1_context* ctx, const unsigned char* input, size_t ilen);
+void sha1_finish(sha1_context* ctx, unsigned char output[20]);
+void sha1_process(sha1_context* ctx, const unsigned char data[64]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,19 +4,42 @@
 #include <storage/storage.h>
 #include <furi.h>
 #include <toolbox/path.h>
+#include <lib/heatshrink/heatshrink_decoder.h>
 
 #define TAG "TarArch"
 #define MAX_NAME_LEN 255
 #define FILE_BLOCK_SIZE 512
 
+#define TAR_RECORD_SIZE 512
+#define TAR_STREAM_BUFFER_SIZE (16 * TAR_RECORD_SIZE)
+#define TAR_HEATSHRINK_INPUT_SIZE 512
+#define TAR_HEATSHRINK_WINDOW_SZ2_MAX 12
+
+#define TAR_HEATSHRINK_MAGIC 0x53445348 // "HSDS"
+#define TAR_HEATSHRINK_VERSION 1
+
 #define FILE_OPEN_NTRIES 10
 #define FILE_OPEN_RETRY_DELAY 25
 
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t window_sz2;
+    uint8_t lookahead_sz2;
+    uint8_t reserved;
+} TarHeatshrinkHeader;
+
 typedef struct TarArchive {
     Storage* storage;
+    File* stream;
     mtar_t tar;
     tar_unpack_file_cb unpack_cb;
     void* unpack_cb_context;
+
+    bool compressed;
+    TarHeatshrinkHeader compress_header;
+    uint32_t processed_bytes;
+    uint32_t total_bytes;
 } TarArchive;
 
 /* API WRAPPER */
@@ -84,6 +107,20 @@ bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode) {
         storage_file_free(stream);
         return false;
     }
+
+    archive->compressed = false;
+    if(mode == TAR_OPEN_MODE_READ) {
+        TarHeatshrinkHeader* header = &archive->compress_header;
+        archive->compressed =
+            storage_file_read(stream, header, sizeof(TarHeatshrinkHeader)) ==
+                sizeof(TarHeatshrinkHeader) &&
+            header->magic == TAR_HEATSHRINK_MAGIC && header->version == TAR_HEATSHRINK_VERSION;
+        storage_file_seek(stream, 0, true);
+        archive->total_bytes = storage_file_size(stream);
+        archive->processed_bytes = 0;
+    }
+
+    archive->stream = stream;
     mtar_init(&archive->tar, mtar_access, &filesystem_ops, stream);
 
     return true;
@@ -113,7 +150,8 @@ static int tar_archive_entry_counter(mtar_t* tar, const mtar_header_t* header, v
 
 int32_t tar_archive_get_entries_count(TarArchive* archive) {
     int32_t counter = 0;
-    if(mtar_foreach(&archive->tar, tar_archive_entry_counter, &counter) != MTAR_ESUCCESS) {
+    if(archive->compressed ||
+       mtar_foreach(&archive->tar, tar_archive_entry_counter, &counter) != MTAR_ESUCCESS) {
         counter = -1;
     }
     return counter;
@@ -168,24 +206,29 @@ typedef struct {
     Storage_name_converter converter;
 } TarArchiveDirectoryOpParams;
 
+static bool tar_archive_file_open(File* file, const char* path, FS_AccessMode access_mode) {
+    FS_OpenMode open_mode = (access_mode == FSAM_WRITE) ? FSOM_CREATE_ALWAYS : FSOM_OPEN_EXISTING;
+    uint8_t n_tries = FILE_OPEN_NTRIES;
+    while(n_tries-- > 0) {
+        if(storage_file_open(file, path, access_mode, open_mode)) {
+            break;
+        }
+        FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", path, n_tries);
+        storage_file_close(file);
+        furi_delay_ms(FILE_OPEN_RETRY_DELAY);
+    }
+
+    return storage_file_is_open(file);
+}
+
 static bool archive_extract_current_file(TarArchive* archive, const char* dst_path) {
     mtar_t* tar = &archive->tar;
     File* out_file = storage_file_alloc(archive->storage);
     uint8_t* readbuf = malloc(FILE_BLOCK_SIZE);
 
     bool success = true;
-    uint8_t n_tries = FILE_OPEN_NTRIES;
     do {
-        while(n_tries-- > 0) {
-            if(storage_file_open(out_file, dst_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-                break;
-            }
-            FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", dst_path, n_tries);
-            storage_file_close(out_file);
-            furi_delay_ms(FILE_OPEN_RETRY_DELAY);
-        }
-
-        if(!storage_file_is_open(out_file)) {
+        if(!tar_archive_file_open(out_file, dst_path, FSAM_WRITE)) {
             success = false;
             break;
         }
@@ -204,41 +247,177 @@ static bool archive_extract_current_file(TarArchive* archive, const char* dst_pa
     return success;
 }
 
-static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header, void* param) {
-    UNUSED(tar);
-    TarArchiveDirectoryOpParams* op_params = param;
+/* Streaming unpacker: archive is read once, in big blocks, and file data is
+ * written straight from read buffer. Tar records are 512 bytes and buffer
+ * size is a multiple of it, so a record never crosses buffer boundary. */
+typedef struct {
+    TarArchive* archive;
+    uint8_t* buffer;
+    size_t size; // valid bytes in buffer
+    size_t offset; // consumed bytes
+
+    // heatshrink compressed archive
+    heatshrink_decoder* decoder;
+    uint8_t* decoder_buffer;
+    uint8_t* input;
+    size_t input_size;
+    size_t input_offset;
+    bool input_eof;
+} TarStream;
+
+typedef struct {
+    char name[101];
+    char type;
+    uint32_t size;
+} TarStreamEntry;
+
+static bool tar_stream_read_input(TarStream* stream, uint8_t* data, size_t size, size_t* read) {
+    File* file = stream->archive->stream;
+    *read = storage_file_read(file, data, size);
+    stream->archive->processed_bytes += *read;
+    return storage_file_get_error(file) == FSE_OK;
+}
+
+static bool tar_stream_fill(TarStream* stream) {
+    stream->size = 0;
+    stream->offset = 0;
+
+    if(!stream->decoder) {
+        return tar_stream_read_input(
+            stream, stream->buffer, TAR_STREAM_BUFFER_SIZE, &stream->size);
+    }
+
+    while(stream->size < TAR_STREAM_BUFFER_SIZE) {
+        size_t polled = 0;
+        HSD_poll_res poll_res = heatshrink_decoder_poll(
+            stream->decoder,
+            stream->buffer + stream->size,
+            TAR_STREAM_BUFFER_SIZE - stream->size,
+            &polled);
+        if(poll_res < 0) return false;
+        stream->size += polled;
+        if(poll_res == HSDR_POLL_MORE) continue;
+
+        // Decoder wants more input
+        if(stream->input_offset < stream->input_size) {
+            size_t sunk = 0;
+            if(heatshrink_decoder_sink(
+                   stream->decoder,
+                   stream->input + stream->input_offset,
+                   stream->input_size - stream->input_offset,
+                   &sunk) < 0) {
+                return false;
+            }
+            stream->input_offset += sunk;
+        } else if(!stream->input_eof) {
+            if(!tar_stream_read_input(
+                   stream, stream->input, TAR_HEATSHRINK_INPUT_SIZE, &stream->input_size)) {
+                return false;
+            }
+            stream->input_offset = 0;
+            stream->input_eof = (stream->input_size == 0);
+        } else if(heatshrink_decoder_finish(stream->decoder) == HSDR_FINISH_DONE) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/* Get buffered data, size is 0 at the end of archive */
+static bool tar_stream_peek(TarStream* stream, const uint8_t** data, size_t* size) {
+    if(stream->offset == stream->size) {
+        if(!tar_stream_fill(stream)) return false;
+    }
+    *data = stream->buffer + stream->offset;
+    *size = stream->size - stream->offset;
+    return true;
+}
+
+/* Pass entry data (with record padding) to file or skip it if file is NULL */
+static bool tar_stream_copy(TarStream* stream, uint32_t size, File* file) {
+    uint32_t left = (size + TAR_RECORD_SIZE - 1) / TAR_RECORD_SIZE * TAR_RECORD_SIZE;
+    while(left) {
+        const uint8_t* data;
+        size_t available;
+        if(!tar_stream_peek(stream, &data, &available) || !available) return false;
+
+        size_t chunk = MIN(available, left);
+        size_t data_chunk = MIN(chunk, size);
+        if(file && data_chunk) {
+            if(storage_file_write(file, data, data_chunk) != data_chunk) return false;
+        }
+        size -= data_chunk;
+        left -= chunk;
+        stream->offset += chunk;
+    }
+
+    return true;
+}
+
+static uint32_t tar_stream_parse_octal(const uint8_t* field, size_t size) {
+    uint32_t value = 0;
+    size_t i = 0;
+    while(i < size && field[i] == ' ') i++;
+    for(; i < size && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * 8 + (field[i] - '0');
+    }
+    return value;
+}
+
+static bool tar_stream_parse_header(const uint8_t* record, TarStreamEntry* entry) {
+    // Checksum is calculated with checksum field filled with spaces
+    uint32_t checksum = 8 * ' ';
+    for(size_t i = 0; i < TAR_RECORD_SIZE; i++) {
+        checksum += (i >= 148 && i < 156) ? 0 : record[i];
+    }
+    if(checksum != tar_stream_parse_octal(record + 148, 8)) {
+        return false;
+    }
+
+    memcpy(entry->name, record, 100);
+    entry->name[100] = '\0';
+    entry->size = tar_stream_parse_octal(record + 124, 12);
+    entry->type = record[156] ? (char)record[156] : MTAR_TREG;
+    return true;
+}
+
+static bool tar_stream_extract_entry(
+    TarStream* stream,
+    TarArchiveDirectoryOpParams* op_params,
+    TarStreamEntry* entry) {
     TarArchive* archive = op_params->archive;
 
     bool skip_entry = false;
     if(archive->unpack_cb) {
-        skip_entry = !archive->unpack_cb(
-            header->name, header->type == MTAR_TDIR, archive->unpack_cb_context);
+        skip_entry =
+            !archive->unpack_cb(entry->name, entry->type == MTAR_TDIR, archive->unpack_cb_context);
     }
 
     if(skip_entry) {
-        FURI_LOG_W(TAG, "filter: skipping entry \"%s\"", header->name);
-        return 0;
+        FURI_LOG_W(TAG, "filter: skipping entry \"%s\"", entry->name);
+        return tar_stream_copy(stream, entry->size, NULL);
     }
 
     FuriString* full_extracted_fname;
-    if(header->type == MTAR_TDIR) {
+    if(entry->type == MTAR_TDIR) {
         full_extracted_fname = furi_string_alloc();
-        path_concat(op_params->work_dir, header->name, full_extracted_fname);
+        path_concat(op_params->work_dir, entry->name, full_extracted_fname);
 
         bool create_res =
             storage_simply_mkdir(archive->storage, furi_string_get_cstr(full_extracted_fname));
         furi_string_free(full_extracted_fname);
-        return create_res ? 0 : -1;
+        return create_res && tar_stream_copy(stream, entry->size, NULL);
     }
 
-    if(header->type != MTAR_TREG) {
-        FURI_LOG_W(TAG, "not extracting unsupported type \"%s\"", header->name);
-        return 0;
+    if(entry->type != MTAR_TREG) {
+        FURI_LOG_W(TAG, "not extracting unsupported type \"%s\"", entry->name);
+        return tar_stream_copy(stream, entry->size, NULL);
     }
 
-    FURI_LOG_D(TAG, "Extracting %u bytes to '%s'", header->size, header->name);
+    FURI_LOG_D(TAG, "Extracting %lu bytes to '%s'", entry->size, entry->name);
 
-    FuriString* converted_fname = furi_string_alloc_set(header->name);
+    FuriString* converted_fname = furi_string_alloc_set(entry->name);
     if(op_params->converter) {
         op_params->converter(converted_fname);
     }
@@ -246,12 +425,50 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
     full_extracted_fname = furi_string_alloc();
     path_concat(op_params->work_dir, furi_string_get_cstr(converted_fname), full_extracted_fname);
 
+    File* out_file = storage_file_alloc(archive->storage);
     bool success =
-        archive_extract_current_file(archive, furi_string_get_cstr(full_extracted_fname));
+        tar_archive_file_open(out_file, furi_string_get_cstr(full_extracted_fname), FSAM_WRITE) &&
+        tar_stream_copy(stream, entry->size, out_file);
+    storage_file_free(out_file);
 
     furi_string_free(converted_fname);
     furi_string_free(full_extracted_fname);
-    return success ? 0 : -1;
+    return success;
+}
+
+static bool tar_stream_init(TarStream* stream, TarArchive* archive) {
+    stream->archive = archive;
+    stream->buffer = malloc(TAR_STREAM_BUFFER_SIZE);
+    archive->processed_bytes = 0;
+
+    if(!archive->compressed) {
+        return storage_file_seek(archive->stream, 0, true);
+    }
+
+    TarHeatshrinkHeader* header = &archive->compress_header;
+    if(header->window_sz2 > TAR_HEATSHRINK_WINDOW_SZ2_MAX) {
+        FURI_LOG_E(TAG, "Unsupported window size %u", header->window_sz2);
+        return false;
+    }
+    stream->decoder_buffer = malloc((1 << header->window_sz2) + TAR_HEATSHRINK_INPUT_SIZE);
+    stream->decoder = heatshrink_decoder_alloc(
+        stream->decoder_buffer,
+        TAR_HEATSHRINK_INPUT_SIZE,
+        header->window_sz2,
+        header->lookahead_sz2);
+    stream->input = malloc(TAR_HEATSHRINK_INPUT_SIZE);
+
+    return stream->decoder &&
+           storage_file_seek(archive->stream, sizeof(TarHeatshrinkHeader), true);
+}
+
+static void tar_stream_deinit(TarStream* stream) {
+    if(stream->decoder) {
+        heatshrink_decoder_free(stream->decoder);
+    }
+    free(stream->decoder_buffer);
+    free(stream->input);
+    free(stream->buffer);
 }
 
 bool tar_archive_unpack_to(
@@ -267,8 +484,41 @@ bool tar_archive_unpack_to(
 
     FURI_LOG_I(TAG, "Restoring '%s'", destination);
 
-    return (mtar_foreach(&archive->tar, archive_extract_foreach_cb, &param) == MTAR_ESUCCESS);
-};
+    TarStream stream = {0};
+    bool success = tar_stream_init(&stream, archive);
+    while(success) {
+        const uint8_t* record;
+        size_t available;
+        if(!tar_stream_peek(&stream, &record, &available)) {
+            success = false;
+            break;
+        }
+
+        // End of archive is marked by empty records, but they are optional
+        if(available == 0 || record[0] == '\0') break;
+
+        TarStreamEntry entry;
+        if(available < TAR_RECORD_SIZE || !tar_stream_parse_header(record, &entry)) {
+            FURI_LOG_E(TAG, "Bad header at %lu", archive->processed_bytes);
+            success = false;
+            break;
+        }
+        stream.offset += TAR_RECORD_SIZE;
+
+        success = tar_stream_extract_entry(&stream, &param, &entry);
+    }
+    tar_stream_deinit(&stream);
+
+    return success;
+}
+
+void tar_archive_get_read_progress(TarArchive* archive, uint32_t* processed, uint32_t* total) {
+    furi_assert(archive);
+    furi_assert(processed);
+    furi_assert(total);
+    *processed = archive->processed_bytes;
+    *total = archive->total_bytes;
+}
 
 bool tar_archive_add_file(
     TarArchive* archive,
@@ -279,18 +529,8 @@ bool tar_archive_add_file(
     uint8_t* file_buffer = malloc(FILE_BLOCK_SIZE);
     bool success = false;
     File* src_file = storage_file_alloc(archive->storage);
-    uint8_t n_tries = FILE_OPEN_NTRIES;
     do {
-        while(n_tries-- > 0) {
-            if(storage_file_open(src_file, fs_file_path, FSAM_READ, FSOM_OPEN_EXISTING)) {
-                break;
-            }
-            FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", fs_file_path, n_tries);
-            storage_file_close(src_file);
-            furi_delay_ms(FILE_OPEN_RETRY_DELAY);
-        }
-
-        if(!storage_file_is_open(src_file) ||
+        if(!tar_archive_file_open(src_file, fs_file_path, FSAM_READ) ||
            !tar_archive_file_add_header(archive, archive_fname, file_size)) {
             break;
         }
@@ -378,7 +618,7 @@ bool tar_archive_unpack_file(
     furi_assert(archive);
     furi_assert(archive_fname);
     furi_assert(destination);
-    if(mtar_find(&archive->tar, archive_fname) != MTAR_ESUCCESS) {
+    if(archive->compressed || mtar_find(&archive->tar, archive_fname) != MTAR_ESUCCESS) {
         return false;
     }
     return archive_extract_current_file(archive, destination);
@@ -20,6 +20,9 @@ typedef enum {
 
 TarArchive* tar_archive_alloc(Storage* storage);
 
+/* Archive opened for reading can be compressed with heatshrink: 8 byte header
+ * {"HSDS", version 1, window bits, lookahead bits, reserved} is followed by
+ * compressed tar stream. Such archive can be unpacked only with tar_archive_unpack_to */
 bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode);
 
 void tar_archive_free(TarArchive* archive);
@@ -40,6 +43,9 @@ bool tar_archive_add_dir(TarArchive* archive, const char* fs_full_path, const ch
 
 int32_t tar_archive_get_entries_count(TarArchive* archive);
 
+/* Archive bytes read by tar_archive_unpack_to so far and archive size */
+void tar_archive_get_read_progress(TarArchive* archive, uint32_t* processed, uint32_t* total);
+
 bool tar_archive_unpack_file(
     TarArchive* archive,
     const char* archive_fname,
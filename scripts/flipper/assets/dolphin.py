@@ -3,6 +3,7 @@ import logging
 import os
 import sys
 import shutil
+import struct
 from collections import Counter
 
 from flipper.utils.fff import *
@@ -26,6 +27,10 @@ class DolphinBubbleAnimation:
     FILE_TYPE = "Flipper Animation"
     FILE_VERSION = 1
 
+    BUNDLE_FILENAME = "frames.bin"
+    BUNDLE_MAGIC = 0x4C444E42
+    BUNDLE_VERSION = 1
+
     def __init__(
         self,
         name: str,
@@ -234,6 +239,37 @@ class DolphinBubbleAnimation:
             for image in to_pack:
                 _convert_image_to_bm(image)
 
+        self._save_bundle(animation_directory, [filename for _, filename in to_pack])
+
+    def _save_bundle(self, animation_directory: str, frame_filenames: list):
+        # Same frames packed in one file with offset table, so firmware
+        # can stream them without opening file per frame
+        frames = []
+        for frame_filename in frame_filenames:
+            with open(frame_filename, "rb") as file:
+                frames.append(file.read())
+
+        header = struct.pack(
+            "<IBBBB",
+            self.BUNDLE_MAGIC,
+            self.BUNDLE_VERSION,
+            self.meta["Width"],
+            self.meta["Height"],
+            len(frames),
+        )
+        offset = len(header) + struct.calcsize("<IH") * len(frames)
+        table = b""
+        for frame in frames:
+            table += struct.pack("<IH", offset, len(frame))
+            offset += len(frame)
+
+        bundle_filename = os.path.join(animation_directory, self.BUNDLE_FILENAME)
+        with open(bundle_filename, "wb") as file:
+            file.write(header)
+            file.write(table)
+            for frame in frames:
+                file.write(frame)
+
     def process(self):
         if ImageTools.is_processing_slow():
             pool = multiprocessing.Pool()
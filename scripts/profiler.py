@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+
+from flipper.app import App
+from collections import defaultdict
+import subprocess
+
+
+class Symbolizer:
+    def __init__(self, elf, section=None, base=0):
+        self.elf = elf
+        self.section = section
+        self.base = base
+        self.size = self._get_section_size() if section else None
+
+    def _get_section_size(self):
+        sizes = subprocess.check_output(["arm-none-eabi-size", "-A", self.elf])
+        for line in sizes.decode("utf-8").splitlines():
+            parts = line.split()
+            if len(parts) == 3 and parts[0] == self.section:
+                return int(parts[1])
+        raise ValueError(f"No {self.section} section in {self.elf}")
+
+    def owns(self, address):
+        if self.size is None:
+            return True
+        return self.base <= address < self.base + self.size
+
+    def resolve(self, addresses):
+        if not addresses:
+            return {}
+        command = ["arm-none-eabi-addr2line", "-f", "-e", self.elf]
+        if self.section:
+            command += ["-j", self.section]
+        command += [f"0x{address - self.base:x}" for address in addresses]
+        output = subprocess.check_output(command).decode("utf-8").splitlines()
+        # Two lines per address: function and location
+        return {
+            address: (output[2 * i], output[2 * i + 1])
+            for i, address in enumerate(addresses)
+        }
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument(
+            "-e", "--elf", required=True, help="Firmware ELF with debug info"
+        )
+        self.parser.add_argument(
+            "-f",
+            "--fap",
+            nargs=2,
+            action="append",
+            default=[],
+            metavar=("ELF", "TEXT_ADDRESS"),
+            help="Application debug ELF and its .text address from load log",
+        )
+        self.parser.add_argument(
+            "-n", "--count", type=int, default=20, help="Functions to show"
+        )
+        self.parser.add_argument(
+            "-t", "--threads", action="store_true", help="Show functions per thread"
+        )
+        self.parser.add_argument("dump", help="Saved `profiler dump` CLI output")
+        self.parser.set_defaults(func=self.report)
+
+    def _load_dump(self):
+        samples = []
+        with open(self.args.dump, "r") as f:
+            for line in f:
+                line = line.strip()
+                if not line.startswith("0x"):
+                    continue
+                address, count, thread = line.split(" ", 2)
+                samples.append((int(address, 16), int(count), thread))
+        return samples
+
+    def _symbolize(self, addresses):
+        symbolizers = [
+            Symbolizer(elf, ".text", int(address, 0)) for elf, address in self.args.fap
+        ]
+        symbolizers.append(Symbolizer(self.args.elf))
+
+        pending = defaultdict(list)
+        for address in addresses:
+            if address == 0:
+                continue
+            symbolizer = next(s for s in symbolizers if s.owns(address))
+            pending[symbolizer].append(address)
+
+        symbols = {0: ("[interrupts]", "")}
+        for symbolizer, symbolizer_addresses in pending.items():
+            symbols.update(symbolizer.resolve(symbolizer_addresses))
+        return symbols
+
+    def _print_top(self, title, functions, total):
+        print(f"{title}:")
+        top = sorted(functions.items(), key=lambda item: item[1], reverse=True)
+        for (function, location), count in top[: self.args.count]:
+            print(f"{count:>8} {count * 100 / total:6.2f}%  {function:<40} {location}")
+        print()
+
+    def report(self):
+        samples = self._load_dump()
+        if not samples:
+            self.logger.error("No samples in dump")
+            return 1
+
+        symbols = self._symbolize(set(address for address, _, _ in samples))
+        total = sum(count for _, count, _ in samples)
+
+        threads = defaultdict(int)
+        functions = defaultdict(int)
+        thread_functions = defaultdict(lambda: defaultdict(int))
+        for address, count, thread in samples:
+            threads[thread] += count
+            functions[symbols[address]] += count
+            thread_functions[thread][symbols[address]] += count
+
+        print(f"Total samples: {total}\n")
+        print("Threads:")
+        for thread, count in sorted(threads.items(), key=lambda t: t[1], reverse=True):
+            print(f"{count:>8} {count * 100 / total:6.2f}%  {thread}")
+        print()
+
+        self._print_top("Functions", functions, total)
+        if self.args.threads:
+            for thread, thread_total in threads.items():
+                self._print_top(thread, thread_functions[thread], thread_total)
+
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()